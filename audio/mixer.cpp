@@ -21,6 +21,8 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/memtrack.h"
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -281,6 +283,11 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+	MEMORY_TAG_SCOPE("audio/mixer");
+	PROFILE_ZONE("Mixer::mixCallback");
+	if (Common::isProfiling())
+		Common::setProfilingThreadName("audio");
+
 	Common::StackLock lock(_mutex);
 
 	int16 *buf = (int16 *)samples;
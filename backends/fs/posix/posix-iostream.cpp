@@ -24,6 +24,9 @@
 #include "backends/fs/posix/posix-iostream.h"
 
 #include <sys/stat.h>
+#ifdef USE_POSIX_FADVISE
+#include <fcntl.h>
+#endif
 
 PosixIoStream *PosixIoStream::makeFromPath(const Common::String &path, bool writeMode) {
 #if defined(HAS_FSEEKO64)
@@ -58,3 +61,11 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+void PosixIoStream::readAhead(int64 offset, uint32 size) {
+#ifdef USE_POSIX_FADVISE
+	int fd = fileno((FILE *)_handle);
+	if (fd != -1)
+		posix_fadvise(fd, offset, size, POSIX_FADV_WILLNEED);
+#endif
+}
@@ -33,6 +33,7 @@ public:
 	PosixIoStream(void *handle);
 
 	int64 size() const override;
+	void readAhead(int64 offset, uint32 size) override;
 };
 
 #endif
@@ -23,10 +23,23 @@
 #define BACKENDS_GRAPHICS_NULL_H
 
 #include "backends/graphics/graphics.h"
+#include "common/config-manager.h"
+#include "graphics/surface.h"
 
+/**
+ * A graphics manager which never displays anything. Unless the display is
+ * disabled, it still keeps the game screen in memory so that screenshots
+ * can be taken, e.g. by the event recorder to verify a playback.
+ */
 class NullGraphicsManager : public GraphicsManager {
 public:
-	virtual ~NullGraphicsManager() {}
+	NullGraphicsManager() : _width(0), _height(0), _overlayVisible(false) {
+		memset(_palette, 0, sizeof(_palette));
+	}
+
+	virtual ~NullGraphicsManager() {
+		_screen.free();
+	}
 
 	bool hasFeature(OSystem::Feature f) const override { return false; }
 	void setFeatureState(OSystem::Feature f, bool enable) override {}
@@ -53,6 +66,10 @@ public:
 		_width = width;
 		_height = height;
 		_format = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+
+		_screen.free();
+		if (!ConfMan.getBool("disable_display"))
+			_screen.create(width, height, _format);
 	}
 
 	int getScreenChangeID() const override { return 0; }
@@ -62,12 +79,22 @@ public:
 
 	int16 getHeight() const override { return _height; }
 	int16 getWidth() const override { return _width; }
-	void setPalette(const byte *colors, uint start, uint num) override {}
-	void grabPalette(byte *colors, uint start, uint num) const override {}
-	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {}
-	Graphics::Surface *lockScreen() override { return NULL; }
+	void setPalette(const byte *colors, uint start, uint num) override {
+		memcpy(_palette + start * 3, colors, num * 3);
+	}
+	void grabPalette(byte *colors, uint start, uint num) const override {
+		memcpy(colors, _palette + start * 3, num * 3);
+	}
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {
+		if (_screen.getPixels())
+			_screen.copyRectToSurface(buf, pitch, x, y, w, h);
+	}
+	Graphics::Surface *lockScreen() override { return _screen.getPixels() ? &_screen : NULL; }
 	void unlockScreen() override {}
-	void fillScreen(uint32 col) override {}
+	void fillScreen(uint32 col) override {
+		if (_screen.getPixels())
+			_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+	}
 	void updateScreen() override {}
 	void setShakePos(int shakeXOffset, int shakeYOffset) override {}
 	void setFocusRectangle(const Common::Rect& rect) override {}
@@ -92,6 +119,8 @@ private:
 	uint _width, _height;
 	Graphics::PixelFormat _format;
 	bool _overlayVisible;
+	Graphics::Surface _screen;
+	byte _palette[256 * 3];
 };
 
 #endif
@@ -30,6 +30,7 @@
 #include "graphics/opengl/debug.h"
 
 #include "common/array.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
@@ -87,6 +88,7 @@ OpenGLGraphicsManager::OpenGLGraphicsManager()
 #ifdef USE_SCALERS
 	  , _scalerPlugins(ScalerMan.getPlugins())
 #endif
+	  , _frameTimingsSurface(nullptr)
 	{
 	memset(_gamePalette, 0, sizeof(_gamePalette));
 	OpenGLContext.reset();
@@ -101,6 +103,7 @@ OpenGLGraphicsManager::~OpenGLGraphicsManager() {
 	delete _osdMessageSurface;
 	delete _osdIconSurface;
 #endif
+	delete _frameTimingsSurface;
 #if !USE_FORCED_GLES
 	ShaderManager::destroy();
 #endif
@@ -584,7 +587,9 @@ int16 OpenGLGraphicsManager::getHeight() const {
 }
 
 void OpenGLGraphicsManager::copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseCopyRect);
 	_gameScreen->copyRectToTexture(x, y, w, h, buf, pitch);
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseCopyRect);
 }
 
 void OpenGLGraphicsManager::fillScreen(uint32 col) {
@@ -658,11 +663,15 @@ void OpenGLGraphicsManager::updateScreen() {
 #ifdef USE_OSD
 	    && !_osdMessageSurface && !_osdIconSurface
 #endif
+	    && !_frameTimingsVisible && !_frameTimingsSurface
 	    ) {
+		_frameTimings.endFrame();
 		return;
 	}
 
-	// Update changes to textures.
+	// Update changes to textures. This includes the conversion of the game
+	// screen and cursor, if needed.
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseUpload);
 	_gameScreen->updateGLTexture();
 	if (_cursorVisible && _cursor) {
 		_cursor->updateGLTexture();
@@ -671,6 +680,13 @@ void OpenGLGraphicsManager::updateScreen() {
 		_cursorMask->updateGLTexture();
 	}
 	_overlay->updateGLTexture();
+	updateFrameTimingsSurface();
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseUpload);
+
+	debug(9, "OpenGL: Uploaded %u bytes of texture data", GLTexture::getUploadedBytes());
+	GLTexture::resetUploadedBytes();
+
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhasePresent);
 
 #if !USE_FORCED_GLES
 	if (_libretroPipeline) {
@@ -786,9 +802,40 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 #endif
 
+	if (_frameTimingsSurface) {
+		_backBuffer.enableBlend(Framebuffer::kBlendModeTraditionalTransparency);
+		_pipeline->drawTexture(_frameTimingsSurface->getGLTexture(),
+		                       0, _windowHeight - _frameTimingsSurface->getHeight(),
+		                       _frameTimingsSurface->getWidth(), _frameTimingsSurface->getHeight());
+	}
+
 	_cursorNeedsRedraw = false;
 	_forceRedraw = false;
 	refreshScreen();
+
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhasePresent);
+	_frameTimings.endFrame();
+}
+
+void OpenGLGraphicsManager::updateFrameTimingsSurface() {
+	if (!_frameTimingsVisible) {
+		delete _frameTimingsSurface;
+		_frameTimingsSurface = nullptr;
+		return;
+	}
+
+	if (!_frameTimingsSurface) {
+		_frameTimingsSurface = createSurface(_defaultFormatAlpha);
+		assert(_frameTimingsSurface);
+		_frameTimingsSurface->allocate(Graphics::FrameTimings::kHistorySize, kFrameTimingsHeight);
+	}
+
+	// Keep the cost of the graph itself out of the upload phase.
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseGraph);
+	_frameTimings.drawGraph(*_frameTimingsSurface->getSurface());
+	_frameTimingsSurface->flagDirty();
+	_frameTimingsSurface->updateGLTexture();
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseGraph);
 }
 
 Graphics::Surface *OpenGLGraphicsManager::lockScreen() {
@@ -1406,6 +1453,10 @@ void OpenGLGraphicsManager::notifyContextCreate(ContextType type,
 		_osdIconSurface->recreate();
 	}
 #endif
+
+	if (_frameTimingsSurface) {
+		_frameTimingsSurface->recreate();
+	}
 }
 
 void OpenGLGraphicsManager::notifyContextDestroy() {
@@ -1435,6 +1486,10 @@ void OpenGLGraphicsManager::notifyContextDestroy() {
 	}
 #endif
 
+	if (_frameTimingsSurface) {
+		_frameTimingsSurface->destroy();
+	}
+
 #if !USE_FORCED_GLES
 	if (OpenGLContext.shadersSupported) {
 		ShaderMan.notifyDestroy();
@@ -511,6 +511,25 @@ private:
 		kOSDIconRightMargin = 10
 	};
 #endif
+
+	//
+	// Frame timings
+	//
+
+	/**
+	 * Update the frame timing graph, creating or deleting its surface
+	 * as needed.
+	 */
+	void updateFrameTimingsSurface();
+
+	/**
+	 * The frame timing graph, drawn in the lower left corner.
+	 */
+	Surface *_frameTimingsSurface;
+
+	enum {
+		kFrameTimingsHeight = 96
+	};
 };
 
 } // End of namespace OpenGL
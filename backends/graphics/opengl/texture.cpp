@@ -195,17 +195,17 @@ bool GLTexture::setSize(uint width, uint height) {
 	return true;
 }
 
+uint32 GLTexture::_uploadedBytes = 0;
+
 void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &src) {
 	// Set the texture on the active texture unit.
 	bind();
 
 	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
+	// When GL_UNPACK_ROW_LENGTH is available we can specify the pitch of the
+	// source data and only upload the rect changed. OpenGL ES 1.0 and plain
+	// OpenGL ES 2.0 do not support it though. In that case we are left with
+	// the following options:
 	//
 	// 1) (As we do right now) Simply always update the whole texture lines of
 	//    rect changed. This is simplest to implement. In case performance is
@@ -217,8 +217,19 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	//
 	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
 	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	if (OpenGLContext.unpackSubImageSupported) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / src.format.bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                       _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+
+		_uploadedBytes += area.width() * area.height() * src.format.bytesPerPixel;
+	} else {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
+		                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+		_uploadedBytes += src.w * area.height() * src.format.bytesPerPixel;
+	}
 }
 
 //
@@ -226,7 +237,7 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyRects() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -234,15 +245,7 @@ void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcP
 	assert(x + w <= (uint)dstSurf->w);
 	assert(y + h <= (uint)dstSurf->h);
 
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = Common::Rect(x, y, x + w, y + h);
-	} else {
-		_dirtyArea.extend(Common::Rect(x, y, x + w, y + h));
-	}
+	addDirtyArea(Common::Rect(x, y, x + w, y + h));
 
 	const byte *src = (const byte *)srcPtr;
 	byte *dst = (byte *)dstSurf->getBasePtr(x, y);
@@ -267,11 +270,79 @@ void Surface::fill(uint32 color) {
 	flagDirty();
 }
 
+static uint32 rectArea(const Common::Rect &r) {
+	return (uint32)r.width() * r.height();
+}
+
+void Surface::addDirtyArea(const Common::Rect &area) {
+	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
+	// parameters is an empty rect. Thus, we never store empty rects.
+	if (_allDirty || area.isEmpty()) {
+		return;
+	}
+
+	// Merge all areas which overlap the new one or which are close enough
+	// that updating their union is cheaper than updating them separately.
+	// Since merging grows the new area we start over after every merge.
+	Common::Rect newArea = area;
+	for (uint i = 0; i < _dirtyRects.size();) {
+		const Common::Rect &oldArea = _dirtyRects[i];
+		Common::Rect merged = newArea;
+		merged.extend(oldArea);
+
+		if (newArea.intersects(oldArea) ||
+		    rectArea(merged) <= rectArea(newArea) + rectArea(oldArea) + kDirtyMergeSlack) {
+			newArea = merged;
+			_dirtyRects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyRects.size() < kMaxDirtyRects) {
+		_dirtyRects.push_back(newArea);
+		return;
+	}
+
+	// Too many separate areas. Add the new one to the area which grows the
+	// least by this.
+	uint best = 0;
+	uint32 bestGrowth = 0xFFFFFFFF;
+	for (uint i = 0; i < _dirtyRects.size(); ++i) {
+		Common::Rect merged = _dirtyRects[i];
+		merged.extend(newArea);
+
+		const uint32 growth = rectArea(merged) - rectArea(_dirtyRects[i]);
+		if (growth < bestGrowth) {
+			best = i;
+			bestGrowth = growth;
+		}
+	}
+	_dirtyRects[best].extend(newArea);
+}
+
 Common::Rect Surface::getDirtyArea() const {
 	if (_allDirty) {
 		return Common::Rect(getWidth(), getHeight());
+	}
+
+	Common::Rect dirtyArea;
+	for (uint i = 0; i < _dirtyRects.size(); ++i) {
+		if (dirtyArea.isEmpty()) {
+			dirtyArea = _dirtyRects[i];
+		} else {
+			dirtyArea.extend(_dirtyRects[i]);
+		}
+	}
+	return dirtyArea;
+}
+
+Common::Array<Common::Rect> Surface::getDirtyRects() const {
+	if (_allDirty) {
+		return Common::Array<Common::Rect>(1, Common::Rect(getWidth(), getHeight()));
 	} else {
-		return _dirtyArea;
+		return _dirtyRects;
 	}
 }
 
@@ -332,9 +403,14 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		Common::Rect dirtyArea = dirtyRects[i];
+		updateGLTexture(dirtyArea);
+	}
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
 void Texture::updateGLTexture(Common::Rect &dirtyArea) {
@@ -368,9 +444,6 @@ void Texture::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
 }
 
 FakeTexture::FakeTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -378,11 +451,15 @@ FakeTexture::FakeTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType, con
 	  _fakeFormat(fakeFormat),
 	  _rgbData(),
 	  _palette(nullptr),
-	  _mask(nullptr) {
+	  _mask(nullptr),
+	  _paletteGeneration(0),
+	  _convertedPaletteGeneration(0),
+	  _numChangedColors(0) {
 	if (_fakeFormat.isCLUT8()) {
 		_palette = new uint32[256];
-		memset(_palette, 0, sizeof(uint32));
+		memset(_palette, 0, 256 * sizeof(uint32));
 	}
+	memset(_changedColors, 0, sizeof(_changedColors));
 }
 
 FakeTexture::~FakeTexture() {
@@ -428,24 +505,68 @@ void FakeTexture::setColorKey(uint colorKey) {
 	// to avoid color fringes due to filtering.
 	// Erasing the color data is not a problem as the palette is always fully re-initialized
 	// before setting the key color.
-	uint32 *palette = _palette + colorKey;
-	*palette = 0;
-
-	// A palette changes means we need to refresh the whole surface.
-	flagDirty();
+	updatePaletteEntry(colorKey, 0);
 }
 
 void FakeTexture::setPalette(uint start, uint colors, const byte *palData) {
 	if (!_palette)
 		return;
 
-	Graphics::convertPaletteToMap(_palette + start, palData, colors, _format);
+	// Games with palette animations set the palette every frame, often
+	// with only a few entries changing or none at all. Only keep track of
+	// the changes here and convert the affected pixels on the next update.
+	uint32 map[256];
+	Graphics::convertPaletteToMap(map, palData, colors, _format);
 
-	// A palette changes means we need to refresh the whole surface.
-	flagDirty();
+	for (uint i = 0; i < colors; ++i)
+		updatePaletteEntry(start + i, map[i]);
+}
+
+void FakeTexture::updatePaletteEntry(uint index, uint32 color) {
+	if (_palette[index] == color)
+		return;
+
+	_palette[index] = color;
+	if (!_changedColors[index]) {
+		_changedColors[index] = true;
+		++_numChangedColors;
+	}
+	++_paletteGeneration;
+}
+
+void FakeTexture::flagPaletteChanges() {
+	if (_paletteGeneration == _convertedPaletteGeneration)
+		return;
+
+	if (_numChangedColors == 256) {
+		flagDirty();
+	} else {
+		// Only the pixels using a changed color need to be converted again.
+		// Add the span of them in each row, neighboring spans are merged.
+		for (int y = 0; y < _rgbData.h; ++y) {
+			const byte *row = (const byte *)_rgbData.getBasePtr(0, y);
+
+			int left = 0;
+			while (left < _rgbData.w && !_changedColors[row[left]])
+				++left;
+			if (left == _rgbData.w)
+				continue;
+
+			int right = _rgbData.w;
+			while (!_changedColors[row[right - 1]])
+				--right;
+
+			addDirtyArea(Common::Rect(left, y, right, y + 1));
+		}
+	}
+
+	memset(_changedColors, 0, sizeof(_changedColors));
+	_numChangedColors = 0;
+	_convertedPaletteGeneration = _paletteGeneration;
 }
 
 void FakeTexture::updateGLTexture() {
+	flagPaletteChanges();
 	if (!isDirty()) {
 		return;
 	}
@@ -453,12 +574,15 @@ void FakeTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyRects[i];
 
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
 	Texture::updateGLTexture();
@@ -510,25 +634,28 @@ void TextureRGB555::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyRects[i];
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
-	const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
+		const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint16 color = *src++;
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
-		}
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
 
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -552,23 +679,26 @@ void TextureRGBA8888Swap::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &dirtyArea = dirtyRects[i];
 
-	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
+		uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
 
-	const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
+		const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint32 color = *src++;
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint32 color = *src++;
 
-			*dst++ = SWAP_BYTES_32(color);
-		}
+				*dst++ = SWAP_BYTES_32(color);
+			}
 
-		src = (const uint32 *)((const byte *)src + srcAdd);
-		dst = (uint32 *)((byte *)dst + dstAdd);
+			src = (const uint32 *)((const byte *)src + srcAdd);
+			dst = (uint32 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -612,6 +742,7 @@ void ScaledTexture::allocate(uint width, uint height) {
 }
 
 void ScaledTexture::updateGLTexture() {
+	flagPaletteChanges();
 	if (!isDirty()) {
 		return;
 	}
@@ -619,46 +750,51 @@ void ScaledTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		Common::Rect dirtyArea = dirtyRects[i];
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		uint srcPitch = _rgbData.pitch;
+		byte *dst;
+		uint dstPitch;
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+		if (_convData) {
+			dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			dstPitch = _convData->pitch;
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+			applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+			src = dst;
+			srcPitch = dstPitch;
+		}
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+		dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		dstPitch = outSurf->pitch;
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
 
-	// Do generic handling of updating the texture.
-	Texture::updateGLTexture(dirtyArea);
+		// Do generic handling of updating the texture.
+		Texture::updateGLTexture(dirtyArea);
+	}
+
+	clearDirty();
 }
 
 void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
@@ -787,26 +923,30 @@ void TextureCLUT8GPU::setColorKey(uint colorKey) {
 	// to avoid color fringes due to filtering.
 	// Erasing the color data is not a problem as the palette is always fully re-initialized
 	// before setting the key color.
-	_palette[colorKey * 4    ] = 0x00;
-	_palette[colorKey * 4 + 1] = 0x00;
-	_palette[colorKey * 4 + 2] = 0x00;
-	_palette[colorKey * 4 + 3] = 0x00;
+	static const byte transparent[4] = { 0x00, 0x00, 0x00, 0x00 };
+	byte *dst = _palette + colorKey * 4;
 
-	_paletteDirty = true;
+	if (memcmp(dst, transparent, 4) != 0) {
+		memcpy(dst, transparent, 4);
+		_paletteDirty = true;
+	}
 }
 
 void TextureCLUT8GPU::setPalette(uint start, uint colors, const byte *palData) {
 	byte *dst = _palette + start * 4;
 
+	// Setting the same palette again, which some games do every frame,
+	// does not require a new look up.
 	while (colors-- > 0) {
-		memcpy(dst, palData, 3);
-		dst[3] = 0xFF;
+		if (dst[0] != palData[0] || dst[1] != palData[1] || dst[2] != palData[2] || dst[3] != 0xFF) {
+			memcpy(dst, palData, 3);
+			dst[3] = 0xFF;
+			_paletteDirty = true;
+		}
 
 		dst += 4;
 		palData += 3;
 	}
-
-	_paletteDirty = true;
 }
 
 const GLTexture &TextureCLUT8GPU::getGLTexture() const {
@@ -818,7 +958,10 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+		for (uint i = 0; i < dirtyRects.size(); ++i) {
+			_clut8Texture.updateArea(dirtyRects[i], _clut8Data);
+		}
 		clearDirty();
 	}
 
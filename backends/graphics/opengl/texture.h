@@ -28,6 +28,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 class Scaler;
@@ -114,6 +115,17 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Query the number of bytes uploaded by updateArea, for all textures,
+	 * since the last call to resetUploadedBytes.
+	 */
+	static uint32 getUploadedBytes() { return _uploadedBytes; }
+
+	/**
+	 * Reset the count of uploaded bytes.
+	 */
+	static void resetUploadedBytes() { _uploadedBytes = 0; }
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -158,6 +170,8 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	static uint32 _uploadedBytes;
 };
 
 /**
@@ -223,7 +237,7 @@ public:
 	void fill(uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyRects.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -263,12 +277,40 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyRects.clear(); }
 
+	/**
+	 * Mark an area of the surface as changed.
+	 *
+	 * Areas close to each other are merged, and the number of separate
+	 * areas is bounded, so that far apart changes (like the cursor and a
+	 * status bar) do not force an update of everything in between.
+	 */
+	void addDirtyArea(const Common::Rect &area);
+
+	/**
+	 * @return The bounding rect of all changed areas.
+	 */
 	Common::Rect getDirtyArea() const;
+
+	/**
+	 * @return The changed areas of the surface.
+	 */
+	Common::Array<Common::Rect> getDirtyRects() const;
 private:
+	enum {
+		/** Maximum number of separately tracked dirty areas. */
+		kMaxDirtyRects = 8,
+
+		/**
+		 * Number of pixels merging two areas may add before it is worth
+		 * keeping them apart, which costs an extra conversion and upload.
+		 */
+		kDirtyMergeSlack = 64 * 64
+	};
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Common::Array<Common::Rect> _dirtyRects;
 };
 
 /**
@@ -312,6 +354,10 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
+	/**
+	 * Upload the given area of the texture data. This does not clear the
+	 * dirty state of the texture.
+	 */
 	void updateGLTexture(Common::Rect &dirtyArea);
 
 private:
@@ -336,6 +382,8 @@ public:
 	void setColorKey(uint colorKey) override;
 	void setPalette(uint start, uint colors, const byte *palData) override;
 
+	bool isDirty() const override { return _paletteGeneration != _convertedPaletteGeneration || Texture::isDirty(); }
+
 	Graphics::Surface *getSurface() override { return &_rgbData; }
 	const Graphics::Surface *getSurface() const override { return &_rgbData; }
 
@@ -343,10 +391,27 @@ public:
 protected:
 	void applyPaletteAndMask(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint srcWidth, const Common::Rect &dirtyArea, const Graphics::PixelFormat &dstFormat, const Graphics::PixelFormat &srcFormat) const;
 
+	/**
+	 * Mark the areas which use palette entries changed since the last
+	 * update as dirty.
+	 */
+	void flagPaletteChanges();
+
 	Graphics::Surface _rgbData;
 	Graphics::PixelFormat _fakeFormat;
 	uint32 *_palette;
 	uint8 *_mask;
+
+private:
+	void updatePaletteEntry(uint index, uint32 color);
+
+	/** Incremented whenever an entry of _palette actually changes. */
+	uint _paletteGeneration;
+	/** The palette generation the texture data was converted with. */
+	uint _convertedPaletteGeneration;
+	/** The palette entries changed since _convertedPaletteGeneration. */
+	bool _changedColors[256];
+	uint _numChangedColors;
 };
 
 class TextureRGB555 : public FakeTexture {
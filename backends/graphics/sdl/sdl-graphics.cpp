@@ -26,6 +26,7 @@
 #include "backends/keymapper/action.h"
 #include "backends/keymapper/keymap.h"
 #include "common/config-manager.h"
+#include "common/file.h"
 #include "common/fs.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -42,6 +43,10 @@ SdlGraphicsManager::SdlGraphicsManager(SdlEventSource *source, SdlWindow *window
 {
 	ConfMan.registerDefault("fullscreen_res", "desktop");
 
+	// Allow recording frame timings without the graph, which forces full
+	// redraws in some graphics managers.
+	_frameTimings.setEnabled(ConfMan.getBool("frame_timings"));
+
 	SDL_GetMouseState(&_cursorX, &_cursorY);
 }
 
@@ -391,6 +396,14 @@ bool SdlGraphicsManager::notifyEvent(const Common::Event &event) {
 		saveScreenshot();
 		return true;
 
+	case kActionToggleFrameTimings:
+		toggleFrameTimings();
+		return true;
+
+	case kActionSaveFrameTimings:
+		saveFrameTimings();
+		return true;
+
 	default:
 		return false;
 	}
@@ -419,6 +432,49 @@ void SdlGraphicsManager::toggleFullScreen() {
 #endif
 }
 
+void SdlGraphicsManager::toggleFrameTimings() {
+	_frameTimingsVisible = !_frameTimingsVisible;
+	_frameTimings.setEnabled(_frameTimingsVisible || ConfMan.getBool("frame_timings"));
+	_forceRedraw = true;
+}
+
+void SdlGraphicsManager::saveFrameTimings() {
+	if (!_frameTimings.size()) {
+#ifdef USE_OSD
+		displayMessageOnOSD(_("No frame timings recorded"));
+#endif
+		return;
+	}
+
+	Common::String path;
+	OSystem_SDL *sdl_g_system = dynamic_cast<OSystem_SDL*>(g_system);
+	if (sdl_g_system)
+		path = sdl_g_system->getScreenshotsPath();
+
+	Common::String filename;
+	for (int n = 0;; n++) {
+		filename = Common::String::format("scummvm-frametimings-%05d.csv", n);
+
+		Common::FSNode file = Common::FSNode(path + filename);
+		if (!file.exists()) {
+			break;
+		}
+	}
+
+	Common::DumpFile out;
+	if (out.open(path + filename) && _frameTimings.writeCSV(out)) {
+		debug("Saved frame timings to '%s'", (path + filename).c_str());
+#ifdef USE_OSD
+		displayMessageOnOSD(Common::U32String::format(_("Saved frame timings '%s'"), filename.c_str()));
+#endif
+	} else {
+		warning("Could not save frame timings to '%s'", (path + filename).c_str());
+#ifdef USE_OSD
+		displayMessageOnOSD(_("Could not save frame timings"));
+#endif
+	}
+}
+
 Common::Keymap *SdlGraphicsManager::getKeymap() {
 	using namespace Common;
 
@@ -486,5 +542,15 @@ Common::Keymap *SdlGraphicsManager::getKeymap() {
 	act->setCustomBackendActionEvent(kActionPreviousScaleFilter);
 	keymap->addAction(act);
 
+	act = new Action("TIMG", _("Toggle frame timing graph"));
+	act->addDefaultInputMapping("C+A+t");
+	act->setCustomBackendActionEvent(kActionToggleFrameTimings);
+	keymap->addAction(act);
+
+	act = new Action("TIMS", _("Save frame timings"));
+	act->addDefaultInputMapping("C+A+S+t");
+	act->setCustomBackendActionEvent(kActionSaveFrameTimings);
+	keymap->addAction(act);
+
 	return keymap;
 }
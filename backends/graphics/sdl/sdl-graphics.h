@@ -146,7 +146,9 @@ protected:
 		kActionIncreaseScaleFactor,
 		kActionDecreaseScaleFactor,
 		kActionNextScaleFilter,
-		kActionPreviousScaleFilter
+		kActionPreviousScaleFilter,
+		kActionToggleFrameTimings,
+		kActionSaveFrameTimings
 	};
 
 	/** Obtain the user configured fullscreen resolution, or default to the desktop resolution */
@@ -205,6 +207,12 @@ protected:
 
 private:
 	void toggleFullScreen();
+
+	/** Show or hide the frame timing graph, recording timings while it is shown. */
+	void toggleFrameTimings();
+
+	/** Write the recorded frame timings as CSV next to the screenshots. */
+	void saveFrameTimings();
 };
 
 #endif
@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/scaler-threads.h"
+
+#include "common/debug.h"
+#include "common/textconsole.h"
+
+SdlScalerThreadPool::SdlScalerThreadPool() : _done(nullptr), _quit(false) {
+}
+
+SdlScalerThreadPool::~SdlScalerThreadPool() {
+	stop();
+}
+
+void SdlScalerThreadPool::start(const ScalerPluginObject *plugin, const Graphics::PixelFormat &format, uint numThreads) {
+	stop();
+
+	if (numThreads < 2)
+		return;
+
+	_done = SDL_CreateSemaphore(0);
+	if (!_done) {
+		warning("Could not create semaphore for scaler threads: %s", SDL_GetError());
+		return;
+	}
+
+	_quit = false;
+	for (uint i = 1; i < numThreads; ++i) {
+		Worker *worker = new Worker();
+		worker->pool = this;
+		worker->scaler = plugin->createInstance(format);
+		worker->start = SDL_CreateSemaphore(0);
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		worker->thread = worker->start ? SDL_CreateThread(workerMain, "ScummVM scaler", worker) : nullptr;
+#else
+		worker->thread = worker->start ? SDL_CreateThread(workerMain, worker) : nullptr;
+#endif
+
+		if (!worker->thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			if (worker->start)
+				SDL_DestroySemaphore(worker->start);
+			delete worker->scaler;
+			delete worker;
+			break;
+		}
+
+		_workers.push_back(worker);
+	}
+
+	debug(2, "Scaling with %u threads", _workers.size() + 1);
+}
+
+void SdlScalerThreadPool::stop() {
+	_quit = true;
+	for (uint i = 0; i < _workers.size(); ++i) {
+		SDL_SemPost(_workers[i]->start);
+	}
+
+	for (uint i = 0; i < _workers.size(); ++i) {
+		Worker *worker = _workers[i];
+		SDL_WaitThread(worker->thread, nullptr);
+		SDL_DestroySemaphore(worker->start);
+		delete worker->scaler;
+		delete worker;
+	}
+	_workers.clear();
+
+	if (_done) {
+		SDL_DestroySemaphore(_done);
+		_done = nullptr;
+	}
+}
+
+void SdlScalerThreadPool::scale(Scaler *scaler, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+                                uint32 dstPitch, int width, int height, int x, int y) {
+	const int numBands = MIN<int>(_workers.size() + 1, height / kMinBandHeight);
+	if (numBands < 2) {
+		scaler->scale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		return;
+	}
+
+	// The scalers only look at the source pixels around the area they
+	// scale, so scaling the bands separately gives the same result as
+	// scaling the whole rect at once.
+	const uint factor = scaler->getFactor();
+	const int bandHeight = height / numBands;
+
+	for (int i = 1; i < numBands; ++i) {
+		Worker *worker = _workers[i - 1];
+		const int top = i * bandHeight;
+
+		if (worker->scaler->getFactor() != factor)
+			worker->scaler->setFactor(factor);
+
+		worker->srcPtr = srcPtr + top * srcPitch;
+		worker->srcPitch = srcPitch;
+		worker->dstPtr = dstPtr + top * factor * dstPitch;
+		worker->dstPitch = dstPitch;
+		worker->width = width;
+		worker->height = (i == numBands - 1) ? height - top : bandHeight;
+		worker->x = x;
+		worker->y = y + top;
+
+		SDL_SemPost(worker->start);
+	}
+
+	scaler->scale(srcPtr, srcPitch, dstPtr, dstPitch, width, bandHeight, x, y);
+
+	for (int i = 1; i < numBands; ++i) {
+		SDL_SemWait(_done);
+	}
+}
+
+int SDLCALL SdlScalerThreadPool::workerMain(void *data) {
+	Worker *worker = (Worker *)data;
+	SdlScalerThreadPool *pool = worker->pool;
+
+	while (true) {
+		SDL_SemWait(worker->start);
+		if (pool->_quit)
+			break;
+
+		worker->scaler->scale(worker->srcPtr, worker->srcPitch, worker->dstPtr, worker->dstPitch,
+		                      worker->width, worker->height, worker->x, worker->y);
+
+		SDL_SemPost(pool->_done);
+	}
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALER_THREADS_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALER_THREADS_H
+
+#include "graphics/pixelformat.h"
+#include "graphics/scalerplugin.h"
+#include "common/array.h"
+
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * A set of worker threads which scale horizontal bands of a rect
+ * concurrently.
+ *
+ * Every worker owns its own scaler instance, so scalers keeping state in
+ * the instance are safe to use. Scalers comparing against the old source
+ * (see ScalerPluginObject::useOldSource) must not be used though, since
+ * their output depends on the order the rects are scaled in.
+ */
+class SdlScalerThreadPool {
+public:
+	SdlScalerThreadPool();
+	~SdlScalerThreadPool();
+
+	/**
+	 * Start the worker threads. Any previously started workers are
+	 * stopped first.
+	 *
+	 * @param plugin     The scaler plugin the workers create their
+	 *                   scaler instances from.
+	 * @param format     The pixel format to scale.
+	 * @param numThreads The number of threads to scale with, including
+	 *                   the calling thread. Values below 2 disable
+	 *                   threading.
+	 */
+	void start(const ScalerPluginObject *plugin, const Graphics::PixelFormat &format, uint numThreads);
+
+	/**
+	 * Stop all worker threads.
+	 */
+	void stop();
+
+	/**
+	 * Scale a rect, with the same arguments as Scaler::scale. The rect is
+	 * split into horizontal bands which are scaled concurrently by the
+	 * workers and the calling thread. Returns when all bands are done.
+	 *
+	 * @param scaler The scaler to use on the calling thread. The workers
+	 *               use the same scale factor.
+	 */
+	void scale(Scaler *scaler, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	           uint32 dstPitch, int width, int height, int x, int y);
+
+private:
+	enum {
+		/** Smallest number of rows worth handing to another thread. */
+		kMinBandHeight = 16
+	};
+
+	struct Worker {
+		SdlScalerThreadPool *pool;
+		Scaler *scaler;
+		SDL_Thread *thread;
+		SDL_sem *start;
+
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width, height, x, y;
+	};
+
+	static int SDLCALL workerMain(void *data);
+
+	Common::Array<Worker *> _workers;
+	SDL_sem *_done;
+	bool _quit;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -127,6 +128,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenChangeCount(0),
 	_mouseSurface(nullptr), _mouseScaler(nullptr),
 	_mouseOrigSurface(nullptr), _cursorDontScale(false), _cursorPaletteDisabled(true),
+	_cursorCacheTime(0), _mouseOrigHash(0), _mouseBackground(nullptr), _restoreMouseBackground(false),
+	_cursorCacheHits(0), _cursorCacheMisses(0), _mousePixelsRestored(0), _mousePixelsDrawn(0),
 	_currentShakeXOffset(0), _currentShakeYOffset(0),
 	_paletteDirtyStart(0), _paletteDirtyEnd(0),
 	_screenIsLocked(false),
@@ -157,6 +160,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 	_mouseLastRect.x = _mouseLastRect.y = _mouseLastRect.w = _mouseLastRect.h = 0;
 	_mouseNextRect.x = _mouseNextRect.y = _mouseNextRect.w = _mouseNextRect.h = 0;
+	_mouseBackgroundRect.x = _mouseBackgroundRect.y = _mouseBackgroundRect.w = _mouseBackgroundRect.h = 0;
+	_mouseRestoredRect.x = _mouseRestoredRect.y = _mouseRestoredRect.w = _mouseRestoredRect.h = 0;
 
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	if (ConfMan.hasKey("use_sdl_debug_focusrect"))
@@ -175,6 +180,10 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_scaler = nullptr;
 	_maxExtraPixels = ScalerMan.getMaxExtraPixels();
 
+	_numScalerThreads = getConfiguredScalerThreads();
+
+	_restoreMouseBackground = ConfMan.getBool("restore_cursor_background");
+
 	_videoMode.fullscreen = ConfMan.getBool("fullscreen");
 	_videoMode.filtering = ConfMan.getBool("filtering");
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -188,6 +197,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
+	_scalerThreads.stop();
 	delete _scaler;
 	delete _mouseScaler;
 	if (_mouseOrigSurface) {
@@ -199,6 +209,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	if (_mouseSurface) {
 		SDL_FreeSurface(_mouseSurface);
 	}
+	clearCursorCache();
 	free(_currentPalette);
 	free(_overlayPalette);
 	free(_cursorPalette);
@@ -605,12 +616,28 @@ uint SurfaceSdlGraphicsManager::getDefaultScaleFactor() const {
 #endif
 }
 
+uint SurfaceSdlGraphicsManager::getConfiguredScalerThreads() {
+	// A thread count of 0 means one thread per CPU.
+	int scalerThreads = ConfMan.getInt("scaler_threads");
+	if (scalerThreads <= 0) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		scalerThreads = SDL_GetCPUCount();
+#else
+		scalerThreads = 1;
+#endif
+	}
+	return CLIP(scalerThreads, 1, 8);
+}
+
 bool SurfaceSdlGraphicsManager::setScaler(uint mode, int factor) {
 	Common::StackLock lock(_graphicsMutex);
 
 	assert(_transactionMode == kTransactionActive);
 
-	if (_oldVideoMode.setup && _oldVideoMode.scalerIndex == mode && _oldVideoMode.scaleFactor == factor)
+	// The thread count is picked up here, so that changing it in the
+	// options restarts the scaler threads like any other scaler change.
+	const uint numScalerThreads = getConfiguredScalerThreads();
+	if (_oldVideoMode.setup && _oldVideoMode.scalerIndex == mode && _oldVideoMode.scaleFactor == factor && _numScalerThreads == numScalerThreads)
 		return true;
 
 	int newFactor;
@@ -630,6 +657,7 @@ bool SurfaceSdlGraphicsManager::setScaler(uint mode, int factor) {
 
 	_videoMode.scalerIndex = mode;
 	_videoMode.scaleFactor = newFactor;
+	_numScalerThreads = numScalerThreads;
 
 	return true;
 }
@@ -663,6 +691,14 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 									_videoMode.screenWidth, _videoMode.screenHeight, _maxExtraPixels);
 	}
 
+	// Scalers using the old source depend on the order the rects are scaled
+	// in, thus they always run on this thread only.
+	if (_useOldSrc) {
+		_scalerThreads.stop();
+	} else {
+		_scalerThreads.start(_scalerPlugin, convertSDLPixelFormat(_hwScreen->format), _numScalerThreads);
+	}
+
 	// Blit everything to the screen
 	_forceRedraw = true;
 
@@ -1058,6 +1094,13 @@ void SurfaceSdlGraphicsManager::unloadGFXMode() {
 		_overlayscreen = nullptr;
 	}
 
+	if (_mouseBackground) {
+		SDL_FreeSurface(_mouseBackground);
+		_mouseBackground = nullptr;
+	}
+	_mouseBackgroundRect.w = _mouseBackgroundRect.h = 0;
+	_mouseRestoredRect.w = _mouseRestoredRect.h = 0;
+
 #ifdef USE_OSD
 	if (_osdMessageSurface) {
 		SDL_FreeSurface(_osdMessageSurface);
@@ -1140,10 +1183,19 @@ void SurfaceSdlGraphicsManager::updateScreen() {
 	Common::StackLock lock(_graphicsMutex);	// Lock the mutex until this function ends
 
 	internUpdateScreen();
+
+	_frameTimings.endFrame();
 }
 
 void SurfaceSdlGraphicsManager::updateScreen(SDL_Rect *dirtyRectList, int actualDirtyRects) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	// Our SDL_UpdateRects() times the texture upload and presenting separately.
 	SDL_UpdateRects(_hwScreen, actualDirtyRects, dirtyRectList);
+#else
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhasePresent);
+	SDL_UpdateRects(_hwScreen, actualDirtyRects, dirtyRectList);
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhasePresent);
+#endif
 }
 
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
@@ -1271,6 +1323,11 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	updateOSD();
 #endif
 
+	// The graph changes every frame, and like the OSD it is removed by
+	// drawing everything again.
+	if (_frameTimingsVisible)
+		_forceRedraw = true;
+
 	if (_videoMode.isHwPalette && _isInOverlayPalette != _overlayVisible) {
 		SDL_SetColors(_hwScreen, _overlayVisible ? _overlayPalette : _currentPalette, 0, 256);
 		_forceRedraw = true;
@@ -1312,6 +1369,15 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		uint32 bpp, srcPitch, dstPitch;
 		SDL_Rect *lastRect = _dirtyRectList + actualDirtyRects;
 
+		_frameTimings.startPhase(Graphics::FrameTimings::kPhaseScale);
+
+		// Remove the cursor before the game screen is drawn over it.
+		if (useMouseBackground()) {
+			_frameTimings.startPhase(Graphics::FrameTimings::kPhaseCursor);
+			restoreMouseBackground(doRedraw);
+			_frameTimings.endPhase(Graphics::FrameTimings::kPhaseCursor);
+		}
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			dst = *r;
 			dst.x += _maxExtraPixels;	// Shift rect since some scalers need to access the data around
@@ -1372,7 +1438,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
+				_scalerThreads.scale(_scaler, (byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
 						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
 
 				r->x = dst_x;
@@ -1398,12 +1464,27 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 			_dirtyRectList[0].h = _videoMode.hardwareHeight;
 		}
 
+		_frameTimings.startPhase(Graphics::FrameTimings::kPhaseCursor);
 		drawMouse();
+		_frameTimings.endPhase(Graphics::FrameTimings::kPhaseCursor);
+
+		// The areas where the cursor was removed and drawn are not part of
+		// the dirty rects in this case, but need to be updated as well.
+		if (useMouseBackground() && !_forceRedraw) {
+			if (_mouseRestoredRect.w && _mouseRestoredRect.h)
+				_dirtyRectList[actualDirtyRects++] = _mouseRestoredRect;
+			if (_mouseBackgroundRect.w && _mouseBackgroundRect.h)
+				_dirtyRectList[actualDirtyRects++] = _mouseBackgroundRect;
+		}
+		_mouseRestoredRect.w = _mouseRestoredRect.h = 0;
 
 #ifdef USE_OSD
 		drawOSD();
 #endif
 
+		if (_frameTimingsVisible)
+			drawFrameTimings();
+
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 		// We draw the focus rectangle on top of everything, to assure it's easily visible.
 		// Of course when the overlay is visible we do not show it, since it is only for game
@@ -1481,10 +1562,17 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		}
 #endif
 
+		_frameTimings.endPhase(Graphics::FrameTimings::kPhaseScale);
+
 		// Finally, blit all our changes to the screen
 		if (!_displayDisabled) {
 			updateScreen(_dirtyRectList, actualDirtyRects);
 		}
+
+		debug(9, "SDL: Cursor images %u cached, %u scaled; %u cursor pixels restored, %u drawn",
+		      _cursorCacheHits, _cursorCacheMisses, _mousePixelsRestored, _mousePixelsDrawn);
+		_cursorCacheHits = _cursorCacheMisses = 0;
+		_mousePixelsRestored = _mousePixelsDrawn = 0;
 	}
 
 	// Set up the old scale factor
@@ -1620,6 +1708,8 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const void *buf, int pitch, int
 	assert(h > 0 && y + h <= _videoMode.screenHeight);
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseCopyRect);
+
 	addDirtyRect(x, y, w, h, false);
 
 	// Try to lock the screen surface
@@ -1640,6 +1730,8 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const void *buf, int pitch, int
 
 	// Unlock the screen surface
 	SDL_UnlockSurface(_screen);
+
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseCopyRect);
 }
 
 Graphics::Surface *SurfaceSdlGraphicsManager::lockScreen() {
@@ -1988,6 +2080,14 @@ void SurfaceSdlGraphicsManager::copyRectToOverlay(const void *buf, int pitch, in
 #pragma mark --- Mouse ---
 #pragma mark -
 
+static uint32 hashCursorData(const byte *data, uint size) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	while (size--)
+		hash = (hash ^ *data++) * 16777619u;
+	return hash;
+}
+
 void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keyColor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) {
 
 	if (mask && (!format || format->bytesPerPixel == 1)) {
@@ -2175,7 +2275,89 @@ void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h,
 
 	SDL_UnlockSurface(_mouseOrigSurface);
 
+	_mouseOrigHash = hashCursorData((const byte *)buf, w * h * _cursorFormat.bytesPerPixel);
+
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseCursor);
 	blitCursor();
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseCursor);
+}
+
+SurfaceSdlGraphicsManager::CursorCacheEntry *SurfaceSdlGraphicsManager::findCachedCursor() {
+	const int bpp = _mouseOrigSurface->format->BytesPerPixel;
+	const byte *src = (const byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * _maxExtraPixels + _maxExtraPixels * bpp;
+
+	for (uint i = 0; i < _cursorCache.size(); ++i) {
+		CursorCacheEntry &entry = _cursorCache[i];
+		if (entry.hash != _mouseOrigHash || entry.w != _mouseCurState.w || entry.h != _mouseCurState.h ||
+		    entry.format != _cursorFormat || entry.dontScale != _cursorDontScale ||
+		    entry.scalerIndex != _videoMode.scalerIndex || entry.scaleFactor != _videoMode.scaleFactor ||
+		    entry.aspectRatioCorrection != _videoMode.aspectRatioCorrection ||
+		    entry.surface->w != _mouseCurState.rW || entry.surface->h != _mouseCurState.rH) {
+			continue;
+		}
+
+		// Rule out hash collisions.
+		bool equal = true;
+		for (int y = 0; y < entry.h && equal; ++y)
+			equal = !memcmp(&entry.source[y * entry.w * bpp], src + y * _mouseOrigSurface->pitch, entry.w * bpp);
+
+		if (equal) {
+			entry.lastUsed = ++_cursorCacheTime;
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
+
+void SurfaceSdlGraphicsManager::addCachedCursor() {
+	// Replace the least recently used image if the cache is full.
+	uint index = _cursorCache.size();
+	if (index >= kCursorCacheSize) {
+		index = 0;
+		for (uint i = 1; i < _cursorCache.size(); ++i) {
+			if (_cursorCache[i].lastUsed < _cursorCache[index].lastUsed)
+				index = i;
+		}
+		SDL_FreeSurface(_cursorCache[index].surface);
+	} else {
+		_cursorCache.push_back(CursorCacheEntry());
+	}
+
+	CursorCacheEntry &entry = _cursorCache[index];
+	entry.hash = _mouseOrigHash;
+	entry.w = _mouseCurState.w;
+	entry.h = _mouseCurState.h;
+	entry.format = _cursorFormat;
+	entry.dontScale = _cursorDontScale;
+	entry.scalerIndex = _videoMode.scalerIndex;
+	entry.scaleFactor = _videoMode.scaleFactor;
+	entry.aspectRatioCorrection = _videoMode.aspectRatioCorrection;
+	entry.lastUsed = ++_cursorCacheTime;
+
+	const int bpp = _mouseOrigSurface->format->BytesPerPixel;
+	entry.source.resize(entry.w * entry.h * bpp);
+	Graphics::copyBlit(&entry.source[0], (const byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * _maxExtraPixels + _maxExtraPixels * bpp,
+	                   entry.w * bpp, _mouseOrigSurface->pitch, entry.w, entry.h, bpp);
+
+	entry.surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+	                                     _mouseSurface->w, _mouseSurface->h,
+	                                     _mouseSurface->format->BitsPerPixel,
+	                                     _mouseSurface->format->Rmask,
+	                                     _mouseSurface->format->Gmask,
+	                                     _mouseSurface->format->Bmask,
+	                                     _mouseSurface->format->Amask);
+	if (entry.surface == nullptr)
+		error("Allocating cursor cache surface failed");
+
+	Graphics::copyBlit((byte *)entry.surface->pixels, (const byte *)_mouseSurface->pixels,
+	                   entry.surface->pitch, _mouseSurface->pitch, _mouseSurface->w, _mouseSurface->h, bpp);
+}
+
+void SurfaceSdlGraphicsManager::clearCursorCache() {
+	for (uint i = 0; i < _cursorCache.size(); ++i)
+		SDL_FreeSurface(_cursorCache[i].surface);
+	_cursorCache.clear();
 }
 
 void SurfaceSdlGraphicsManager::blitCursor() {
@@ -2254,6 +2436,21 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 	SDL_LockSurface(_mouseOrigSurface);
 	SDL_LockSurface(_mouseSurface);
 
+	// The palette is applied when drawing the cursor, so the cached image
+	// stays valid when only the palette changes.
+	const CursorCacheEntry *cached = findCachedCursor();
+	if (cached) {
+		Graphics::copyBlit((byte *)_mouseSurface->pixels, (const byte *)cached->surface->pixels,
+		                   _mouseSurface->pitch, cached->surface->pitch,
+		                   _mouseSurface->w, _mouseSurface->h, _mouseSurface->format->BytesPerPixel);
+
+		SDL_UnlockSurface(_mouseSurface);
+		SDL_UnlockSurface(_mouseOrigSurface);
+
+		++_cursorCacheHits;
+		return;
+	}
+
 	// If possible, use the same scaler for the cursor as for the rest of
 	// the game. This only works well with the non-blurring scalers so we
 	// otherwise use the Normal scaler
@@ -2287,6 +2484,9 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		stretch200To240Nearest((uint8 *)_mouseSurface->pixels, _mouseSurface->pitch, rW, rH1, 0, 0, 0, convertSDLPixelFormat(_mouseSurface->format));
 #endif
 
+	addCachedCursor();
+	++_cursorCacheMisses;
+
 	SDL_UnlockSurface(_mouseSurface);
 	SDL_UnlockSurface(_mouseOrigSurface);
 }
@@ -2325,6 +2525,12 @@ void SurfaceSdlGraphicsManager::undrawMouse() {
 	//
 	// The mouse is undrawn using virtual coordinates, i.e. they may be
 	// scaled and aspect-ratio corrected.
+	//
+	// This is not needed when the screen contents below the cursor are
+	// kept, see restoreMouseBackground().
+
+	if (useMouseBackground())
+		return;
 
 	if (_mouseLastRect.w != 0 && _mouseLastRect.h != 0)
 		addDirtyRect(_mouseLastRect.x, _mouseLastRect.y, _mouseLastRect.w, _mouseLastRect.h, _overlayInGUI);
@@ -2358,6 +2564,10 @@ void SurfaceSdlGraphicsManager::drawMouse() {
 	dst.w = _mouseCurState.rW;
 	dst.h = _mouseCurState.rH;
 
+	if (useMouseBackground())
+		saveMouseBackground(dst);
+	_mousePixelsDrawn += dst.w * dst.h;
+
 	// Note that SDL_BlitSurface() and addDirtyRect() will both perform any
 	// clipping necessary
 
@@ -2365,6 +2575,73 @@ void SurfaceSdlGraphicsManager::drawMouse() {
 		error("SDL_BlitSurface failed: %s", SDL_GetError());
 }
 
+void SurfaceSdlGraphicsManager::saveMouseBackground(const SDL_Rect &area) {
+	int x = area.x, y = area.y, w = area.w, h = area.h;
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y = 0;
+	}
+	w = MIN(w, _hwScreen->w - x);
+	h = MIN(h, _hwScreen->h - y);
+
+	if (w <= 0 || h <= 0) {
+		_mouseBackgroundRect.w = _mouseBackgroundRect.h = 0;
+		return;
+	}
+
+	if (!_mouseBackground || _mouseBackground->w < w || _mouseBackground->h < h ||
+	    _mouseBackground->format->BytesPerPixel != _hwScreen->format->BytesPerPixel) {
+		if (_mouseBackground)
+			SDL_FreeSurface(_mouseBackground);
+
+		_mouseBackground = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h,
+		                                        _hwScreen->format->BitsPerPixel,
+		                                        _hwScreen->format->Rmask,
+		                                        _hwScreen->format->Gmask,
+		                                        _hwScreen->format->Bmask,
+		                                        _hwScreen->format->Amask);
+		if (_mouseBackground == nullptr)
+			error("Allocating _mouseBackground failed");
+	}
+
+	// The pixels are copied as they are, an SDL blit would apply the
+	// palette of paletted screens.
+	const int bpp = _hwScreen->format->BytesPerPixel;
+	SDL_LockSurface(_hwScreen);
+	Graphics::copyBlit((byte *)_mouseBackground->pixels, (const byte *)_hwScreen->pixels + y * _hwScreen->pitch + x * bpp,
+	                   _mouseBackground->pitch, _hwScreen->pitch, w, h, bpp);
+	SDL_UnlockSurface(_hwScreen);
+
+	_mouseBackgroundRect.x = x;
+	_mouseBackgroundRect.y = y;
+	_mouseBackgroundRect.w = w;
+	_mouseBackgroundRect.h = h;
+}
+
+void SurfaceSdlGraphicsManager::restoreMouseBackground(bool redraw) {
+	if (!_mouseBackgroundRect.w || !_mouseBackgroundRect.h)
+		return;
+
+	// On a full redraw everything below the cursor is drawn anew anyway.
+	if (!redraw) {
+		const int bpp = _hwScreen->format->BytesPerPixel;
+		SDL_LockSurface(_hwScreen);
+		Graphics::copyBlit((byte *)_hwScreen->pixels + _mouseBackgroundRect.y * _hwScreen->pitch + _mouseBackgroundRect.x * bpp,
+		                   (const byte *)_mouseBackground->pixels, _hwScreen->pitch, _mouseBackground->pitch,
+		                   _mouseBackgroundRect.w, _mouseBackgroundRect.h, bpp);
+		SDL_UnlockSurface(_hwScreen);
+
+		_mouseRestoredRect = _mouseBackgroundRect;
+		_mousePixelsRestored += _mouseBackgroundRect.w * _mouseBackgroundRect.h;
+	}
+
+	_mouseBackgroundRect.w = _mouseBackgroundRect.h = 0;
+}
+
 #pragma mark -
 #pragma mark --- On Screen Display ---
 #pragma mark -
@@ -2579,6 +2856,27 @@ void SurfaceSdlGraphicsManager::drawOSD() {
 
 #endif
 
+void SurfaceSdlGraphicsManager::drawFrameTimings() {
+	// Paletted screens lack the colors for the graph.
+	if (_hwScreen->format->BytesPerPixel == 1)
+		return;
+
+	const int w = MIN<int>(Graphics::FrameTimings::kHistorySize, _hwScreen->w);
+	const int h = MIN<int>(kFrameTimingsHeight, _hwScreen->h);
+
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseGraph);
+	SDL_LockSurface(_hwScreen);
+
+	Graphics::Surface graph;
+	graph.init(w, h, _hwScreen->pitch,
+	           (byte *)_hwScreen->pixels + (_hwScreen->h - h) * _hwScreen->pitch,
+	           convertSDLPixelFormat(_hwScreen->format));
+	_frameTimings.drawGraph(graph);
+
+	SDL_UnlockSurface(_hwScreen);
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseGraph);
+}
+
 void SurfaceSdlGraphicsManager::handleResizeImpl(const int width, const int height) {
 	SdlGraphicsManager::handleResizeImpl(width, height);
 	recalculateDisplayAreas();
@@ -2825,7 +3123,11 @@ SDL_Surface *SurfaceSdlGraphicsManager::SDL_SetVideoMode(int width, int height,
 }
 
 void SurfaceSdlGraphicsManager::SDL_UpdateRects(SDL_Surface *screen, int numrects, SDL_Rect *rects) {
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhaseUpload);
 	SDL_UpdateTexture(_screenTexture, nullptr, screen->pixels, screen->pitch);
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhaseUpload);
+
+	_frameTimings.startPhase(Graphics::FrameTimings::kPhasePresent);
 
 	SDL_Rect viewport;
 
@@ -2838,6 +3140,7 @@ void SurfaceSdlGraphicsManager::SDL_UpdateRects(SDL_Surface *screen, int numrect
 	SDL_RenderClear(_renderer);
 	SDL_RenderCopy(_renderer, _screenTexture, nullptr, &viewport);
 	SDL_RenderPresent(_renderer);
+	_frameTimings.endPhase(Graphics::FrameTimings::kPhasePresent);
 }
 
 int SurfaceSdlGraphicsManager::SDL_SetColors(SDL_Surface *surface, SDL_Color *colors, int firstcolor, int ncolors) {
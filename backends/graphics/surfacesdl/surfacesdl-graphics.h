@@ -27,10 +27,12 @@
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
+#include "common/array.h"
 #include "common/events.h"
 #include "common/mutex.h"
 
 #include "backends/events/sdl/sdl-events.h"
+#include "backends/graphics/surfacesdl/scaler-threads.h"
 
 #include "backends/platform/sdl/sdl-sys.h"
 
@@ -166,6 +168,12 @@ protected:
 	void drawOSD();
 #endif
 
+	enum {
+		kFrameTimingsHeight = 96	/** < Height of the frame timing graph, in screen pixels */
+	};
+	/** Draw the frame timing graph in the lower left corner of the screen */
+	void drawFrameTimings();
+
 	bool gameNeedsAspectRatioCorrection() const override {
 		return _videoMode.aspectRatioCorrection;
 	}
@@ -332,6 +340,13 @@ protected:
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
+	/** Worker threads scaling the dirty rects of the screen */
+	SdlScalerThreadPool _scalerThreads;
+	uint _numScalerThreads;
+
+	/** Returns the number of scaler threads asked for by "scaler_threads" */
+	static uint getConfiguredScalerThreads();
+
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
 
@@ -386,6 +401,58 @@ protected:
 	SDL_Surface *_mouseOrigSurface;
 	SDL_Surface *_mouseSurface;
 
+	/**
+	 * A pre-scaled cursor image. Engines with animated cursors set the
+	 * same few images over and over, so these are kept around to avoid
+	 * scaling them each time.
+	 */
+	struct CursorCacheEntry {
+		uint32 hash;
+		int w, h;
+		Graphics::PixelFormat format;
+		bool dontScale;
+		uint scalerIndex;
+		int scaleFactor;
+		bool aspectRatioCorrection;
+		uint32 lastUsed;
+		/** The source image, to rule out hash collisions. */
+		Common::Array<byte> source;
+		SDL_Surface *surface;
+	};
+
+	enum {
+		kCursorCacheSize = 8
+	};
+
+	Common::Array<CursorCacheEntry> _cursorCache;
+	uint32 _cursorCacheTime;
+	/** Hash of the image data in _mouseOrigSurface. */
+	uint32 _mouseOrigHash;
+
+	CursorCacheEntry *findCachedCursor();
+	void addCachedCursor();
+	void clearCursorCache();
+
+	/**
+	 * Copy of the screen contents below the cursor, in screen coordinates.
+	 * Restoring it removes the cursor without scaling this area of the
+	 * game screen again. Only used without double buffering.
+	 */
+	SDL_Surface *_mouseBackground;
+	SDL_Rect _mouseBackgroundRect;
+	/** The area restored from _mouseBackground in the current frame. */
+	SDL_Rect _mouseRestoredRect;
+	/** Whether the screen below the cursor is kept, see "restore_cursor_background". */
+	bool _restoreMouseBackground;
+
+	bool useMouseBackground() const { return _restoreMouseBackground && !_isDoubleBuf; }
+	void restoreMouseBackground(bool redraw);
+	void saveMouseBackground(const SDL_Rect &area);
+
+	/** Cursor work done in the current frame, for debug output. */
+	uint _cursorCacheHits, _cursorCacheMisses;
+	uint _mousePixelsRestored, _mousePixelsDrawn;
+
 	// Shake mode
 	// This is always set to 0 when building with SDL2.
 	int _currentShakeXOffset;
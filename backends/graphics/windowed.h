@@ -27,6 +27,7 @@
 #include "common/rect.h"
 #include "common/config-manager.h"
 #include "common/textconsole.h"
+#include "graphics/frametimings.h"
 #include "graphics/scaler/aspect.h"
 
 enum {
@@ -52,7 +53,8 @@ public:
 		_cursorX(0),
 		_cursorY(0),
 		_cursorNeedsRedraw(false),
-		_cursorLastInActiveArea(true) {}
+		_cursorLastInActiveArea(true),
+		_frameTimingsVisible(false) {}
 
 	void showOverlay(bool inGUI) override {
 		_overlayInGUI = inGUI;
@@ -382,6 +384,17 @@ protected:
 	 */
 	bool _cursorLastInActiveArea;
 
+	/**
+	 * Timings of the recent frames, split into the work done by the engine
+	 * and the stages of the graphics manager.
+	 */
+	Graphics::FrameTimings _frameTimings;
+
+	/**
+	 * Whether a graph of the frame timings is drawn on top of the screen.
+	 */
+	bool _frameTimingsVisible;
+
 	/**
 	 * The position of the mouse cursor, in window coordinates.
 	 */
@@ -26,6 +26,7 @@
 #include "backends/mixer/mixer.h"
 #include "gui/EventRecorder.h"
 
+#include "common/profiler.h"
 #include "common/timer.h"
 #include "graphics/pixelformat.h"
 
@@ -174,6 +175,8 @@ void ModularGraphicsBackend::fillScreen(uint32 col) {
 }
 
 void ModularGraphicsBackend::updateScreen() {
+	PROFILE_ZONE("OSystem::updateScreen");
+
 #ifdef ENABLE_EVENTRECORDER
 	g_system->getMillis();		// force event recorder to update the tick count
 	g_eventRec.processScreenUpdate();
@@ -704,6 +704,16 @@ uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	return millis;
 }
 
+uint64 OSystem_SDL::getMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	static const uint64 frequency = SDL_GetPerformanceFrequency();
+	const uint64 counter = SDL_GetPerformanceCounter();
+	return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+#else
+	return (uint64)SDL_GetTicks() * 1000;
+#endif
+}
+
 void OSystem_SDL::delayMillis(uint msecs) {
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processDelayMillis())
@@ -110,6 +110,8 @@ static const char HELP_STRING1[] =
 	"  --scaler=MODE            Select graphics scaler (normal,hq,edge,advmame,sai,\n"
 	"                           supersai,supereagle,pm,dotmatrix,tv2x)\n"
 	"  --scale-factor=FACTOR    Factor to scale the graphics by\n"
+	"  --scaler-threads=NUM     Number of threads used by the graphics scaler\n"
+	"                           (0 = one per CPU, SDL only)\n"
 	"  --filtering              Force filtered graphics mode\n"
 	"  --no-filtering           Force unfiltered graphics mode\n"
 #ifdef USE_OPENGL
@@ -186,7 +188,7 @@ static const char HELP_STRING4[] =
 	"                           atari, macintosh, macintoshbw)\n"
 #ifdef ENABLE_EVENTRECORDER
 	"  --record-mode=MODE       Specify record mode for event recorder (record, playback,\n"
-	"                           info, update, passthrough [default])\n"
+	"                           benchmark, info, update, passthrough [default])\n"
 	"  --record-file-name=FILE  Specify record file name\n"
 	"  --disable-display        Disable any gfx output. Used for headless events\n"
 	"                           playback by Event Recorder\n"
@@ -290,8 +292,11 @@ void registerDefaults() {
 	ConfMan.registerDefault("stretch_mode", "default");
 	ConfMan.registerDefault("scaler", "default");
 	ConfMan.registerDefault("scale_factor", -1);
+	ConfMan.registerDefault("scaler_threads", 1);
+	ConfMan.registerDefault("restore_cursor_background", false);
 	ConfMan.registerDefault("shader", "default");
 	ConfMan.registerDefault("show_fps", false);
+	ConfMan.registerDefault("frame_timings", false);
 	ConfMan.registerDefault("dirtyrects", true);
 	ConfMan.registerDefault("vsync", true);
 
@@ -330,6 +335,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("save_slot", -1);
 	ConfMan.registerDefault("autosave_period", 5 * 60); // By default, trigger autosave every 5 minutes
 	ConfMan.registerDefault("engine_speed", 60); // FPS limit for 3D games
+	ConfMan.registerDefault("prefetch_game_files", false);
 
 #if defined(ENABLE_SCUMM) || defined(ENABLE_SWORD2)
 	ConfMan.registerDefault("object_labels", true);
@@ -744,6 +750,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_INT("scale-factor")
 			END_OPTION
 
+			DO_LONG_OPTION_INT("scaler-threads")
+			END_OPTION
+
 			DO_LONG_OPTION("shader")
 			END_OPTION
 
@@ -1913,6 +1922,7 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 		"stretch-mode",
 		"scaler",
 		"scale-factor",
+		"scaler-threads",
 		"filtering",
 		"gui-theme",
 		"themepath",
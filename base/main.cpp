@@ -44,6 +44,8 @@
 #include "gui/EventRecorder.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/memtrack.h"
+#include "common/profiler.h"
 #ifdef ENABLE_EVENTRECORDER
 #include "common/recorderfile.h"
 #endif
@@ -69,6 +71,8 @@
 #endif
 #include "graphics/scalerplugin.h"
 
+#include "image/codecs/codec.h"
+
 #include "backends/keymapper/action.h"
 #include "backends/keymapper/keymap.h"
 #include "backends/keymapper/keymapper.h"
@@ -217,6 +221,9 @@ static Common::Error runGame(const Plugin *plugin, const Plugin *enginePlugin, O
 		metaEngine.registerDefaultSettings(target);
 	}
 
+	// Account the memory allocated by the engine to it, until it is destroyed
+	MEMORY_DYNAMIC_TAG_SCOPE((Common::String("engine:") + ConfMan.get("engineid")).c_str());
+
 	err = metaEngine.createInstance(&system, &engine);
 
 	// Check for errors
@@ -316,7 +323,11 @@ static Common::Error runGame(const Plugin *plugin, const Plugin *enginePlugin, O
 	system.getEventManager()->purgeMouseEvents();
 
 	// Run the engine
-	Common::Error result = engine->run();
+	Common::Error result;
+	{
+		PROFILE_ZONE("Engine::run");
+		result = engine->run();
+	}
 
 	// Make sure we do not return to the launcher if this is not possible.
 	if (!engine->hasFeature(Engine::kSupportsReturnToLauncher))
@@ -791,6 +802,8 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderUpdate);
 			} else if (recordMode == "playback") {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback);
+			} else if (recordMode == "benchmark") {
+				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback, true);
 			} else if ((recordMode == "info") && (!recordFileName.empty())) {
 				Common::PlaybackFile record;
 				record.openRead(recordFileName);
@@ -918,6 +931,12 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #endif
 	EngineManager::destroy();
 	Graphics::YUVToRGBManager::destroy();
+	Image::Codec::freeQuickTimeDitherTables();
+
+#ifdef ENABLE_MEMORY_TRACKING
+	// Whatever is still allocated at this point is leaked
+	debug("Memory still allocated at exit:\n%s", Common::formatMemoryTagStats().c_str());
+#endif
 
 	return 0;
 }
@@ -22,6 +22,7 @@
 #include "common/archive.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/profiler.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
@@ -174,6 +175,112 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+
+	// The archive comes after the others of the same priority
+	--it;
+	it->_order = _nextOrder++;
+	it->_indexState = kIndexPending;
+	_indexPending = true;
+}
+
+void SearchSet::updateIndex() const {
+	if (!_indexPending)
+		return;
+
+	bool pending = false;
+	for (ArchiveNodeList::const_iterator it = _list.begin(); it != _list.end(); ++it) {
+		if (it->_indexState == kIndexPending)
+			indexArchive(*it);
+		pending = pending || it->_indexState == kIndexPending;
+	}
+	_indexPending = pending;
+}
+
+void SearchSet::insertShadowed(Array<IndexEntry> &entries, const IndexEntry &entry) {
+	uint i = 0;
+	while (i < entries.size() && entries[i].precedes(entry))
+		i++;
+	entries.insert_at(i, entry);
+}
+
+void SearchSet::indexArchive(const Node &node) const {
+	Array<Path> paths;
+	switch (node._arc->listMemberPaths(paths)) {
+	case kMemberPathsListed:
+		break;
+	case kMemberPathsNotListedYet:
+		return;
+	case kMemberPathsNotListable:
+	default:
+		node._indexState = kNotIndexable;
+		return;
+	}
+
+	IndexEntry entry;
+	entry._arc = node._arc;
+	entry._priority = node._priority;
+	entry._order = node._order;
+
+	for (uint i = 0; i < paths.size(); ++i) {
+		PathIndex::iterator it = _index.find(paths[i]);
+		if (it == _index.end()) {
+			_index[paths[i]] = entry;
+		} else if (it->_value._arc == node._arc) {
+			// Listed twice, e.g. in different case
+			continue;
+		} else if (entry.precedes(it->_value)) {
+			insertShadowed(_shadowedPaths[paths[i]], it->_value);
+			it->_value = entry;
+		} else {
+			insertShadowed(_shadowedPaths[paths[i]], entry);
+		}
+	}
+
+	node._indexState = kIndexed;
+}
+
+void SearchSet::unindexArchive(const Node &node) {
+	if (node._indexState != kIndexed)
+		return;
+
+	Array<Path> paths;
+	node._arc->listMemberPaths(paths);
+
+	for (uint i = 0; i < paths.size(); ++i) {
+		PathIndex::iterator it = _index.find(paths[i]);
+		if (it == _index.end())
+			continue;
+
+		ShadowedPathMap::iterator shadowed = _shadowedPaths.find(paths[i]);
+		if (it->_value._arc == node._arc) {
+			// Reveal the archive coming next for this path, if any
+			if (shadowed == _shadowedPaths.end()) {
+				_index.erase(it);
+				continue;
+			}
+			it->_value = shadowed->_value.front();
+			shadowed->_value.remove_at(0);
+		} else if (shadowed != _shadowedPaths.end()) {
+			for (uint j = 0; j < shadowed->_value.size(); ++j) {
+				if (shadowed->_value[j]._arc == node._arc) {
+					shadowed->_value.remove_at(j);
+					break;
+				}
+			}
+		}
+
+		if (shadowed != _shadowedPaths.end() && shadowed->_value.empty())
+			_shadowedPaths.erase(shadowed);
+	}
+
+	node._indexState = kIndexPending;
+}
+
+Archive *SearchSet::lookupIndex(const Path &path) const {
+	updateIndex();
+
+	PathIndex::const_iterator it = _index.find(path);
+	return it != _index.end() ? it->_value._arc : nullptr;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -252,6 +359,7 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 void SearchSet::remove(const String &name) {
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		unindexArchive(*it);
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
@@ -278,6 +386,9 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	_index.clear();
+	_shadowedPaths.clear();
+	_indexPending = false;
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -290,20 +401,31 @@ void SearchSet::setPriority(const String &name, int priority) {
 	if (priority == it->_priority)
 		return;
 
+	unindexArchive(*it);
 	Node node(*it);
 	_list.erase(it);
 	node._priority = priority;
 	insert(node);
 }
 
+// Lookups ask the archive the index gives for the path, and the archives
+// which are not indexed. Should the indexed archive not find the file after
+// all, e.g. as it has been deleted, all the following archives are asked.
+
 bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
+	Archive *indexed = lookupIndex(path);
+	bool askAll = false;
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
+		if (!askAll && it->_indexState == kIndexed && it->_arc != indexed)
+			continue;
 		if (it->_arc->hasFile(path))
 			return true;
+		askAll = askAll || it->_arc == indexed;
 	}
 
 	return false;
@@ -333,10 +455,16 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path) const {
 	if (path.empty())
 		return ArchiveMemberPtr();
 
+	Archive *indexed = lookupIndex(path);
+	bool askAll = false;
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
+		if (!askAll && it->_indexState == kIndexed && it->_arc != indexed)
+			continue;
 		if (it->_arc->hasFile(path))
 			return it->_arc->getMember(path);
+		askAll = askAll || it->_arc == indexed;
 	}
 
 	return ArchiveMemberPtr();
@@ -346,11 +474,19 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	PROFILE_ZONE("SearchSet::createReadStreamForMember");
+
+	Archive *indexed = lookupIndex(path);
+	bool askAll = false;
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
+		if (!askAll && it->_indexState == kIndexed && it->_arc != indexed)
+			continue;
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
 		if (stream)
 			return stream;
+		askAll = askAll || it->_arc == indexed;
 	}
 
 	return nullptr;
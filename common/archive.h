@@ -22,6 +22,7 @@
 #ifndef COMMON_ARCHIVE_H
 #define COMMON_ARCHIVE_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/list.h"
 #include "common/path.h"
@@ -130,6 +131,27 @@ public:
 	 */
 	virtual int listMembers(ArchiveMemberList &list) const = 0;
 
+	/** Whether listMemberPaths() listed the paths of an Archive. */
+	enum MemberPathListing {
+		kMemberPathsListed,			//!< The paths were added
+		kMemberPathsNotListedYet,	//!< The paths cannot be listed cheaply yet, but may be later
+		kMemberPathsNotListable		//!< The paths cannot be listed cheaply
+	};
+
+	/**
+	 * Add the paths of all the files of the Archive to @p paths, in the form
+	 * accepted by hasFile(), and return kMemberPathsListed. SearchSet uses
+	 * them to index its archives.
+	 *
+	 * Archives which cannot list their paths cheaply, or whose files may
+	 * change once listed, return kMemberPathsNotListable, which is the
+	 * default. SearchSet then asks them about every file it looks for.
+	 * Archives which will be able to list their paths later, once they have
+	 * cached them, return kMemberPathsNotListedYet, and are asked for their
+	 * paths again on the next lookups.
+	 */
+	virtual MemberPathListing listMemberPaths(Array<Path> &paths) const { return kMemberPathsNotListable; }
+
 	/**
 	 * Return an ArchiveMember representation of the given file.
 	 */
@@ -221,29 +243,67 @@ private:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet does guarantee that searches are performed in DESCENDING
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * The paths of the archives which can list them (see Archive::listMemberPaths)
+ * are merged into an index telling which of these archives comes first for
+ * each path, so that looking a file up asks only that archive, plus the
+ * archives which cannot list their paths. The archives are indexed on the
+ * first lookup following their addition; the ones which cannot list their
+ * paths yet are asked again on the following lookups.
  */
 class SearchSet : public Archive {
+	enum IndexState {
+		kIndexPending,	//!< Not indexed yet, asked for its paths on the next lookup
+		kIndexed,		//!< All its paths are in the index
+		kNotIndexable	//!< Cannot list its paths, asked on every lookup
+	};
+
 	struct Node {
 		int		_priority;
+		uint	_order;		//!< Breaks ties between archives of the same priority
 		String	_name;
 		Archive	*_arc;
 		bool	_autoFree;
+		mutable IndexState	_indexState;
 		Node(int priority, const String &name, Archive *arc, bool autoFree)
-			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree) {
+			: _priority(priority), _order(0), _name(name), _arc(arc), _autoFree(autoFree), _indexState(kIndexPending) {
 		}
 	};
 	typedef List<Node> ArchiveNodeList;
 	ArchiveNodeList _list;
 
+	/** An archive holding a path, with its place in the search order. */
+	struct IndexEntry {
+		Archive	*_arc;
+		int		_priority;
+		uint	_order;
+		bool precedes(const IndexEntry &x) const {
+			return _priority > x._priority || (_priority == x._priority && _order < x._order);
+		}
+	};
+	typedef HashMap<Path, IndexEntry, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualsTo> PathIndex;
+	typedef HashMap<Path, Array<IndexEntry>, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualsTo> ShadowedPathMap;
+
+	mutable PathIndex _index;					//!< The archive coming first for each path
+	mutable ShadowedPathMap _shadowedPaths;		//!< The following ones, in search order, for paths held by several archives
+	mutable bool _indexPending;					//!< Whether some archives wait to be indexed
+	uint _nextOrder;
+
 	ArchiveNodeList::iterator find(const String &name);
 	ArchiveNodeList::const_iterator find(const String &name) const;
 
 	void insert(const Node& node); //!< Add an archive while keeping the list sorted by descending priority.
 
+	static void insertShadowed(Array<IndexEntry> &entries, const IndexEntry &entry);
+	void updateIndex() const;
+	void indexArchive(const Node &node) const;
+	void unindexArchive(const Node &node);
+	Archive *lookupIndex(const Path &path) const;
+
 	bool _ignoreClashes;
 
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _indexPending(false), _nextOrder(0), _ignoreClashes(false) { }
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -0,0 +1,151 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/arena.h"
+#include "common/debug.h"
+#include "common/memtrack.h"
+#include "common/str.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+enum {
+	/** Byte filling the memory released by the arena in non-release builds. */
+	kPoisonByte = 0xDD
+};
+
+static inline void poison(byte *data, size_t size) {
+#ifndef RELEASE_BUILD
+	memset(data, kPoisonByte, size);
+#endif
+}
+
+Arena::Arena(size_t blockSize, const char *name)
+	: _first(nullptr), _current(nullptr), _blockSize(blockSize), _used(0),
+	  _highWaterMark(0), _capacity(0), _name(name) {
+}
+
+Arena::~Arena() {
+	if (_highWaterMark)
+		debug(2, "Arena '%s': high water mark of %u bytes, %u bytes in blocks",
+		      _name, (uint)_highWaterMark, (uint)_capacity);
+
+	freeMemory();
+}
+
+Arena::Block *Arena::allocBlock(size_t size) {
+	Block *block = (Block *)trackedMalloc(sizeof(Block) + size);
+	if (!block)
+		::error("Common::Arena: failure to allocate %u bytes for '%s'", (uint)size, _name);
+
+	block->next = nullptr;
+	block->size = size;
+	block->offset = 0;
+	poison(block->data(), size);
+
+	_capacity += size;
+	return block;
+}
+
+void *Arena::allocateSlow(size_t size, size_t alignment) {
+	assert(alignment && !(alignment & (alignment - 1)));
+
+	// Move on to the next block kept from before, if the data fits in it.
+	// Otherwise, put a new block in front of it.
+	Block *next = _current ? _current->next : _first;
+	if (!next || size + alignment - 1 > next->size) {
+		Block *block = allocBlock(MAX<size_t>(_blockSize, size + alignment - 1));
+		block->next = next;
+		if (_current)
+			_current->next = block;
+		else
+			_first = block;
+		next = block;
+	}
+
+	_current = next;
+	assert(_current->offset == 0);
+	return allocate(size, alignment);
+}
+
+char *Arena::copyString(const char *str) {
+	const size_t size = strlen(str) + 1;
+	char *copy = (char *)allocate(size, 1);
+	memcpy(copy, str, size);
+	return copy;
+}
+
+char *Arena::copyString(const String &str) {
+	char *copy = (char *)allocate(str.size() + 1, 1);
+	memcpy(copy, str.c_str(), str.size() + 1);
+	return copy;
+}
+
+Arena::Marker Arena::getMarker() const {
+	Marker marker;
+	marker.block = _current;
+	marker.offset = _current ? _current->offset : 0;
+	marker.used = _used;
+	return marker;
+}
+
+void Arena::rewind(const Marker &marker) {
+	assert(marker.used <= _used);
+
+	// Release the data of the blocks used since the marker was taken
+	Block *block = marker.block ? marker.block : _first;
+	size_t offset = marker.offset;
+	for (Block *b = block; b; b = b->next) {
+		assert(b->offset >= offset);
+		poison(b->data() + offset, b->offset - offset);
+		b->offset = offset;
+		if (b == _current)
+			break;
+		offset = 0;
+	}
+
+	_current = block;
+	_used = marker.used;
+}
+
+void Arena::reset() {
+	Marker start;
+	start.block = nullptr;
+	start.offset = 0;
+	start.used = 0;
+	rewind(start);
+}
+
+void Arena::freeMemory() {
+	Block *block = _first;
+	while (block) {
+		Block *next = block->next;
+		trackedFree(block);
+		block = next;
+	}
+
+	_first = _current = nullptr;
+	_used = 0;
+	_capacity = 0;
+}
+
+} // End of namespace Common
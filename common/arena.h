@@ -0,0 +1,186 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+class String;
+
+/**
+ * @defgroup common_arena Arena allocator
+ * @ingroup common_memory
+ *
+ * @brief Bump allocator for temporary data with a common lifetime.
+ * @{
+ */
+
+/**
+ * An arena hands out memory from big blocks by simply moving a pointer
+ * forward. Single allocations are never freed; instead, everything
+ * allocated after a marker is released at once by rewinding to it, or
+ * everything by resetting the arena. This suits data which lives for one
+ * frame or while loading a resource: allocating costs next to nothing and
+ * there is nothing to free one by one.
+ *
+ * The blocks are kept when rewinding, so an arena reused every frame stops
+ * allocating memory once it has grown large enough. When a block is full,
+ * another one is added to the arena, so allocations never fail.
+ *
+ * Destructors are not run by the arena: store only objects which don't need
+ * one, or destroy them manually before rewinding.
+ *
+ * In non-release builds, the released memory is filled with 0xDD, so that
+ * use of stale data stands out, and the high water mark of the arena is
+ * printed when it is destroyed (debug level 2).
+ */
+class Arena : NonCopyable {
+	struct Block;
+
+public:
+	/** A position in the arena, to rewind to later. */
+	struct Marker {
+		Block *block;
+		size_t offset;
+		size_t used;
+	};
+
+	enum {
+		/** The default size of the blocks. */
+		kDefaultBlockSize = 64 * 1024,
+		/** Alignment of allocations, which suits any basic type. */
+		kDefaultAlignment = 8
+	};
+
+	/**
+	 * Create an arena. No memory is allocated until the first allocation.
+	 *
+	 * @param blockSize	The size of the blocks allocated to hold the data.
+	 * @param name		Name of the arena, used in the debug output.
+	 */
+	explicit Arena(size_t blockSize = kDefaultBlockSize, const char *name = "arena");
+	~Arena();
+
+	/** Set the size of the blocks allocated from now on. */
+	void setBlockSize(size_t blockSize) { _blockSize = blockSize; }
+	/** Set the name of the arena, used in the debug output. */
+	void setName(const char *name) { _name = name; }
+
+	/**
+	 * Allocate @p size bytes, aligned to @p alignment, which must be a power
+	 * of two. The memory stays valid until the arena is rewound past it.
+	 */
+	void *allocate(size_t size, size_t alignment = kDefaultAlignment) {
+		if (_current) {
+			byte *const start = _current->data() + _current->offset;
+			const size_t padding = (0 - (uintptr)start) & (alignment - 1);
+			if (_current->offset + padding + size <= _current->size) {
+				_current->offset += padding + size;
+				_used += padding + size;
+				if (_used > _highWaterMark)
+					_highWaterMark = _used;
+				return start + padding;
+			}
+		}
+		return allocateSlow(size, alignment);
+	}
+
+	/**
+	 * Allocate an array of @p count default constructed objects. Their
+	 * destructors are never run by the arena.
+	 */
+	template<class T>
+	T *allocArray(size_t count) {
+		T *array = (T *)allocate(count * sizeof(T), alignof(T) > (size_t)kDefaultAlignment ? alignof(T) : (size_t)kDefaultAlignment);
+		for (size_t i = 0; i < count; ++i)
+			new ((void *)&array[i]) T();
+		return array;
+	}
+
+	/** Copy a zero-terminated string into the arena. */
+	char *copyString(const char *str);
+	/** Copy the contents of a String into the arena, as a zero-terminated string. */
+	char *copyString(const String &str);
+
+	/** Return the current position, to rewind to it later. */
+	Marker getMarker() const;
+
+	/** Release everything allocated since @p marker was taken. */
+	void rewind(const Marker &marker);
+
+	/** Release everything allocated so far, keeping the blocks for reuse. */
+	void reset();
+
+	/** Release everything and free all the blocks. */
+	void freeMemory();
+
+	/** Return the number of bytes currently allocated, including the alignment padding. */
+	size_t getUsedSize() const { return _used; }
+
+	/** Return the highest number of bytes allocated at the same time so far. */
+	size_t getHighWaterMark() const { return _highWaterMark; }
+
+	/** Return the total size of the blocks held by the arena. */
+	size_t getCapacity() const { return _capacity; }
+
+private:
+	struct Block {
+		Block *next;
+		size_t size;	///< Size of the data, following the header
+		size_t offset;	///< Bytes of the data in use
+
+		byte *data() { return (byte *)(this + 1); }
+	};
+
+	void *allocateSlow(size_t size, size_t alignment);
+	Block *allocBlock(size_t size);
+
+	Block *_first;
+	Block *_current;
+	size_t _blockSize;
+	size_t _used;
+	size_t _highWaterMark;
+	size_t _capacity;
+	const char *_name;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+/**
+ * A custom placement new operator, allocating from an Arena.
+ *
+ * As the arena never runs destructors, the objects must either not need
+ * one, or be destroyed manually before the arena is rewound.
+ */
+inline void *operator new(size_t nbytes, Common::Arena &arena) {
+	return arena.allocate(nbytes);
+}
+
+inline void operator delete(void *p, Common::Arena &arena) {
+}
+
+#endif
@@ -51,6 +51,8 @@ namespace Common {
  * for valueBits, isLE and isMSB2LSB, reads 32-bit little-endian values
  * from the data stream and hands out the bits in the order of LSB to MSB.
  */
+class BitStreamMemoryStream;
+
 template<class STREAM, typename CONTAINER, int valueBits, bool isLE, bool MSB2LSB>
 class BitStreamImpl {
 private:
@@ -86,6 +88,53 @@ private:
 
 	/** Fill the container with at least @p min bits. */
 	FORCEINLINE void fillContainer(size_t min) {
+		if (_bitsLeft < min)
+			refillContainer(min, _stream);
+	}
+
+	/** Refill the container from a generic stream, one data value at a time. */
+	FORCEINLINE void refillContainer(size_t min, SeekableReadStream *) {
+		readValues(min);
+	}
+
+	/**
+	 * Refill the container from memory.
+	 *
+	 * As many whole data values as fit are loaded into the container. When
+	 * the bit order follows the byte order, they are read with one unaligned
+	 * load instead of value by value.
+	 */
+	FORCEINLINE void refillContainer(size_t min, BitStreamMemoryStream *) {
+		const uint containerBits = sizeof(_bitContainer) * 8;
+		const uint bits = ((containerBits - _bitsLeft) / valueBits) * valueBits;
+		const bool wholeLoad = (valueBits == 8) || (isLE != MSB2LSB);
+
+		if (!wholeLoad || bits == 0 || _pos + _bitsLeft + bits > _size || _stream->pos() + containerBits / 8 > _stream->size()) {
+			readValues(MAX<size_t>(min, containerBits - valueBits + 1));
+			return;
+		}
+
+		CONTAINER data;
+		if (containerBits == 64)
+			data = MSB2LSB ? READ_BE_UINT64(_stream->getData()) : READ_LE_UINT64(_stream->getData());
+		else
+			data = MSB2LSB ? READ_BE_UINT32(_stream->getData()) : READ_LE_UINT32(_stream->getData());
+
+		if (MSB2LSB) {
+			data &= ~(CONTAINER)0 << (containerBits - bits);
+			_bitContainer |= data >> _bitsLeft;
+		} else {
+			if (bits < containerBits)
+				data &= ((CONTAINER)1 << bits) - 1;
+			_bitContainer |= data << _bitsLeft;
+		}
+
+		_stream->skip(bits / 8);
+		_bitsLeft += bits;
+	}
+
+	/** Read data values into the container until it holds at least @p min bits. */
+	FORCEINLINE void readValues(size_t min) {
 		while (_bitsLeft < min) {
 
 			CONTAINER data;
@@ -382,6 +431,19 @@ public:
 		return true;
 	}
 
+	/** Skip @p count bytes, which have to be within the data. */
+	void skip(uint32 count) {
+		assert(_pos + count <= _size);
+
+		_pos += count;
+		_ptr += count;
+	}
+
+	/** Return the data at the current position, for reading several values at once. */
+	const byte *getData() const {
+		return _ptr;
+	}
+
 	byte readByte() {
 		if (_pos >= _size) {
 			_eos = true;
@@ -422,7 +484,7 @@ public:
 			}
 		}
 
-		uint16 val = READ_LE_UINT16(_ptr);
+		uint16 val = READ_BE_UINT16(_ptr);
 
 		_pos += 2;
 		_ptr += 2;
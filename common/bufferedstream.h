@@ -66,6 +66,28 @@ ReadStream *wrapBufferedReadStream(ReadStream *parentStream, uint32 bufSize, Dis
  */
 SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
 
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream that
+ * transparently provides buffering adapted to the way it is read.
+ *
+ * The buffer starts with minBufSize bytes. As long as the stream is read
+ * sequentially, each refill reads twice as much as the previous one, up to
+ * maxBufSize bytes, and asks the wrapped stream to read the following block
+ * ahead (see SeekableReadStream::readAhead). A seek away from the buffered
+ * data brings the refills back to minBufSize bytes, so that random accesses
+ * do not read more than needed. Seeks back into the buffered data do not
+ * touch the wrapped stream.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @param parentStream        The SeekableReadStream to wrap in a custom stream.
+ * @param minBufSize          Size of the refills after a seek.
+ * @param maxBufSize          Size of the refills of sequential reads, at most.
+ * @param disposeParentStream Flag indicating whether to dispose of the wrapped stream.
+ */
+SeekableReadStream *wrapAdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 minBufSize, uint32 maxBufSize, DisposeAfterUse::Flag disposeParentStream);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream that
  * transparently provides buffering.
@@ -0,0 +1,517 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/endian.h"
+#include "common/hashmap.h"
+#include "common/math.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief An open addressing hash table storing its entries inline.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> maps objects of type Key to objects of type Val, like
+ * HashMap, and provides mostly the same interface.
+ *
+ * Unlike HashMap, the entries are stored directly in the table instead of
+ * separately allocated nodes. Next to the table, one control byte per slot
+ * records whether the slot is empty, erased or in use. Slots in use keep 7
+ * bits of the hash of their key. Lookups check the control bytes of a group
+ * of eight slots at once, and only compare the keys of which these bits
+ * match, so they rarely touch more than one cache line.
+ *
+ * As entries are stored inline, they move when the table grows. Unlike with
+ * HashMap, references to keys and values are only valid until the next
+ * insertion. Erasing entries doesn't move the others, so iterating over the
+ * map while erasing entries is fine.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+		FLATHASHMAP_GROUP_SIZE = 8,
+
+		// The table grows as soon as more than 7/8 of the slots are in
+		// use or erased.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	/** Control bytes of slots not in use. Used slots store 7 bits of the hash. */
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	Node *_slots;
+	byte *_ctrl;		///< One control byte per slot, stored right after the slots.
+	size_type _mask;	///< Capacity of the map minus one; the capacity is a power of two.
+	size_type _size;
+	size_type _deleted;	///< Number of erased slots, which still lengthen lookups.
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static bool isFull(byte ctrl) { return !(ctrl & 0x80); }
+
+	/**
+	 * Mix the bits of the hash, as many hash functions (e.g. the one of
+	 * integers) don't spread their values over all bits.
+	 */
+	static uint32 mixHash(uint32 hash) {
+		hash *= 0x9E3779B1;
+		return hash ^ (hash >> 15);
+	}
+
+	static byte ctrlFromHash(uint32 hash) { return hash >> 25; }
+
+	/**
+	 * @name Control byte groups
+	 * The control bytes of a group, read as one little endian word, are
+	 * matched against a value all at once. The matches are the top bits of
+	 * the matching bytes.
+	 * @{
+	 */
+	uint64 readGroup(size_type group) const { return READ_LE_UINT64(_ctrl + group * FLATHASHMAP_GROUP_SIZE); }
+
+	/** Match the bytes equal to @p ctrl. May include a few false positives. */
+	static uint64 matchCtrl(uint64 group, byte ctrl) {
+		const uint64 x = group ^ (ctrl * 0x0101010101010101ULL);
+		return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+	}
+
+	/** Match the empty slots, whose control bytes have bit 7 set and bit 1 clear. */
+	static uint64 matchEmpty(uint64 group) { return group & (~group << 6) & 0x8080808080808080ULL; }
+
+	static uint64 matchNotFull(uint64 group) { return group & 0x8080808080808080ULL; }
+
+	/** Index of the first match in a group. */
+	static size_type firstMatch(uint64 match) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(match) >> 3;
+#else
+		const uint32 low = (uint32)match;
+		if (low)
+			return intLog2(low & (0 - low)) >> 3;
+		const uint32 high = (uint32)(match >> 32);
+		return 4 + (intLog2(high & (0 - high)) >> 3);
+#endif
+	}
+	/** @} */
+
+	void allocStorage(size_type capacity) {
+		_mask = capacity - 1;
+		_slots = (Node *)malloc(capacity * (sizeof(Node) + 1));
+		assert(_slots != nullptr);
+		_ctrl = (byte *)(_slots + capacity);
+		memset(_ctrl, kCtrlEmpty, capacity);
+		_size = 0;
+		_deleted = 0;
+	}
+
+	void destroyNodes() {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_slots[ctr].~Node();
+		}
+	}
+
+	/** Find the slot of @p key, or return _mask + 1 if it isn't in the map. */
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	/** Find the first slot not in use on the probe sequence of @p hash. */
+	size_type findFreeSlot(uint32 hash) const;
+	void rehash(size_type newCapacity);
+	void eraseSlot(size_type ctr);
+	void assign(const FHM_t &map);
+
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isFull(_hashmap->_ctrl[_idx]));
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type firstFull() const {
+		size_type ctr = 0;
+		while (ctr <= _mask && !isFull(_ctrl[ctr]))
+			ctr++;
+		return ctr;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap() : _defaultVal() { allocStorage(FLATHASHMAP_MIN_CAPACITY); }
+	FlatHashMap(const FHM_t &map) : _defaultVal() { assign(map); }
+	~FlatHashMap() {
+		destroyNodes();
+		free(_slots);
+	}
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		destroyNodes();
+		free(_slots);
+		assign(map);
+		return *this;
+	}
+
+	/** Exchange the entries of this map with the ones of @p map, without copying them. */
+	void swap(FHM_t &map) {
+		SWAP(_slots, map._slots);
+		SWAP(_ctrl, map._ctrl);
+		SWAP(_mask, map._mask);
+		SWAP(_size, map._size);
+		SWAP(_deleted, map._deleted);
+	}
+
+	bool contains(const Key &key) const { return lookup(key) <= _mask; }
+
+	Val &operator[](const Key &key) { return getOrCreateVal(key); }
+	const Val &operator[](const Key &key) const { return getVal(key); }
+
+	Val &getOrCreateVal(const Key &key) {
+		// The lookup may reallocate the slots
+		const size_type ctr = lookupAndCreateIfMissing(key);
+		return _slots[ctr]._value;
+	}
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const { return getValOrDefault(key, _defaultVal); }
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val) { getOrCreateVal(key) = val; }
+
+	/**
+	 * Make room for @p count entries, so that adding them doesn't cause the
+	 * table to grow repeatedly.
+	 */
+	void reserve(size_type count);
+
+	void clear(bool shrinkArray = false);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	iterator begin() { return iterator(firstFull(), this); }
+	iterator end() { return iterator(_mask + 1, this); }
+	const_iterator begin() const { return const_iterator(firstFull(), this); }
+	const_iterator end() const { return const_iterator(_mask + 1, this); }
+
+	iterator find(const Key &key) { return iterator(lookup(key), this); }
+	const_iterator find(const Key &key) const { return const_iterator(lookup(key), this); }
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The slots can be copied one by one, including the erased ones, as
+	// the hash function doesn't change.
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			new (&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+inline typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 hash = mixHash(_hash(key));
+	const byte ctrl = ctrlFromHash(hash);
+	const size_type groupMask = _mask / FLATHASHMAP_GROUP_SIZE;
+
+	// Triangular probing visits every group of a table whose size is a
+	// power of two.
+	size_type group = hash & groupMask;
+	for (size_type step = 1; step <= groupMask + 1; ++step) {
+		const uint64 ctrls = readGroup(group);
+		for (uint64 match = matchCtrl(ctrls, ctrl); match; match &= match - 1) {
+			const size_type ctr = group * FLATHASHMAP_GROUP_SIZE + firstMatch(match);
+			if (_equal(_slots[ctr]._key, key))
+				return ctr;
+		}
+		// Keys are never stored past a group with empty slots
+		if (matchEmpty(ctrls))
+			break;
+		group = (group + step) & groupMask;
+	}
+
+	return _mask + 1;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(uint32 hash) const {
+	const size_type groupMask = _mask / FLATHASHMAP_GROUP_SIZE;
+	size_type group = hash & groupMask;
+	for (size_type step = 1; ; ++step) {
+		const uint64 match = matchNotFull(readGroup(group));
+		if (match)
+			return group * FLATHASHMAP_GROUP_SIZE + firstMatch(match);
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return ctr;
+
+	const uint32 hash = mixHash(_hash(key));
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == kCtrlDeleted) {
+		// Reuse the first erased slot on the way
+		_deleted--;
+	} else {
+		// Keep the load factor below a certain threshold. Erased slots are
+		// counted as well, as they lengthen the lookups just the same.
+		const size_type capacity = _mask + 1;
+		if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+			// Just get rid of the erased slots if there are many of them
+			rehash(_size * 2 < capacity ? capacity : capacity * 2);
+			ctr = findFreeSlot(hash);
+		}
+	}
+
+	new (&_slots[ctr]) Node(key);
+	_ctrl[ctr] = ctrlFromHash(hash);
+	_size++;
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	const size_type oldMask = _mask;
+	Node *oldSlots = _slots;
+	const byte *oldCtrl = _ctrl;
+#ifndef NDEBUG
+	const size_type oldSize = _size;
+#endif
+
+	allocStorage(newCapacity);
+
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!isFull(oldCtrl[ctr]))
+			continue;
+
+		// Keys are unique, so they don't need to be compared.
+		const uint32 hash = mixHash(_hash(oldSlots[ctr]._key));
+		const size_type idx = findFreeSlot(hash);
+		new (&_slots[idx]) Node(Common::move(oldSlots[ctr]));
+		_ctrl[idx] = ctrlFromHash(hash);
+		_size++;
+		oldSlots[ctr].~Node();
+	}
+
+	assert(_size == oldSize);
+	free(oldSlots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::reserve(size_type count) {
+	size_type capacity = _mask + 1;
+	while (count * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		capacity *= 2;
+	if (capacity > _mask + 1)
+		rehash(capacity);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	destroyNodes();
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		free(_slots);
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, kCtrlEmpty, _mask + 1);
+		_size = 0;
+		_deleted = 0;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type ctr) {
+	_slots[ctr].~Node();
+	_size--;
+
+	// Lookups stop at groups with empty slots. If the group already has one,
+	// no key was stored past it while the slot was in use, and the slot can
+	// be emptied as well.
+	if (matchEmpty(readGroup(ctr / FLATHASHMAP_GROUP_SIZE))) {
+		_ctrl[ctr] = kCtrlEmpty;
+	} else {
+		_ctrl[ctr] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isFull(_ctrl[ctr]));
+
+	eraseSlot(ctr);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	const size_type ctr = lookup(key);
+	if (ctr > _mask)
+		return;
+
+	eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -19,12 +19,20 @@
  *
  */
 
+// pthread.h includes time.h
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
 #include "common/system.h"
+#include "common/debug.h"
 #include "common/punycode.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
 #include "backends/fs/fs-factory.h"
 
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
+
 namespace Common {
 
 FSNode::FSNode() {
@@ -174,33 +182,136 @@ bool FSNode::createDirectory() const {
 	return _realNode->createDirectory();
 }
 
+#if defined(__GNUC__)
+static inline int atomicLoad(const int *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+static inline void atomicStore(int *value, int newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+#else
+static inline int atomicLoad(const int *value) { return *(const volatile int *)value; }
+static inline void atomicStore(int *value, int newValue) { *(volatile int *)value = newValue; }
+#endif
+
+/**
+ * Lists the whole tree of an FSDirectory on a worker thread.
+ *
+ * The reference counts of strings, paths and nodes are not thread-safe, so
+ * the worker thread is only given plain copies of the path of the directory
+ * and of its prefix, and it builds nodes and paths of its own from them. Its
+ * caches and warnings are only handed over once it has been joined.
+ */
+struct FSDirectory::Prefetch {
+	const FSDirectory *_directory;
+	char *_nodePath;
+	Array<char *> _prefixComponents;
+	NodeCache _fileCache, _subDirCache;
+	StringArray _warnings;
+	uint _listedDirCount;
+	int _done;
+	int _cancel;
+	bool _started;
+#ifdef USE_PTHREADS
+	pthread_t _thread;
+#endif
+
+	explicit Prefetch(const FSDirectory *directory)
+		: _directory(directory), _nodePath(scumm_strdup(directory->_node.getPath().c_str())), _listedDirCount(0),
+		  _done(0), _cancel(0), _started(false) {
+		const StringArray components = directory->_prefix.splitComponents();
+		for (uint i = 0; i < components.size(); ++i)
+			_prefixComponents.push_back(scumm_strdup(components[i].c_str()));
+	}
+
+	~Prefetch() {
+		::free(_nodePath);
+		for (uint i = 0; i < _prefixComponents.size(); ++i)
+			::free(_prefixComponents[i]);
+	}
+
+	void run() {
+		Path prefix;
+		for (uint i = 0; i < _prefixComponents.size(); ++i)
+			prefix = prefix.appendComponent(_prefixComponents[i]);
+
+		_directory->cacheDirectoryRecursive(FSNode(Path(_nodePath)), _directory->_depth, prefix,
+		                                    _fileCache, _subDirCache, _listedDirCount, this);
+		atomicStore(&_done, 1);
+	}
+
+	bool start() {
+#ifdef USE_PTHREADS
+		_started = !pthread_create(&_thread, nullptr, threadProc, this);
+#endif
+		return _started;
+	}
+
+	bool isDone() const {
+		return atomicLoad(&_done);
+	}
+
+	bool isCancelled() const {
+		return atomicLoad(&_cancel);
+	}
+
+	/**
+	 * Warn about a name clash. warning() may only be called from the main
+	 * thread, so the worker thread keeps its warnings until it is joined.
+	 */
+	static void warnClash(Prefetch *prefetch, const String &message) {
+		if (prefetch)
+			prefetch->_warnings.push_back(message);
+		else
+			warning("%s", message.c_str());
+	}
+
+	/** Wait for the worker thread to be done. Its caches are then usable. */
+	void stop() {
+		if (!_started)
+			return;
+#ifdef USE_PTHREADS
+		pthread_join(_thread, nullptr);
+#endif
+		_started = false;
+	}
+
+#ifdef USE_PTHREADS
+	static void *threadProc(void *prefetch) {
+		((Prefetch *)prefetch)->run();
+		return nullptr;
+	}
+#endif
+};
+
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _listedDirCount(0), _cachingTime(0), _prefetch(nullptr) {
 }
 
 FSDirectory::FSDirectory(const Path &prefix, const FSNode &node, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _listedDirCount(0), _cachingTime(0), _prefetch(nullptr) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::FSDirectory(const Path &name, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _listedDirCount(0), _cachingTime(0), _prefetch(nullptr) {
 }
 
 FSDirectory::FSDirectory(const Path &prefix, const Path &name, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _listedDirCount(0), _cachingTime(0), _prefetch(nullptr) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::~FSDirectory() {
+	if (_prefetch) {
+		atomicStore(&_prefetch->_cancel, 1);
+		_prefetch->stop();
+		delete _prefetch;
+	}
 }
 
 void FSDirectory::setPrefix(const Path &prefix) {
@@ -214,10 +325,18 @@ FSNode FSDirectory::getFSNode() const {
 FSNode *FSDirectory::lookupCache(NodeCache &cache, const Path &name) const {
 	// make caching as lazy as possible
 	if (!name.empty()) {
-		ensureCached();
-
-		if (cache.contains(name))
-			return &cache[name];
+		// Without prefix nor flattening, the cache entries of each directory
+		// only depend on the directories leading to it
+		if (_cached || adoptPrefetchedCache(false))
+			;
+		else if (!_flat && _prefix.empty())
+			cacheDirectoriesLeadingTo(name);
+		else
+			ensureCached();
+
+		NodeCache::iterator it = cache.find(name);
+		if (it != cache.end())
+			return &it->_value;
 	}
 
 	return nullptr;
@@ -278,12 +397,15 @@ FSDirectory *FSDirectory::getSubDirectory(const Path &prefix, const Path &name,
 	return new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
 }
 
-void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const {
-	if (depth <= 0)
+void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix,
+                                          NodeCache &fileCache, NodeCache &subDirCache, uint &listedDirs,
+                                          Prefetch *prefetch) const {
+	if (depth <= 0 || (prefetch && prefetch->isCancelled()))
 		return;
 
 	FSList list;
 	node.getChildren(list, FSNode::kListAll);
+	listedDirs++;
 
 	FSList::iterator it = list.begin();
 	for ( ; it != list.end(); ++it) {
@@ -291,40 +413,122 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& pr
 
 		// since the hashmap is case insensitive, we need to check for clashes when caching
 		if (it->isDirectory()) {
-			if (!_flat && _subDirCache.contains(name)) {
+			if (!_flat && subDirCache.contains(name)) {
 				// Always warn in this case as it's when there are 2 directories at the same place with different case
 				// That means a problem in user installation as lookups are always done case insensitive
-				warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'",
-				        Common::toPrintable(name.toString('/')).c_str());
+				Prefetch::warnClash(prefetch, String::format("FSDirectory::cacheDirectory: name clash when building cache, ignoring sub-directory '%s'",
+				                                             Common::toPrintable(name.toString('/')).c_str()));
 			} else {
-				if (_subDirCache.contains(name)) {
+				if (subDirCache.contains(name)) {
 					if (!_ignoreClashes) {
-						warning("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'",
-						        Common::toPrintable(name.toString('/')).c_str());
+						Prefetch::warnClash(prefetch, String::format("FSDirectory::cacheDirectory: name clash when building subDirCache with subdirectory '%s'",
+						                                             Common::toPrintable(name.toString('/')).c_str()));
 					}
 				}
-				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : name);
-				_subDirCache[name] = *it;
+				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : name, fileCache, subDirCache, listedDirs, prefetch);
+				subDirCache[name] = *it;
 			}
 		} else {
-			if (_fileCache.contains(name)) {
+			if (fileCache.contains(name)) {
 				if (!_ignoreClashes) {
-					warning("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'",
-					        Common::toPrintable(name.toString('/')).c_str());
+					Prefetch::warnClash(prefetch, String::format("FSDirectory::cacheDirectory: name clash when building cache, ignoring file '%s'",
+					                                             Common::toPrintable(name.toString('/')).c_str()));
 				}
 			} else {
-				_fileCache[name] = *it;
+				fileCache[name] = *it;
 			}
 		}
 	}
 
 }
 
+void FSDirectory::cacheDirectoriesLeadingTo(const Path &name) const {
+	// The file is in the directory made of all the components but the last
+	const StringArray components = name.splitComponents();
+	if (components.size() > (uint)MAX(_depth, 0))
+		return;
+
+	const uint64 start = g_system->getMicros();
+	const uint listedDirCount = _listedDirCount;
+
+	Path dir;
+	FSNode node = _node;
+	for (uint i = 0; ; ++i) {
+		if (!_listedDirs.contains(dir)) {
+			cacheDirectoryRecursive(node, 1, dir, _fileCache, _subDirCache, _listedDirCount);
+			_listedDirs[dir] = true;
+		}
+
+		if (i + 1 >= components.size())
+			break;
+
+		dir = dir.appendComponent(components[i]);
+		NodeCache::const_iterator it = _subDirCache.find(dir);
+		if (it == _subDirCache.end())
+			break;
+		node = it->_value;
+	}
+
+	if (_listedDirCount != listedDirCount)
+		_cachingTime += g_system->getMicros() - start;
+}
+
 void FSDirectory::ensureCached() const  {
-	if (_cached)
+	if (_cached || adoptPrefetchedCache(true))
 		return;
-	cacheDirectoryRecursive(_node, _depth, _prefix);
+
+	const uint64 start = g_system->getMicros();
+
+	// Start over rather than completing the directories listed on demand
+	_fileCache.clear();
+	_subDirCache.clear();
+	_listedDirs.clear();
+	cacheDirectoryRecursive(_node, _depth, _prefix, _fileCache, _subDirCache, _listedDirCount);
 	_cached = true;
+
+	_cachingTime += g_system->getMicros() - start;
+	debug(3, "FSDirectory: cached '%s', %u directories listed in %u ms",
+	      _node.getPath().c_str(), _listedDirCount, (uint)(_cachingTime / 1000));
+}
+
+void FSDirectory::prefetch() {
+#ifdef USE_PTHREADS
+	if (_cached || _prefetch || !_node.isDirectory())
+		return;
+
+	_prefetch = new Prefetch(this);
+	if (!_prefetch->start()) {
+		warning("FSDirectory::prefetch: Failed to start a thread, '%s' will be cached on demand", _node.getPath().c_str());
+		delete _prefetch;
+		_prefetch = nullptr;
+	}
+#endif
+}
+
+bool FSDirectory::adoptPrefetchedCache(bool wait) const {
+	if (!_prefetch || (!wait && !_prefetch->isDone()))
+		return false;
+
+	const uint64 start = g_system->getMicros();
+	_prefetch->stop();
+	if (wait)
+		_cachingTime += g_system->getMicros() - start;
+
+	for (uint i = 0; i < _prefetch->_warnings.size(); ++i)
+		warning("%s", _prefetch->_warnings[i].c_str());
+
+	_fileCache.swap(_prefetch->_fileCache);
+	_subDirCache.swap(_prefetch->_subDirCache);
+	_listedDirs.clear();
+	_listedDirCount += _prefetch->_listedDirCount;
+	_cached = true;
+
+	delete _prefetch;
+	_prefetch = nullptr;
+
+	debug(3, "FSDirectory: cached '%s' in the background, lookups spent %u ms listing directories",
+	      _node.getPath().c_str(), (uint)(_cachingTime / 1000));
+	return true;
 }
 
 int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const Path &pattern, bool matchPathComponents) const {
@@ -376,5 +580,24 @@ int FSDirectory::listMembers(ArchiveMemberList &list) const {
 	return files;
 }
 
+Archive::MemberPathListing FSDirectory::listMemberPaths(Array<Path> &paths) const {
+	if (!_node.isDirectory())
+		return kMemberPathsListed;
+
+	// A prefetch still running is used once it is done rather than waited for
+	if (_prefetch && !adoptPrefetchedCache(false))
+		return kMemberPathsNotListedYet;
+
+	// Listing the whole tree once lets all the lookups of a SearchSet use its
+	// index, rather than each of them asking this directory
+	ensureCached();
+
+	paths.reserve(paths.size() + _fileCache.size());
+	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it)
+		paths.push_back(it->_key);
+
+	return kMemberPathsListed;
+}
+
 
 } // End of namespace Common
@@ -24,6 +24,7 @@
 
 #include "common/array.h"
 #include "common/archive.h"
+#include "common/flathashmap.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
 #include "common/ptr.h"
@@ -296,6 +297,12 @@ public:
  * and using 'your' as a prefix, the cache entry would have been 'your/data/file.ext'.
  * This is done both in non-flat and flat mode.
  *
+ * The cache is filled on demand. In the default mode without prefix, looking
+ * a file up only lists the directories leading to it; otherwise, and when
+ * listing the members or the paths, as SearchSet does to index the directory,
+ * the whole tree is listed. Calling prefetch() lists the
+ * whole tree in the background, where the platform supports threads, so that
+ * it is ready when needed without delaying the first lookups.
  */
 class FSDirectory : public Archive {
 	FSNode _node;
@@ -309,19 +316,44 @@ class FSDirectory : public Archive {
 
 	// Caches are case insensitive, clashes are dealt with when creating
 	// Key is stored in lowercase.
-	typedef HashMap<Path, FSNode, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualsTo> NodeCache;
+	typedef FlatHashMap<Path, FSNode, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualsTo> NodeCache;
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable bool _cached;
 
+	// Directories listed so far while the cache is filled on demand,
+	// keyed by their path in the cache
+	typedef HashMap<Path, bool, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualsTo> DirectorySet;
+	mutable DirectorySet _listedDirs;
+
+	// Statistics on filling the cache
+	mutable uint _listedDirCount;
+	mutable uint64 _cachingTime;
+
+	// The background listing started by prefetch(), if any
+	struct Prefetch;
+	mutable Prefetch *_prefetch;
+
 	// look for a match
 	FSNode *lookupCache(NodeCache &cache, const Path &name) const;
 
 	// cache management
-	void cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const;
+	void cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix,
+	                             NodeCache &fileCache, NodeCache &subDirCache, uint &listedDirs,
+	                             Prefetch *prefetch = nullptr) const;
+
+	// list the directories leading to name, if not already cached
+	void cacheDirectoriesLeadingTo(const Path &name) const;
 
 	// fill cache if not already cached
 	void ensureCached() const;
 
+	// take the cache filled by prefetch(), once it is done if wait is false
+	bool adoptPrefetchedCache(bool wait) const;
+
+	// FSDirectory owns its background listing
+	FSDirectory(const FSDirectory &);
+	FSDirectory &operator=(const FSDirectory &);
+
 public:
 	/**
 	 * Create a FSDirectory representing a tree with the specified depth. Will result in an
@@ -355,6 +387,27 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * Start listing the whole tree on a worker thread, so that the cache is
+	 * complete once a lookup or listing needs it. Lookups made meanwhile fill
+	 * the cache on demand as usual. Does nothing on platforms without thread
+	 * support, or if the cache is already complete.
+	 */
+	void prefetch();
+
+	/**
+	 * Return the number of directories listed so far to fill the cache,
+	 * including the ones listed by prefetch() once its cache is used.
+	 */
+	uint getListedDirectoryCount() const { return _listedDirCount; }
+
+	/**
+	 * Return the time, in microseconds, which lookups and listings spent
+	 * listing directories or waiting for prefetch() to fill the cache. The
+	 * time prefetch() spent in the background is not included.
+	 */
+	uint64 getCachingTime() const { return _cachingTime; }
+
 	/**
 	 * Create a new FSDirectory pointing to a subdirectory of the instance.
 	 * @return A new FSDirectory instance.
@@ -385,6 +438,14 @@ public:
 	 */
 	int listMembers(ArchiveMemberList &list) const override;
 
+	/**
+	 * Add the paths of all the files, listing the whole tree if the cache
+	 * is not complete yet. SearchSet asks for them before its first lookup,
+	 * so that its lookups use its index. While a prefetch() is running,
+	 * return kMemberPathsNotListedYet instead of waiting for it.
+	 */
+	MemberPathListing listMemberPaths(Array<Path> &paths) const override;
+
 	/**
 	 * Get an ArchiveMember representation of the specified file. A full match of relative
 	 * path and file name is needed for success.
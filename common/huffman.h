@@ -54,6 +54,10 @@ inline uint32 REVERSEBITS(uint32 x) {
 /**
  * Huffman bit stream decoding.
  *
+ * Codes are resolved through a multi-level lookup table: a primary table
+ * indexed by the next few bits of the stream, and sub-tables for the
+ * codes that are longer than that. Each step of the decoding consumes
+ * up to a whole table's worth of bits, instead of one bit at a time.
  */
 template<class BITSTREAM>
 class Huffman {
@@ -65,40 +69,45 @@ public:
 	 *  @param codes     The actual codes.
 	 *  @param lengths   Lengths of the individual codes.
 	 *  @param symbols   The symbols. If 0, assume they are identical to the code indices.
+	 *  @param tableBits Number of bits resolved by the primary lookup table,
+	 *                   and at most by each sub-table.
 	 */
-	Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols = nullptr);
+	Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols = nullptr, uint8 tableBits = 8);
 
 	/** Return the next symbol in the bit stream. */
 	uint32 getSymbol(BITSTREAM &bits) const;
 
 private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
+	/** An entry of one of the lookup tables. */
+	struct TableEntry {
+		uint32 value;   ///< The symbol, or the offset of the sub-table.
+		uint8  length;  ///< Number of bits the entry consumes, 0xFF if no code starts with these bits.
+		uint8  subBits; ///< Number of bits indexing the sub-table, 0 for symbols.
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+		TableEntry() : value(0), length(0xFF), subBits(0) {}
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
+	/** All the lookup tables, starting with the primary one. */
+	Array<TableEntry> _table;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	uint8 _tableBits;
 
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
-		uint32 symbol;
-		uint8  length;
-
-		PrefixEntry() : length(0xFF) {}
+	/** The code description passed to the constructor, only valid while building the tables. */
+	struct CodeSet {
+		const uint32 *codes;
+		const uint8 *lengths;
+		const uint32 *symbols;
 	};
 
-	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	/** Return the table index for the given bits, written MSB first. */
+	static uint32 tableIndex(uint32 bits, uint8 count);
+
+	/** Fill the table at offset with the given codes, all sharing their first consumed bits. */
+	void buildTable(const CodeSet &codeSet, uint32 offset, uint8 bits, uint8 consumed, const uint32 *codeIndices, uint32 count);
 };
 
 template <class BITSTREAM>
-Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols) {
+Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols, uint8 tableBits) {
 	assert(codeCount > 0);
 
 	assert(codes);
@@ -109,63 +118,131 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 			maxLength = MAX(maxLength, lengths[i]);
 
 	assert(maxLength <= 32);
+	assert(tableBits > 0 && tableBits <= 16);
 
-	// Codes that do not fit in the prefix table are stored in the _codes array.
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	// No need for the primary table to be wider than the longest code
+	_tableBits = MIN(tableBits, MAX<uint8>(maxLength, 1));
 
-	for (uint i = 0; i < codeCount; i++) {
-		uint8 length = lengths[i];
+	CodeSet codeSet;
+	codeSet.codes = codes;
+	codeSet.lengths = lengths;
+	codeSet.symbols = symbols;
 
-		// The symbol. If none was specified, assume it is identical to the code index.
-		uint32 symbol = symbols ? symbols[i] : i;
+	Array<uint32> codeIndices;
+	codeIndices.resize(codeCount);
+	for (uint32 i = 0; i < codeCount; i++)
+		codeIndices[i] = i;
 
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
+	_table.resize(1 << _tableBits);
+	buildTable(codeSet, 0, _tableBits, 0, codeIndices.begin(), codeCount);
+}
+
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::tableIndex(uint32 bits, uint8 count) {
+	if (BITSTREAM::isMSB2LSB())
+		return bits;
+
+	// The first bit of the code is the lowest one in LSB streams
+	return REVERSEBITS(bits) >> (32 - count);
+}
 
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::buildTable(const CodeSet &codeSet, uint32 offset, uint8 bits, uint8 consumed, const uint32 *codeIndices, uint32 count) {
+	const uint32 tableSize = 1 << bits;
+
+	// Bucket the codes that do not fit in this table by their bits for
+	// this table, remembering the longest remainder of each bucket.
+	Array<uint32> bucketStart;
+	Array<uint8> bucketLength;
+	bucketStart.resize(tableSize + 1);
+	bucketLength.resize(tableSize);
+
+	for (uint32 i = 0; i <= tableSize; i++)
+		bucketStart[i] = 0;
+	for (uint32 i = 0; i < tableSize; i++)
+		bucketLength[i] = 0;
+
+	for (uint32 i = 0; i < count; i++) {
+		uint32 index = codeIndices[i];
+		uint8 remaining = codeSet.lengths[index] - consumed;
+
+		if (codeSet.lengths[index] == 0)
+			continue;
+
+		if (remaining <= bits) {
+			// The code ends in this table. Set all the entries in the table
+			// starting with the rest of the code to the symbol value.
+			uint32 code = codeSet.codes[index] & ((1 << remaining) - 1);
+			uint32 startIndex = code << (bits - remaining);
+			uint32 endIndex = startIndex | ((1 << (bits - remaining)) - 1);
 
 			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
+				TableEntry &entry = _table[offset + tableIndex(j, bits)];
+				entry.value = codeSet.symbols ? codeSet.symbols[index] : index;
+				entry.length = remaining;
+				entry.subBits = 0;
 			}
 		} else {
-			// Put the code and symbol into the correct list for the length.
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
+			uint32 prefix = (codeSet.codes[index] >> (remaining - bits)) & (tableSize - 1);
+
+			bucketStart[prefix + 1]++;
+			bucketLength[prefix] = MAX<uint8>(bucketLength[prefix], remaining - bits);
 		}
 	}
-}
 
-template <class BITSTREAM>
-uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
+	for (uint32 i = 0; i < tableSize; i++)
+		bucketStart[i + 1] += bucketStart[i];
 
-	uint8 length = _prefixTable[code].length;
+	if (bucketStart[tableSize] == 0)
+		return;
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+	Array<uint32> bucketed;
+	Array<uint32> bucketFill(bucketStart.begin(), tableSize);
+	bucketed.resize(bucketStart[tableSize]);
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+	for (uint32 i = 0; i < count; i++) {
+		uint32 index = codeIndices[i];
+		uint8 remaining = codeSet.lengths[index] - consumed;
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
-		}
+		if (codeSet.lengths[index] == 0 || remaining <= bits)
+			continue;
+
+		uint32 prefix = (codeSet.codes[index] >> (remaining - bits)) & (tableSize - 1);
+		bucketed[bucketFill[prefix]++] = index;
 	}
 
-	error("Unknown Huffman code");
-	return 0;
+	// Give every bucket a sub-table for the bits after this table
+	for (uint32 prefix = 0; prefix < tableSize; prefix++) {
+		if (bucketLength[prefix] == 0)
+			continue;
+
+		uint8 subBits = MIN(bucketLength[prefix], _tableBits);
+		uint32 subOffset = _table.size();
+		_table.resize(subOffset + (1 << subBits));
+
+		TableEntry &entry = _table[offset + tableIndex(prefix, bits)];
+		entry.value = subOffset;
+		entry.length = bits;
+		entry.subBits = subBits;
+
+		buildTable(codeSet, subOffset, subBits, consumed + bits, &bucketed[bucketStart[prefix]], bucketStart[prefix + 1] - bucketStart[prefix]);
+	}
+}
+
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
+	const TableEntry *entry = &_table[bits.peekBits(_tableBits)];
+
+	while (entry->subBits != 0) {
+		bits.skip(entry->length);
+		entry = &_table[entry->value + bits.peekBits(entry->subBits)];
+	}
+
+	if (entry->length == 0xFF)
+		error("Unknown Huffman code");
+
+	bits.skip(entry->length);
+	return entry->value;
 }
 
 /** @} */
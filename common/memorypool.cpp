@@ -20,6 +20,7 @@
  */
 
 #include "common/memorypool.h"
+#include "common/memtrack.h"
 #include "common/util.h"
 
 namespace Common {
@@ -55,7 +56,7 @@ MemoryPool::~MemoryPool() {
 #endif
 
 	for (size_t i = 0; i < _pages.size(); ++i)
-		::free(_pages[i].start);
+		Common::trackedFree(_pages[i].start);
 }
 
 void MemoryPool::allocPage() {
@@ -65,7 +66,7 @@ void MemoryPool::allocPage() {
 	page.numChunks = _chunksPerPage;
 	assert(page.numChunks * _chunkSize < 16*1024*1024); // Refuse to allocate pages bigger than 16 MB
 
-	page.start = ::malloc(page.numChunks * _chunkSize);
+	page.start = Common::trackedMalloc(page.numChunks * _chunkSize);
 	assert(page.start);
 	_pages.push_back(page);
 
@@ -151,7 +152,7 @@ void MemoryPool::freeUnusedPages() {
 					iter2 = *(void ***)iter2;
 			}
 
-			::free(_pages[i].start);
+			Common::trackedFree(_pages[i].start);
 			++freedPagesCount;
 			_pages[i].start = nullptr;
 		}
@@ -0,0 +1,236 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/memtrack.h"
+
+#ifdef ENABLE_MEMORY_TRACKING
+
+#include "common/str.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+namespace {
+
+/**
+ * Header stored in front of every tracked allocation, so that freeing it
+ * credits the right tag. Its size keeps the data aligned for any basic type.
+ */
+struct AllocationHeader {
+	uint64 size;
+	uint32 tag;
+	uint32 magic;
+};
+
+enum {
+	kAllocationMagic = 0x4D454D54 // 'MEMT'
+};
+
+struct MemoryTag {
+	char name[kMaxMemoryTagLength + 1];
+	size_t liveBytes;
+	size_t peakBytes;
+	uint32 liveAllocations;
+	uint32 totalAllocations;
+};
+
+// The tags are plain data, so that they are usable by the allocations made
+// by static constructors, before any constructor of this file would run.
+MemoryTag g_memoryTags[kMaxMemoryTags];
+uint g_memoryTagCount = 0;
+
+// Each thread has its own current tag, so that e.g. the audio thread doesn't
+// account its allocations to the tag of the main thread.
+thread_local uint g_currentMemoryTag = 0;
+
+// The counters and the tag list are shared by all threads. Without atomic
+// operations, the counts may be off when several threads allocate at once.
+#if defined(__GNUC__)
+int g_memoryTagLock = 0;
+
+template<class T>
+inline T atomicAdd(T *value, T delta) { return __atomic_add_fetch(value, delta, __ATOMIC_RELAXED); }
+template<class T>
+inline void atomicMax(T *value, T candidate) {
+	T current = __atomic_load_n(value, __ATOMIC_RELAXED);
+	while (candidate > current && !__atomic_compare_exchange_n(value, &current, candidate, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+inline uint atomicLoad(const uint *value) { return __atomic_load_n(value, __ATOMIC_RELAXED); }
+inline void atomicStore(uint *value, uint newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELAXED); }
+inline void lockMemoryTags() { while (__atomic_exchange_n(&g_memoryTagLock, 1, __ATOMIC_ACQUIRE)) {} }
+inline void unlockMemoryTags() { __atomic_store_n(&g_memoryTagLock, 0, __ATOMIC_RELEASE); }
+#else
+template<class T>
+inline T atomicAdd(T *value, T delta) { return *value += delta; }
+template<class T>
+inline void atomicMax(T *value, T candidate) { if (candidate > *value) *value = candidate; }
+inline uint atomicLoad(const uint *value) { return *value; }
+inline void atomicStore(uint *value, uint newValue) { *value = newValue; }
+inline void lockMemoryTags() {}
+inline void unlockMemoryTags() {}
+#endif
+
+uint findMemoryTag(const char *name) {
+	lockMemoryTags();
+
+	if (!g_memoryTagCount) {
+		Common::strlcpy(g_memoryTags[0].name, "untagged", sizeof(g_memoryTags[0].name));
+		g_memoryTagCount = 1;
+	}
+
+	uint tag = 0;
+	while (tag < g_memoryTagCount && strncmp(g_memoryTags[tag].name, name, kMaxMemoryTagLength))
+		tag++;
+
+	if (tag == g_memoryTagCount) {
+		if (g_memoryTagCount < kMaxMemoryTags) {
+			Common::strlcpy(g_memoryTags[tag].name, name, sizeof(g_memoryTags[tag].name));
+			g_memoryTagCount++;
+		} else {
+			tag = 0;
+		}
+	}
+
+	unlockMemoryTags();
+	return tag;
+}
+
+} // End of anonymous namespace
+
+void *trackedMalloc(size_t size) {
+	AllocationHeader *header = (AllocationHeader *)malloc(sizeof(AllocationHeader) + size);
+	if (!header)
+		return nullptr;
+
+	const uint tagIndex = g_currentMemoryTag;
+	header->size = size;
+	header->tag = tagIndex;
+	header->magic = kAllocationMagic;
+
+	MemoryTag &tag = g_memoryTags[tagIndex];
+	atomicMax<size_t>(&tag.peakBytes, atomicAdd<size_t>(&tag.liveBytes, size));
+	atomicAdd<uint32>(&tag.liveAllocations, 1);
+	atomicAdd<uint32>(&tag.totalAllocations, 1);
+
+	return header + 1;
+}
+
+void trackedFree(void *ptr) {
+	if (!ptr)
+		return;
+
+	AllocationHeader *header = (AllocationHeader *)ptr - 1;
+	assert(header->magic == kAllocationMagic);
+	header->magic = 0;
+
+	MemoryTag &tag = g_memoryTags[header->tag];
+	atomicAdd<size_t>(&tag.liveBytes, 0 - (size_t)header->size);
+	atomicAdd<uint32>(&tag.liveAllocations, (uint32)-1);
+
+	free(header);
+}
+
+uint getMemoryTagCount() {
+	return MAX<uint>(g_memoryTagCount, 1);
+}
+
+MemoryTagStats getMemoryTagStats(uint tagIndex) {
+	assert(tagIndex < getMemoryTagCount());
+	const MemoryTag &tag = g_memoryTags[tagIndex];
+
+	MemoryTagStats stats;
+	stats.name = tagIndex ? tag.name : "untagged";
+	stats.liveBytes = tag.liveBytes;
+	stats.peakBytes = tag.peakBytes;
+	stats.liveAllocations = tag.liveAllocations;
+	stats.totalAllocations = tag.totalAllocations;
+	return stats;
+}
+
+String formatMemoryTagStats() {
+	String result = String::format("%-32s %12s %12s %10s %10s\n", "Tag", "Live bytes", "Peak bytes", "Live", "Allocs");
+	for (uint i = 0; i < getMemoryTagCount(); ++i) {
+		const MemoryTagStats stats = getMemoryTagStats(i);
+		result += String::format("%-32s %12u %12u %10u %10u\n", stats.name, (uint)stats.liveBytes,
+		                         (uint)stats.peakBytes, stats.liveAllocations, stats.totalAllocations);
+	}
+	return result;
+}
+
+MemoryTagScope::MemoryTagScope(const char *tag) : _previousTag(g_currentMemoryTag) {
+	g_currentMemoryTag = findMemoryTag(tag);
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTagRef &tag) : _previousTag(g_currentMemoryTag) {
+	// Threads looking the tag up at once all find the same index
+	uint index = atomicLoad(&tag.index);
+	if (!index) {
+		index = findMemoryTag(tag.name) + 1;
+		atomicStore(&tag.index, index);
+	}
+	g_currentMemoryTag = index - 1;
+}
+
+MemoryTagScope::~MemoryTagScope() {
+	g_currentMemoryTag = _previousTag;
+}
+
+} // End of namespace Common
+
+// Account every allocation made with operator new
+
+void *operator new(size_t size) {
+	void *ptr = Common::trackedMalloc(size);
+	if (!ptr)
+		::error("Out of memory: couldn't allocate %u bytes", (uint)size);
+	return ptr;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+	return Common::trackedMalloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+	return Common::trackedMalloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+	Common::trackedFree(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	Common::trackedFree(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	Common::trackedFree(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+	Common::trackedFree(ptr);
+}
+
+#endif
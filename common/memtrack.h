@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_MEMTRACK_H
+#define COMMON_MEMTRACK_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_memtrack Memory tracking
+ * @ingroup common_memory
+ *
+ * @brief Accounting of the memory allocated by each subsystem.
+ *
+ * When ScummVM is configured with --enable-memory-tracking, every
+ * allocation made with operator new, by a MemoryPool or by an Arena is
+ * attributed to a tag, like "engine:sci" or "audio/mixer". The tag is
+ * selected with MEMORY_TAG_SCOPE for the current thread; allocations made
+ * outside of any scope are counted as "untagged". MEMORY_TAG_SCOPE looks its
+ * tag up only once, so it can be used in code run often, like audio
+ * callbacks; tags built at run time are selected with
+ * MEMORY_DYNAMIC_TAG_SCOPE instead. The live bytes, peak
+ * bytes and allocation counts of every tag can be shown with the "memory"
+ * debugger command, and are printed when ScummVM exits, where the bytes
+ * still live are leaks.
+ *
+ * Without that option, the scope macros expand to nothing and
+ * trackedMalloc/trackedFree are plain malloc/free.
+ * @{
+ */
+
+#ifdef ENABLE_MEMORY_TRACKING
+
+class String;
+
+enum {
+	/** Maximum number of tags, further tags are counted as "untagged". */
+	kMaxMemoryTags = 64,
+	/** Maximum length of the tag names, longer names are cut. */
+	kMaxMemoryTagLength = 47
+};
+
+struct MemoryTagStats {
+	const char *name;
+	size_t liveBytes;		///< Bytes currently allocated
+	size_t peakBytes;		///< Highest number of bytes allocated at once
+	uint32 liveAllocations;	///< Number of allocations not freed yet
+	uint32 totalAllocations;	///< Number of allocations made so far
+};
+
+/** Allocate memory, accounted to the current tag. */
+void *trackedMalloc(size_t size);
+/** Free memory allocated with trackedMalloc. */
+void trackedFree(void *ptr);
+
+/** Return the number of tags used so far, including "untagged". */
+uint getMemoryTagCount();
+/** Return the statistics of the tag with index @p tag. */
+MemoryTagStats getMemoryTagStats(uint tag);
+/** Format the statistics of all tags as a table, one line per tag. */
+String formatMemoryTagStats();
+
+/**
+ * A tag named by a string constant, looked up on first use. It is plain
+ * data, so that a static instance needs no guarded initialization.
+ */
+struct MemoryTagRef {
+	const char *name;
+	uint index;	///< Index of the tag plus one, 0 until looked up
+};
+
+/**
+ * Account the allocations made by the current thread to a tag, until the
+ * scope is left. Scopes can be nested, the innermost one wins.
+ */
+class MemoryTagScope : NonCopyable {
+public:
+	/** Select the tag named @p tag, looking it up among all the tags. */
+	explicit MemoryTagScope(const char *tag);
+	/** Select the given tag, looking it up only the first time. */
+	explicit MemoryTagScope(MemoryTagRef &tag);
+	~MemoryTagScope();
+
+private:
+	uint _previousTag;
+};
+
+#define MEMORY_TAG_SCOPE(tag) \
+	static Common::MemoryTagRef SCUMMVM_CONCAT(memoryTag, __LINE__) = { tag, 0 }; \
+	Common::MemoryTagScope SCUMMVM_CONCAT(memoryTagScope, __LINE__)(SCUMMVM_CONCAT(memoryTag, __LINE__))
+
+#define MEMORY_DYNAMIC_TAG_SCOPE(tag) Common::MemoryTagScope SCUMMVM_CONCAT(memoryTagScope, __LINE__)(tag)
+
+#else
+
+inline void *trackedMalloc(size_t size) { return malloc(size); }
+inline void trackedFree(void *ptr) { free(ptr); }
+
+#define MEMORY_TAG_SCOPE(tag) do {} while (false)
+#define MEMORY_DYNAMIC_TAG_SCOPE(tag) do {} while (false)
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -2,6 +2,7 @@ MODULE := common
 
 MODULE_OBJS := \
 	archive.o \
+	arena.o \
 	concatstream.o \
 	config-manager.o \
 	coroutines.o \
@@ -16,11 +17,13 @@ MODULE_OBJS := \
 	localization.o \
 	macresman.o \
 	memorypool.o \
+	memtrack.o \
 	md5.o \
 	mutex.o \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
+	profiler.o \
 	punycode.o \
 	random.o \
 	rational.o \
@@ -31,15 +31,15 @@ const char *SLASH_ESCAPED = "/+";
 
 namespace Common {
 
-Path::Path(const Path &path) {
-	_str = path._str;
+Path::Path(const Path &path) : _str(path._str), _identifierHash(path._identifierHash),
+	_hasIdentifierHash(path._hasIdentifierHash), _isOwnIdentifier(path._isOwnIdentifier) {
 }
 
-Path::Path(const char *str, char separator) {
+Path::Path(const char *str, char separator) : _identifierHash(0), _hasIdentifierHash(false), _isOwnIdentifier(false) {
 	set(str, separator);
 }
 
-Path::Path(const String &str, char separator) {
+Path::Path(const String &str, char separator) : _identifierHash(0), _hasIdentifierHash(false), _isOwnIdentifier(false) {
 	set(str.c_str(), separator);
 }
 
@@ -142,6 +142,9 @@ bool Path::empty() const {
 
 Path &Path::operator=(const Path &path) {
 	_str = path._str;
+	_identifierHash = path._identifierHash;
+	_hasIdentifierHash = path._hasIdentifierHash;
+	_isOwnIdentifier = path._isOwnIdentifier;
 	return *this;
 }
 
@@ -157,11 +160,13 @@ Path &Path::operator=(const String &str) {
 
 void Path::set(const char *str, char separator) {
 	_str.clear();
+	_hasIdentifierHash = false;
 	appendInPlace(str, separator);
 }
 
 Path &Path::appendInPlace(const Path &x) {
 	_str += x._str;
+	_hasIdentifierHash = false;
 	return *this;
 }
 
@@ -171,6 +176,7 @@ Path &Path::appendInPlace(const String &str, char separator) {
 }
 
 Path &Path::appendInPlace(const char *str, char separator) {
+	_hasIdentifierHash = false;
 	for (; *str; str++) {
 		if (*str == separator)
 			_str += DIR_SEPARATOR;
@@ -207,6 +213,7 @@ Path &Path::joinInPlace(const Path &x) {
 		_str += DIR_SEPARATOR;
 
 	_str += x._str;
+	_hasIdentifierHash = false;
 
 	return *this;
 }
@@ -222,6 +229,7 @@ Path &Path::joinInPlace(const char *str, char separator) {
 	size_t lastSep = findLastSeparator();
 	if (!_str.empty() && (lastSep == String::npos || lastSep != _str.size() - 2) && *str != separator)
 		_str += DIR_SEPARATOR;
+	_hasIdentifierHash = false;
 
 	appendInPlace(str, separator);
 
@@ -320,6 +328,9 @@ static String getIdentifierComponent(const String& in) {
 // HFS(+) image will end up with : independently of how
 // it was dumped or copied from
 String Path::getIdentifierString() const {
+	if (_hasIdentifierHash ? _isOwnIdentifier : computeIsOwnIdentifier())
+		return _str;
+
 	StringArray c = splitComponents();
 	String res;
 
@@ -363,12 +374,40 @@ bool Path::matchPattern(const Path& pattern) const {
 	return true;
 }
 
+// Most paths are plain ASCII without any punycode or escaped slash, their
+// identifier is the path itself
+bool Path::computeIsOwnIdentifier() const {
+	if (_str.contains("xn--") || _str.contains(SLASH_ESCAPED))
+		return false;
+	for (uint i = 0; i < _str.size(); i++) {
+		if (_str[i] & 0x80)
+			return false;
+	}
+	return true;
+}
+
+uint Path::getIdentifierHash() const {
+	if (!_hasIdentifierHash) {
+		_isOwnIdentifier = computeIsOwnIdentifier();
+		_identifierHash = hashit_lower(_isOwnIdentifier ? _str.c_str() : getIdentifierString().c_str());
+		_hasIdentifierHash = true;
+	}
+	return _identifierHash;
+}
+
 bool Path::IgnoreCaseAndMac_EqualsTo::operator()(const Path& x, const Path& y) const {
+	if (x.getIdentifierHash() != y.getIdentifierHash())
+		return false;
+
+	// The identifiers are only built when the hashes match, that is mostly
+	// when the paths are equal, and not at all for plain paths
+	if (x._isOwnIdentifier && y._isOwnIdentifier)
+		return x._str.equalsIgnoreCase(y._str);
 	return x.getIdentifierString().equalsIgnoreCase(y.getIdentifierString());
 }
 
 uint Path::IgnoreCaseAndMac_Hash::operator()(const Path& x) const {
-	return hashit_lower(x.getIdentifierString().c_str());
+	return x.getIdentifierHash();
 }
 
 } // End of namespace Common
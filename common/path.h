@@ -43,12 +43,26 @@ namespace Common {
  * 
  * Internally, this is just a simple wrapper around a String, using
  * "//" (unit separator) as a directory separator and "/+" as "/".
+ *
+ * The hash used by IgnoreCaseAndMac_Hash and IgnoreCaseAndMac_EqualsTo is
+ * computed on first use and kept along with the path, so that looking a
+ * path up in several archives hashes it only once. As this changes the
+ * path, a path shared by several threads should be hashed before it is
+ * shared.
  */
 class Path {
 private:
 	String _str;
 
+	// Hash of the lowercase identifier string, and whether that string is
+	// the path itself, valid if _hasIdentifierHash is set
+	mutable uint _identifierHash;
+	mutable bool _hasIdentifierHash;
+	mutable bool _isOwnIdentifier;
+
+	bool computeIsOwnIdentifier() const;
 	String getIdentifierString() const;
+	uint getIdentifierHash() const;
 	size_t findLastSeparator(size_t last = String::npos) const;
 
 public:
@@ -70,7 +84,7 @@ public:
 	};
 
 	/** Construct a new empty path. */
-	Path() {}
+	Path() : _identifierHash(0), _hasIdentifierHash(false), _isOwnIdentifier(false) {}
 
 	/** Construct a copy of the given path. */
 	Path(const Path &path);
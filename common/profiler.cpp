@@ -0,0 +1,240 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include "common/str.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+bool gProfilingActive = false;
+
+namespace {
+
+enum {
+	/** Number of zones each thread can record, further zones are dropped. */
+	kZonesPerThread = 64 * 1024
+};
+
+struct Zone {
+	const char *name;
+	const char *argName;
+	int64 argValue;
+	uint64 start;
+	uint64 duration;
+};
+
+/**
+ * The zones recorded by one thread. Only the thread itself writes to its
+ * buffer, including clearing it when profiling was started again; the
+ * count is published after the zone has been written, so that the zones
+ * below it can be read from any thread. A buffer holds the zones of the
+ * current profiling run only if its generation is the current one.
+ */
+struct ThreadBuffer {
+	ThreadBuffer *next;
+	uint threadId;
+	const char *threadName;
+	uint generation;
+	uint count;
+	uint dropped;
+	Zone zones[kZonesPerThread];
+};
+
+#if defined(__GNUC__)
+template<class T>
+inline T atomicLoad(T *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+template<class T>
+inline void atomicStore(T *value, T newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+inline uint atomicIncrement(uint *value) { return __atomic_add_fetch(value, 1, __ATOMIC_RELAXED); }
+inline bool pushBuffer(ThreadBuffer **head, ThreadBuffer *buffer) {
+	buffer->next = __atomic_load_n(head, __ATOMIC_RELAXED);
+	return __atomic_compare_exchange_n(head, &buffer->next, buffer, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+#else
+template<class T>
+inline T atomicLoad(T *value) { return *(volatile T *)value; }
+template<class T>
+inline void atomicStore(T *value, T newValue) { *(volatile T *)value = newValue; }
+inline uint atomicIncrement(uint *value) { return ++*value; }
+inline bool pushBuffer(ThreadBuffer **head, ThreadBuffer *buffer) {
+	buffer->next = *head;
+	*head = buffer;
+	return true;
+}
+#endif
+
+/** All the thread buffers, newest first. They are kept until exit. */
+ThreadBuffer *g_threadBuffers = nullptr;
+uint g_threadCount = 0;
+
+/** Incremented each time profiling is started. */
+uint g_profilingGeneration = 0;
+/** When profiling was started. Only used by the main thread. */
+uint64 g_profilingStart = 0;
+
+thread_local ThreadBuffer *t_threadBuffer = nullptr;
+thread_local const char *t_threadName = nullptr;
+
+ThreadBuffer *getThreadBuffer() {
+	if (!t_threadBuffer) {
+		ThreadBuffer *buffer = new ThreadBuffer();
+		buffer->threadName = t_threadName;
+		buffer->generation = 0;
+		buffer->count = 0;
+		buffer->dropped = 0;
+		buffer->threadId = atomicIncrement(&g_threadCount);
+		while (!pushBuffer(&g_threadBuffers, buffer)) {}
+		t_threadBuffer = buffer;
+	}
+	return t_threadBuffer;
+}
+
+/** Return the number of zones of @p buffer recorded in the current profiling run. */
+uint getZoneCount(ThreadBuffer *buffer) {
+	if (atomicLoad(&buffer->generation) != atomicLoad(&g_profilingGeneration))
+		return 0;
+	return atomicLoad(&buffer->count);
+}
+
+void writeEscaped(WriteStream &stream, const char *str) {
+	for (; *str; ++str) {
+		if (*str == '"' || *str == '\\')
+			stream.writeByte('\\');
+		stream.writeByte(*str);
+	}
+}
+
+} // End of anonymous namespace
+
+void startProfiling() {
+	// The buffers of the threads are cleared by the threads themselves, when
+	// they record their next zone
+	g_profilingStart = g_system->getMicros();
+	atomicStore(&g_profilingGeneration, g_profilingGeneration + 1);
+	atomicStore(&gProfilingActive, true);
+}
+
+void stopProfiling() {
+	atomicStore(&gProfilingActive, false);
+}
+
+uint getProfilingZoneCount() {
+	uint count = 0;
+	for (ThreadBuffer *buffer = atomicLoad(&g_threadBuffers); buffer; buffer = buffer->next)
+		count += getZoneCount(buffer);
+	return count;
+}
+
+void setProfilingThreadName(const char *name) {
+	t_threadName = name;
+	if (t_threadBuffer)
+		t_threadBuffer->threadName = name;
+}
+
+bool writeProfilingTrace(WriteStream &stream) {
+	stream.writeString("{\"traceEvents\":[\n");
+
+	bool first = true;
+	for (ThreadBuffer *buffer = atomicLoad(&g_threadBuffers); buffer; buffer = buffer->next) {
+		const uint count = getZoneCount(buffer);
+
+		if (!first)
+			stream.writeString(",\n");
+		first = false;
+
+		// Name the thread in the viewer
+		stream.writeString(String::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", buffer->threadId));
+		if (buffer->threadName)
+			writeEscaped(stream, buffer->threadName);
+		else
+			stream.writeString(String::format("thread %u", buffer->threadId));
+		stream.writeString("\"}}");
+
+		for (uint i = 0; i < count; ++i) {
+			const Zone &zone = buffer->zones[i];
+			stream.writeString(",\n{\"name\":\"");
+			writeEscaped(stream, zone.name);
+			stream.writeString(String::format("\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu",
+			                                  buffer->threadId, (unsigned long long)(zone.start - g_profilingStart),
+			                                  (unsigned long long)zone.duration));
+			if (zone.argName) {
+				stream.writeString(",\"args\":{\"");
+				writeEscaped(stream, zone.argName);
+				stream.writeString(String::format("\":%lld}", (long long)zone.argValue));
+			}
+			stream.writeString("}");
+		}
+
+		if (count && atomicLoad(&buffer->dropped))
+			warning("Profiler: %u zones of thread %u were dropped, as its buffer was full", buffer->dropped, buffer->threadId);
+	}
+
+	stream.writeString("\n],\"displayTimeUnit\":\"ms\"}\n");
+	return !stream.err();
+}
+
+void ProfilingZone::begin(const char *name, const char *argName, int64 argValue) {
+	_name = name;
+	_argName = argName;
+	_argValue = argValue;
+	_generation = atomicLoad(&g_profilingGeneration);
+	_start = g_system->getMicros();
+}
+
+void ProfilingZone::end() {
+	const uint64 now = g_system->getMicros();
+
+	// Zones started before profiling was (re)started are dropped
+	const uint generation = atomicLoad(&g_profilingGeneration);
+	if (_generation != generation)
+		return;
+
+	ThreadBuffer *buffer = getThreadBuffer();
+	if (buffer->generation != generation) {
+		atomicStore(&buffer->count, 0U);
+		buffer->dropped = 0;
+		atomicStore(&buffer->generation, generation);
+	}
+
+	const uint index = buffer->count;
+	if (index == kZonesPerThread) {
+		atomicStore(&buffer->dropped, buffer->dropped + 1);
+		return;
+	}
+
+	Zone &zone = buffer->zones[index];
+	zone.name = _name;
+	zone.argName = _argName;
+	zone.argValue = _argValue;
+	zone.start = _start;
+	zone.duration = now - _start;
+	atomicStore(&buffer->count, index + 1);
+}
+
+} // End of namespace Common
+
+#endif
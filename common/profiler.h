@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * @defgroup common_profiler Profiling zones
+ * @ingroup common
+ *
+ * @brief Timeline of where the time goes, viewable in Chrome or Perfetto.
+ *
+ * Code marks the interesting parts with PROFILE_ZONE, which records the
+ * time spent in the enclosing scope under the given name. While profiling
+ * is stopped, which is the default, a zone costs a single test. While it
+ * is running, each thread appends its zones to a buffer of its own,
+ * without any locking.
+ *
+ * The recorded zones are written in the Chrome trace event format, which
+ * chrome://tracing and https://ui.perfetto.dev open. Profiling is started
+ * and stopped with the "profile" debugger command, or with the functions
+ * below.
+ *
+ * Profiling is only built in with the --enable-profiler configure option,
+ * since the buffers of the threads are found through thread local storage.
+ * Without that option, the PROFILE_ZONE macros expand to nothing.
+ * @{
+ */
+
+#ifdef ENABLE_PROFILER
+
+/** Whether profiling is running. Only to be read through isProfiling(). */
+extern bool gProfilingActive;
+
+/** Clear the recorded zones and start recording new ones. */
+void startProfiling();
+
+/** Stop recording zones. The recorded zones are kept until profiling is started again. */
+void stopProfiling();
+
+/**
+ * Return whether profiling is running. Other threads read this while the
+ * main thread starts and stops profiling, hence the atomic load.
+ */
+inline bool isProfiling() {
+#if defined(__GNUC__)
+	return __atomic_load_n(&gProfilingActive, __ATOMIC_RELAXED);
+#else
+	return *(volatile bool *)&gProfilingActive;
+#endif
+}
+
+/**
+ * Write the recorded zones to @p stream as Chrome trace JSON. Profiling
+ * should be stopped first, otherwise zones ending meanwhile may be missing.
+ */
+bool writeProfilingTrace(WriteStream &stream);
+
+/** Return the number of zones recorded since profiling was started. */
+uint getProfilingZoneCount();
+
+/** Name the current thread in the traces, e.g. "audio". @p name must stay valid. */
+void setProfilingThreadName(const char *name);
+
+/**
+ * Record the time spent from the construction to the destruction of the
+ * object. Use the PROFILE_ZONE macros rather than this class directly.
+ *
+ * The names must be string literals or otherwise stay valid until the
+ * trace has been written.
+ */
+class ProfilingZone : NonCopyable {
+public:
+	explicit ProfilingZone(const char *name) : _name(nullptr) {
+		if (isProfiling())
+			begin(name, nullptr, 0);
+	}
+
+	/** Record an integer argument along with the zone, e.g. a frame number. */
+	ProfilingZone(const char *name, const char *argName, int64 argValue) : _name(nullptr) {
+		if (isProfiling())
+			begin(name, argName, argValue);
+	}
+
+	~ProfilingZone() {
+		if (_name)
+			end();
+	}
+
+private:
+	void begin(const char *name, const char *argName, int64 argValue);
+	void end();
+
+	const char *_name;
+	const char *_argName;
+	int64 _argValue;
+	uint64 _start;
+	uint _generation;
+};
+
+#define PROFILE_ZONE(name) Common::ProfilingZone SCUMMVM_CONCAT(profilingZone, __LINE__)(name)
+#define PROFILE_ZONE_ARG(name, argName, argValue) Common::ProfilingZone SCUMMVM_CONCAT(profilingZone, __LINE__)(name, argName, argValue)
+
+#else
+
+inline bool isProfiling() { return false; }
+inline void setProfilingThreadName(const char *) {}
+
+#define PROFILE_ZONE(name) do {} while (false)
+#define PROFILE_ZONE_ARG(name, argName, argValue) do {} while (false)
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
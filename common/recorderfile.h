@@ -159,6 +159,11 @@ public:
 	void addSaveFile(const String &fileName, InSaveFile *saveStream);
 
 	uint32 getVersion() const {return _version;}
+
+	/** Number of recorded screenshots compared against the screen during playback. */
+	uint32 getCheckedScreenshots() const {return _checkedScreenshots;}
+	/** Number of recorded screenshots which didn't match the screen during playback. */
+	uint32 getFailedScreenshots() const {return _failedScreenshots;}
 private:
 	Array<byte> _tmpBuffer;
 	WriteStream *_recordFile;
@@ -175,6 +180,8 @@ private:
 	PlaybackFileHeader _header;
 	PlaybackFileState _playbackParseState;
 	uint32 _version;
+	uint32 _checkedScreenshots;
+	uint32 _failedScreenshots;
 
 	void skipHeader();
 	bool parseHeader();
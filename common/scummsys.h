@@ -166,6 +166,13 @@
 #endif
 #endif
 
+/**
+ * Paste two tokens together after expanding them, so that for example
+ * SCUMMVM_CONCAT(name, __LINE__) gives a name unique to a line.
+ */
+#define SCUMMVM_CONCAT(a, b) SCUMMVM_CONCAT_(a, b)
+#define SCUMMVM_CONCAT_(a, b) a##b
+
 // The following math constants are usually defined by the system math.h header, but
 // they are not part of the ANSI C++ standards and so can NOT be relied upon to be
 // present i.e. when -std=c++11 is passed to GCC, enabling strict ANSI compliance.
@@ -0,0 +1,514 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SMALLARRAY_H
+#define COMMON_SMALLARRAY_H
+
+#include "common/array.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_smallarray Small arrays
+ * @ingroup common
+ *
+ * @brief  Array with inline storage for its first elements.
+ * @{
+ */
+
+/**
+ * SmallArray<T, N> behaves like Array<T>, but keeps up to N elements in a
+ * buffer inside the object itself. Only when more elements are added, it
+ * moves them to the heap.
+ *
+ * This is meant for short-lived arrays which are usually small, like the
+ * lists of dirty rectangles or sprites built every frame: as long as they
+ * fit, they don't allocate any memory at all.
+ *
+ * The iterators are plain pointers, as with Array, so the functions from
+ * common/algorithm.h can be used on it. Note that, unlike with Array, the
+ * elements move when the array itself is moved while they are stored inline.
+ */
+template<class T, uint N>
+class SmallArray {
+public:
+	typedef T *iterator; /*!< Array iterator. */
+	typedef const T *const_iterator; /*!< Const-qualified array iterator. */
+
+	typedef T value_type; /*!< Value type of the array. */
+
+	typedef uint size_type; /*!< Size type of the array. */
+
+private:
+	size_type _capacity; /*!< Maximum number of elements the current storage can hold. */
+	size_type _size; /*!< How many elements the array holds. */
+	T *_storage; /*!< Either the inline storage or memory allocated on the heap. */
+
+	/** Storage for the first N elements, aligned like the most demanding basic types. */
+	union {
+		byte _bytes[N * sizeof(T)];
+		double _alignDouble;
+		uint64 _alignUint64;
+		void *_alignPointer;
+	} _inline;
+
+public:
+	SmallArray() : _capacity(N), _size(0), _storage(inlineStorage()) {}
+
+	/**
+	 * Construct an array with @p count default-inserted instances of @p T.
+	 */
+	explicit SmallArray(size_type count) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		resize(count);
+	}
+
+	/**
+	 * Construct an array with @p count copies of elements with value @p value.
+	 */
+	SmallArray(size_type count, const T &value) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		resize(count, value);
+	}
+
+	/**
+	 * Construct an array as a copy of the given @p array.
+	 */
+	SmallArray(const SmallArray &array) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		appendCopies(array.begin(), array.end());
+	}
+
+	/**
+	 * Construct an array as a copy of the given Array.
+	 */
+	SmallArray(const Array<T> &array) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		appendCopies(array.begin(), array.end());
+	}
+
+	/**
+	 * Construct an array by copying data from a regular array.
+	 */
+	template<class T2>
+	SmallArray(const T2 *array, size_type n) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		appendCopies(array, array + n);
+	}
+
+	/**
+	 * Construct an array using list initialization.
+	 */
+	SmallArray(std::initializer_list<T> list) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		appendCopies(list.begin(), list.end());
+	}
+
+	/**
+	 * Construct an array from the given array using the C++11 move semantic.
+	 * Heap storage is taken over, inline elements are moved one by one.
+	 */
+	SmallArray(SmallArray &&old) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		takeOver(old);
+	}
+
+	~SmallArray() {
+		freeStorage(_storage, _size);
+	}
+
+	/** Assign the given @p array to this array. */
+	SmallArray &operator=(const SmallArray &array) {
+		if (this == &array)
+			return *this;
+
+		assign(array.begin(), array.end());
+		return *this;
+	}
+
+	/** Assign the given Array to this array. */
+	SmallArray &operator=(const Array<T> &array) {
+		assign(array.begin(), array.end());
+		return *this;
+	}
+
+	/** Assign the given array to this array using the C++11 move semantic. */
+	SmallArray &operator=(SmallArray &&old) {
+		if (this == &old)
+			return *this;
+
+		clear();
+		takeOver(old);
+		return *this;
+	}
+
+	/** Return a copy of the elements as a regular Array, e.g. to pass them on to an API expecting one. */
+	Array<T> toArray() const {
+		return Array<T>(_storage, _size);
+	}
+
+	/** Append an element to the end of the array. */
+	void push_back(const T &element) {
+		if (_size + 1 <= _capacity)
+			new ((void *)&_storage[_size++]) T(element);
+		else
+			insert_aux(end(), &element, &element + 1);
+	}
+
+	/** Append copies of all the elements from the given Array to the end of the array. */
+	void push_back(const Array<T> &array) {
+		insert_aux(end(), array.begin(), array.end());
+	}
+
+	/** Remove the last element of the array. */
+	void pop_back() {
+		assert(_size > 0);
+		_size--;
+		_storage[_size].~T();
+	}
+
+	/** Return a pointer to the underlying memory serving as element storage. */
+	const T *data() const {
+		return _storage;
+	}
+
+	/** Return a pointer to the underlying memory serving as element storage. */
+	T *data() {
+		return _storage;
+	}
+
+	/** Return a reference to the first element of the array. */
+	T &front() {
+		assert(_size > 0);
+		return _storage[0];
+	}
+
+	/** Return a reference to the first element of the array. */
+	const T &front() const {
+		assert(_size > 0);
+		return _storage[0];
+	}
+
+	/** Return a reference to the last element of the array. */
+	T &back() {
+		assert(_size > 0);
+		return _storage[_size - 1];
+	}
+
+	/** Return a reference to the last element of the array. */
+	const T &back() const {
+		assert(_size > 0);
+		return _storage[_size - 1];
+	}
+
+	/** Insert an element into the array at the given position. */
+	void insert_at(size_type idx, const T &element) {
+		assert(idx <= _size);
+		insert_aux(_storage + idx, &element, &element + 1);
+	}
+
+	/** Insert copies of all the elements from the given Array into this array at the given position. */
+	void insert_at(size_type idx, const Array<T> &array) {
+		assert(idx <= _size);
+		insert_aux(_storage + idx, array.begin(), array.end());
+	}
+
+	/** Insert an element before @p pos. */
+	void insert(iterator pos, const T &element) {
+		insert_aux(pos, &element, &element + 1);
+	}
+
+	/** Remove an element at the given position from the array and return the value of that element. */
+	T remove_at(size_type idx) {
+		assert(idx < _size);
+		T tmp = _storage[idx];
+		erase(_storage + idx);
+		return tmp;
+	}
+
+	/** Return a reference to the element at the given position in the array. */
+	T &operator[](size_type idx) {
+		assert(idx < _size);
+		return _storage[idx];
+	}
+
+	/** Return a const reference to the element at the given position in the array. */
+	const T &operator[](size_type idx) const {
+		assert(idx < _size);
+		return _storage[idx];
+	}
+
+	/** Return the size of the array. */
+	size_type size() const {
+		return _size;
+	}
+
+	/** Return the number of elements the array can hold without allocating memory. */
+	size_type capacity() const {
+		return _capacity;
+	}
+
+	/** Check whether the elements are still stored inside the array object itself. */
+	bool isInline() const {
+		return _storage == inlineStorage();
+	}
+
+	/** Clear the array of all its elements, and release the memory allocated on the heap if any. */
+	void clear() {
+		freeStorage(_storage, _size);
+		_capacity = N;
+		_size = 0;
+		_storage = inlineStorage();
+	}
+
+	/** Erase the element at @p pos position and return an iterator pointing to the next element in the array. */
+	iterator erase(iterator pos) {
+		return erase(pos, pos + 1);
+	}
+
+	/** Erase the elements from @p first to @p last and return an iterator pointing to the next element in the array. */
+	iterator erase(iterator first, iterator last) {
+		assert(_storage <= first && first <= last && last <= _storage + _size);
+		copy(last, _storage + _size, first);
+
+		const size_type count = last - first;
+		_size -= count;
+
+		// We also need to destroy the objects beyond the new size
+		for (size_type idx = _size; idx < _size + count; ++idx)
+			_storage[idx].~T();
+
+		return first;
+	}
+
+	/** Check whether the array is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+
+	/** Check whether two arrays are identical. */
+	bool operator==(const SmallArray &other) const {
+		return equals(other.begin(), other.size());
+	}
+
+	/** Check if two arrays are different. */
+	bool operator!=(const SmallArray &other) const {
+		return !(*this == other);
+	}
+
+	/** Check whether this array holds the same elements as the given Array. */
+	bool operator==(const Array<T> &other) const {
+		return equals(other.begin(), other.size());
+	}
+
+	/** Check whether this array holds different elements than the given Array. */
+	bool operator!=(const Array<T> &other) const {
+		return !(*this == other);
+	}
+
+	/** Return an iterator pointing to the first element in the array. */
+	iterator       begin() {
+		return _storage;
+	}
+
+	/** Return an iterator pointing past the last element in the array. */
+	iterator       end() {
+		return _storage + _size;
+	}
+
+	/** Return a const iterator pointing to the first element in the array. */
+	const_iterator begin() const {
+		return _storage;
+	}
+
+	/** Return a const iterator pointing past the last element in the array. */
+	const_iterator end() const {
+		return _storage + _size;
+	}
+
+	/** Reserve enough memory in the array so that it can store at least the given number of elements.
+	 *  The current content of the array is not modified.
+	 */
+	void reserve(size_type newCapacity) {
+		if (newCapacity <= _capacity)
+			return;
+
+		T *oldStorage = _storage;
+		T *newStorage = allocStorage(newCapacity);
+		moveElements(oldStorage, oldStorage + _size, newStorage);
+		freeStorage(oldStorage, _size);
+		_storage = newStorage;
+		_capacity = newCapacity;
+	}
+
+	/** Change the size of the array. */
+	void resize(size_type newSize) {
+		reserve(newSize);
+
+		for (size_type i = newSize; i < _size; ++i)
+			_storage[i].~T();
+		for (size_type i = _size; i < newSize; ++i)
+			new ((void *)&_storage[i]) T();
+
+		_size = newSize;
+	}
+
+	/** Change the size of the array and initialize new elements that exceed the
+	 *  current array's size with copies of value. */
+	void resize(size_type newSize, const T value) {
+		reserve(newSize);
+
+		for (size_type i = newSize; i < _size; ++i)
+			_storage[i].~T();
+		if (newSize > _size)
+			uninitialized_fill_n(_storage + _size, newSize - _size, value);
+
+		_size = newSize;
+	}
+
+	/** Assign to this array the elements between the given iterators,
+	 *  from @p first included to @p last excluded.
+	 */
+	void assign(const_iterator first, const_iterator last) {
+		assert(first <= last);
+		// Destroy the old elements first, but keep the storage around
+		for (size_type i = 0; i < _size; ++i)
+			_storage[i].~T();
+		_size = 0;
+		appendCopies(first, last);
+	}
+
+private:
+	T *inlineStorage() {
+		return (T *)_inline._bytes;
+	}
+
+	const T *inlineStorage() const {
+		return (const T *)_inline._bytes;
+	}
+
+	/** Round up capacity to the next power of 2, like Array does. */
+	static size_type roundUpCapacity(size_type capacity) {
+		size_type capa = 8;
+		while (capa < capacity)
+			capa <<= 1;
+		return capa;
+	}
+
+	static T *allocStorage(size_type capacity) {
+		T *storage = (T *)malloc(sizeof(T) * capacity);
+		if (!storage)
+			::error("Common::SmallArray: failure to allocate %u bytes", capacity * (size_type)sizeof(T));
+		return storage;
+	}
+
+	/** Destroy the elements, and free the storage if it isn't the inline one. */
+	void freeStorage(T *storage, const size_type elements) {
+		for (size_type i = 0; i < elements; ++i)
+			storage[i].~T();
+		if (storage != inlineStorage())
+			free(storage);
+	}
+
+	/** Move construct the elements from @p first to @p last into uninitialized memory at @p dst. */
+	static void moveElements(T *first, T *last, T *dst) {
+		while (first != last)
+			new ((void *)dst++) T(Common::move(*first++));
+	}
+
+	template<class In>
+	void appendCopies(In first, In last) {
+		const size_type n = last - first;
+		reserve(_size + n);
+		uninitialized_copy(first, last, _storage + _size);
+		_size += n;
+	}
+
+	void takeOver(SmallArray &old) {
+		if (old.isInline()) {
+			moveElements(old._storage, old._storage + old._size, _storage);
+			_size = old._size;
+			old.clear();
+		} else {
+			_capacity = old._capacity;
+			_size = old._size;
+			_storage = old._storage;
+
+			old._capacity = N;
+			old._size = 0;
+			old._storage = old.inlineStorage();
+		}
+	}
+
+	bool equals(const T *other, size_type size) const {
+		if (_size != size)
+			return false;
+		for (size_type i = 0; i < _size; ++i) {
+			if (_storage[i] != other[i])
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Insert a range of elements coming from this or another array, like
+	 * Array::insert_aux does.
+	 */
+	iterator insert_aux(iterator pos, const_iterator first, const_iterator last) {
+		assert(_storage <= pos && pos <= _storage + _size);
+		assert(first <= last);
+		const size_type n = last - first;
+		const size_type idx = pos - _storage;
+		if (n) {
+			if (_size + n > _capacity || (_storage <= first && first <= _storage + _size)) {
+				T *const oldStorage = _storage;
+
+				// If there is not enough space, allocate more. Likewise, if
+				// this is a self-insert, we allocate new storage to avoid
+				// conflicts.
+				const size_type newCapacity = (_size + n > _capacity) ? roundUpCapacity(_size + n) : _capacity;
+				T *const newStorage = allocStorage(newCapacity);
+
+				// Copy the new elements first, as they may come from the old
+				// storage.
+				uninitialized_copy(first, last, newStorage + idx);
+				moveElements(oldStorage, oldStorage + idx, newStorage);
+				moveElements(oldStorage + idx, oldStorage + _size, newStorage + idx + n);
+
+				freeStorage(oldStorage, _size);
+				_storage = newStorage;
+				_capacity = newCapacity;
+			} else if (idx + n <= _size) {
+				// Make room for the new elements by shifting back existing ones.
+				uninitialized_copy(_storage + _size - n, _storage + _size, _storage + _size);
+				copy_backward(pos, _storage + _size - n, _storage + _size);
+				copy(first, last, pos);
+			} else {
+				// The new elements extend past the old end of the array.
+				uninitialized_copy(pos, _storage + _size, _storage + idx + n);
+				copy(first, first + (_size - idx), pos);
+				uninitialized_copy(first + (_size - idx), last, _storage + _size);
+			}
+
+			_size += n;
+		}
+		return _storage + idx;
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
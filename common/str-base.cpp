@@ -19,6 +19,9 @@
  *
  */
 
+// pthread.h includes time.h
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
 #include "common/str-base.h"
 #include "common/hash-str.h"
 #include "common/list.h"
@@ -27,6 +30,10 @@
 #include "common/util.h"
 #include "common/mutex.h"
 
+#if defined(USE_PTHREADS) && !defined(SCUMMVM_UTIL)
+#include <pthread.h>
+#endif
+
 namespace Common {
 
 #define TEMPLATE template<class T>
@@ -34,6 +41,24 @@ namespace Common {
 
 MemoryPool *g_refCountPool = nullptr; // FIXME: This is never freed right now
 #ifndef SCUMMVM_UTIL
+#ifdef USE_PTHREADS
+// Threads other than the main one, such as the one prefetching an
+// FSDirectory, may use strings whatever the backend, so the pool is guarded
+// by a lock which depends neither on g_system nor on its mutexes.
+static pthread_mutex_t g_refCountPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void lockMemoryPoolMutex() {
+	pthread_mutex_lock(&g_refCountPoolMutex);
+}
+
+void unlockMemoryPoolMutex() {
+	pthread_mutex_unlock(&g_refCountPoolMutex);
+}
+
+TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
+}
+
+#else
 Mutex *g_refCountPoolMutex = nullptr;
 
 void lockMemoryPoolMutex() {
@@ -60,6 +85,7 @@ TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
 	}
 }
 
+#endif
 #endif
 
 static uint32 computeCapacity(uint32 len) {
@@ -270,6 +270,12 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+void SeekableSubReadStream::readAhead(int64 offset, uint32 size) {
+	if (offset < 0 || offset >= this->size())
+		return;
+	_parentStream->readAhead(_begin + offset, MIN<int64>(size, this->size() - offset));
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -419,6 +425,7 @@ public:
 	int64 size() const override { return _parentStream->size(); }
 
 	bool seek(int64 offset, int whence = SEEK_SET) override;
+	void readAhead(int64 offset, uint32 size) override { _parentStream->readAhead(offset, size); }
 };
 
 BufferedSeekableReadStream::BufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream)
@@ -482,6 +489,183 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
 
 namespace {
 
+/**
+ * Wrapper class which adds buffering to any given SeekableReadStream, with
+ * refills which grow as long as the stream is read sequentially.
+ * @see wrapAdaptiveBufferedSeekableReadStream
+ */
+class AdaptiveBufferedSeekableReadStream : public SeekableReadStream {
+protected:
+	DisposablePtr<SeekableReadStream> _parentStream;
+	byte *_buf;
+	uint32 _realBufSize;
+	const uint32 _minBufSize;
+	const uint32 _maxBufSize;
+	uint32 _fillSize;  // size of the last refill
+	int64 _bufStart;   // position of the buffer in the parent stream
+	uint32 _bufSize;   // number of bytes in the buffer
+	uint32 _pos;       // position in the buffer
+	int64 _parentPos;  // position of the parent stream, -1 if unknown
+	int64 _fillEnd;    // end of the last read from the parent stream, -1 if none
+	bool _eos;
+
+	uint32 nextFillSize(uint32 fillSize) const {
+		return fillSize < _maxBufSize / 2 ? fillSize * 2 : _maxBufSize;
+	}
+
+	uint32 readParent(int64 position, void *dataPtr, uint32 dataSize);
+
+public:
+	AdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 minBufSize, uint32 maxBufSize, DisposeAfterUse::Flag disposeParentStream);
+	~AdaptiveBufferedSeekableReadStream() override;
+
+	bool eos() const override { return _eos; }
+	bool err() const override { return _parentStream->err(); }
+	void clearErr() override { _eos = false; _parentStream->clearErr(); }
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	int64 pos() const override { return _bufStart + _pos; }
+	int64 size() const override { return _parentStream->size(); }
+
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+	void readAhead(int64 offset, uint32 size) override { _parentStream->readAhead(offset, size); }
+};
+
+AdaptiveBufferedSeekableReadStream::AdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 minBufSize, uint32 maxBufSize, DisposeAfterUse::Flag disposeParentStream)
+	: _parentStream(parentStream, disposeParentStream),
+	_realBufSize(minBufSize),
+	_minBufSize(minBufSize),
+	_maxBufSize(maxBufSize),
+	_fillSize(minBufSize),
+	_bufSize(0),
+	_pos(0),
+	_fillEnd(-1),
+	_eos(false) {
+
+	assert(parentStream);
+	assert(minBufSize > 0 && minBufSize <= maxBufSize);
+	_buf = new byte[minBufSize];
+	assert(_buf);
+	_bufStart = _parentPos = parentStream->pos();
+}
+
+AdaptiveBufferedSeekableReadStream::~AdaptiveBufferedSeekableReadStream() {
+	delete[] _buf;
+}
+
+uint32 AdaptiveBufferedSeekableReadStream::readParent(int64 position, void *dataPtr, uint32 dataSize) {
+	if (_parentPos != position && !_parentStream->seek(position)) {
+		_parentPos = -1;
+		return 0;
+	}
+
+	const uint32 n = _parentStream->read(dataPtr, dataSize);
+	_parentPos = _fillEnd = position + n;
+	return n;
+}
+
+uint32 AdaptiveBufferedSeekableReadStream::read(void *dataPtr, uint32 dataSize) {
+	const uint32 bufBytesLeft = _bufSize - _pos;
+
+	// Check whether the data left in the buffer suffices
+	if (dataSize <= bufBytesLeft) {
+		memcpy(dataPtr, _buf + _pos, dataSize);
+		_pos += dataSize;
+		return dataSize;
+	}
+
+	// Flush the buffer
+	memcpy(dataPtr, _buf + _pos, bufBytesLeft);
+	_pos = _bufSize;
+	dataPtr = (byte *)dataPtr + bufBytesLeft;
+	dataSize -= bufBytesLeft;
+
+	// Reads which go on where the last one ended, or a little after it,
+	// are sequential and get larger refills. Any other read starts over
+	// with the smallest refills.
+	const int64 position = pos();
+	const bool sequential = _fillEnd >= 0 && position >= _fillEnd && position - _fillEnd < _fillSize;
+	_fillSize = sequential ? nextFillSize(_fillSize) : _minBufSize;
+
+	uint32 n;
+	if (dataSize > _fillSize) {
+		// The request exceeds the refill size, satisfy it directly
+		n = readParent(position, dataPtr, dataSize);
+		_bufStart = position + n;
+		_bufSize = _pos = 0;
+	} else {
+		if (_realBufSize < _fillSize) {
+			delete[] _buf;
+			_buf = new byte[_fillSize];
+			assert(_buf);
+			_realBufSize = _fillSize;
+		}
+
+		_bufStart = position;
+		_bufSize = readParent(position, _buf, _fillSize);
+		n = MIN(dataSize, _bufSize);
+		memcpy(dataPtr, _buf, n);
+		_pos = n;
+	}
+
+	// If we didn't get as many bytes as requested, the reason is EOF or
+	// an error
+	if (n < dataSize && _parentStream->eos())
+		_eos = true;
+
+	// Let the parent stream read the next refill while this one is consumed
+	if (sequential && !_eos)
+		_parentStream->readAhead(_fillEnd, nextFillSize(_fillSize));
+
+	return bufBytesLeft + n;
+}
+
+bool AdaptiveBufferedSeekableReadStream::seek(int64 offset, int whence) {
+	int64 target;
+	switch (whence) {
+	case SEEK_CUR:
+		target = pos() + offset;
+		break;
+	case SEEK_END:
+		target = size() + offset;
+		break;
+	case SEEK_SET:
+	default:
+		target = offset;
+		break;
+	}
+
+	_eos = false; // seeking always cancels EOS
+
+	// Seeks into the buffered data do not touch the parent stream
+	if (target >= _bufStart && target <= _bufStart + _bufSize) {
+		_pos = target - _bufStart;
+		return true;
+	}
+
+	if (!_parentStream->seek(target)) {
+		_parentPos = -1;
+		return false;
+	}
+
+	_parentPos = _bufStart = target;
+	_bufSize = _pos = 0;
+	return true;
+}
+
+} // End of anonymous namespace
+
+SeekableReadStream *wrapAdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 minBufSize, uint32 maxBufSize, DisposeAfterUse::Flag disposeParentStream) {
+	if (parentStream)
+		return new AdaptiveBufferedSeekableReadStream(parentStream, minBufSize, maxBufSize, disposeParentStream);
+	return nullptr;
+}
+
+#pragma mark -
+
+namespace {
+
 /**
  * Wrapper class which adds buffering to any WriteStream.
  */
@@ -700,6 +700,18 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Hint that the given range of the stream is going to be read soon.
+	 *
+	 * Streams backed by files may ask the operating system to start reading
+	 * the range in the background. This does not move the position indicator,
+	 * and the default implementation does nothing.
+	 *
+	 * @param offset	Offset of the range, from the start of the stream.
+	 * @param size		Size of the range in bytes.
+	 */
+	virtual void readAhead(int64 offset, uint32 size) {}
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -890,6 +902,7 @@ public:
 	int64 pos() const override { return _parentStream->pos(); }
 	int64 size() const override { return _parentStream->size(); }
 	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+	void readAhead(int64 offset, uint32 size) override { _parentStream->readAhead(offset, size); }
 };
 
 /** @} */
@@ -1393,6 +1393,15 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get the number of microseconds since an arbitrary point in time.
+	 *
+	 * This is meant for measuring short durations when profiling and is
+	 * never recorded by the event recorder. Backends without a more precise
+	 * timer fall back to getMillis().
+	 */
+	virtual uint64 getMicros() { return (uint64)getMillis(true) * 1000; }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
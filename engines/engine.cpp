@@ -24,9 +24,12 @@
 #include "engines/util.h"
 #include "engines/metaengine.h"
 
+#include "common/algorithm.h"
+#include "common/array.h"
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/system.h"
 #include "common/str.h"
 #include "common/ustr.h"
@@ -64,6 +67,9 @@
 // FIXME: HACK for error()
 Engine *g_engine = 0;
 
+// Called and forgotten when the running engine is destroyed
+static Common::Array<Engine::CleanupHook> *g_cleanupHooks = nullptr;
+
 // Output formatter for debug() and error() which invokes
 // the errorString method of the active engine, if any.
 static void defaultOutputFormatter(char *dst, const char *src, size_t dstSize) {
@@ -190,10 +196,25 @@ Engine::~Engine() {
 	// Remove our cursors again to prevent memory leaks
 	CursorMan.popCursor();
 	CursorMan.popCursorPalette();
+
+	if (g_cleanupHooks) {
+		for (uint i = 0; i < g_cleanupHooks->size(); ++i)
+			(*g_cleanupHooks)[i]();
+		delete g_cleanupHooks;
+		g_cleanupHooks = nullptr;
+	}
 }
 
 void Engine::initializePath(const Common::FSNode &gamePath) {
 	SearchMan.addDirectory(gamePath.getPath(), gamePath, 0, 4);
+
+	// Optionally list the game files in the background, so that they are
+	// indexed without delaying the first file accesses
+	if (ConfMan.getBool("prefetch_game_files")) {
+		Common::FSDirectory *dir = dynamic_cast<Common::FSDirectory *>(SearchMan.getArchive(gamePath.getPath()));
+		if (dir)
+			dir->prefetch();
+	}
 }
 
 void initCommonGFX() {
@@ -967,6 +988,14 @@ bool Engine::shouldQuit() {
 	return (eventMan->shouldQuit() || eventMan->shouldReturnToLauncher());
 }
 
+void Engine::addCleanupHook(CleanupHook hook) {
+	if (!g_cleanupHooks)
+		g_cleanupHooks = new Common::Array<CleanupHook>();
+	else if (Common::find(g_cleanupHooks->begin(), g_cleanupHooks->end(), hook) != g_cleanupHooks->end())
+		return;
+	g_cleanupHooks->push_back(hook);
+}
+
 GUI::Debugger *Engine::getOrCreateDebugger() {
 	if (!_debugger)
 		// Create a bare-bones debugger. This is useful for engines without their own
@@ -510,6 +510,17 @@ public:
 	 */
 	static bool shouldQuit();
 
+	/** A function dropping state kept for the game of the running engine. */
+	typedef void (*CleanupHook)();
+
+	/**
+	 * Have @p hook called once the running engine is destroyed, for example
+	 * to drop caches whose entries could be mistaken for those of the next
+	 * game. The hook is called only once; adding it again before that has no
+	 * effect.
+	 */
+	static void addCleanupHook(CleanupHook hook);
+
 	/**
 	 * Return the MetaEngineDetection instance used by this engine.
 	 */
@@ -0,0 +1,159 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/alpha_runs.h"
+#include "graphics/surface.h"
+
+#include "common/util.h"
+
+namespace Graphics {
+
+static inline AlphaRuns::RunType classify(uint32 pixel, uint32 aMask) {
+	const uint32 alpha = pixel & aMask;
+	if (alpha == aMask)
+		return AlphaRuns::kRunOpaque;
+	return alpha ? AlphaRuns::kRunBlended : AlphaRuns::kRunTransparent;
+}
+
+bool AlphaRuns::build(const Surface &surface, bool packPixels) {
+	clear();
+
+	if (surface.format.bytesPerPixel != 4 || !surface.getPixels())
+		return false;
+
+	rebind(surface);
+
+	// Without an alpha channel every pixel is opaque
+	const uint32 aMask = surface.format.aBits() ? (0xFF >> surface.format.aLoss) << surface.format.aShift : 0;
+
+	_rows.reserve(_height + 1);
+	for (int y = 0; y < _height; y++) {
+		_rows.push_back(_runs.size());
+
+		const uint32 *row = (const uint32 *)surface.getBasePtr(0, y);
+		int x = 0;
+		while (x < _width) {
+			const RunType type = classify(row[x], aMask);
+			int end = x + 1;
+			while (end < _width && classify(row[end], aMask) == type)
+				end++;
+
+			addRun(type, end - x);
+			x = end;
+		}
+	}
+	_rows.push_back(_runs.size());
+
+	if (packPixels)
+		pack(surface);
+
+	return true;
+}
+
+void AlphaRuns::pack(const Surface &surface) {
+	// Allocated once at the exact size, since saving memory is the point
+	_packedRows.resize(_height + 1);
+	_packed.resize(countPixels(kRunOpaque) + countPixels(kRunBlended));
+
+	uint32 *packed = _packed.begin();
+	for (int y = 0; y < _height; y++) {
+		_packedRows[y] = packed - _packed.begin();
+
+		const uint32 *row = (const uint32 *)surface.getBasePtr(0, y);
+		const uint16 *runs = getRuns(y);
+		for (uint i = 0; i < getRunCount(y); i++) {
+			const uint length = getLength(runs[i]);
+			if (getType(runs[i]) != kRunTransparent) {
+				memcpy(packed, row, length * 4);
+				packed += length;
+			}
+			row += length;
+		}
+	}
+	_packedRows[_height] = _packed.size();
+}
+
+void AlphaRuns::addRun(RunType type, uint length) {
+	while (length > 0) {
+		const uint part = MIN<uint>(length, kMaxRunLength);
+		_runs.push_back((uint16)((type << 14) | part));
+		length -= part;
+	}
+}
+
+void AlphaRuns::clear() {
+	_rows.clear();
+	_runs.clear();
+	_packedRows.clear();
+	_packed.clear();
+	_width = _height = _pitch = 0;
+	_pixels = nullptr;
+	_generation = 0;
+}
+
+bool AlphaRuns::matches(const Surface &surface) const {
+	return !empty() && _pixels == surface.getPixels() && _generation == surface.getPixelGeneration() &&
+	       _width == surface.w && _height == surface.h && _pitch == surface.pitch;
+}
+
+void AlphaRuns::rebind(const Surface &surface) {
+	_width = surface.w;
+	_height = surface.h;
+	_pitch = surface.pitch;
+	_pixels = surface.getPixels();
+	_generation = surface.getPixelGeneration();
+}
+
+void AlphaRuns::unpack(Surface &surface) const {
+	assert(hasPackedPixels() && surface.w == _width && surface.h == _height && surface.format.bytesPerPixel == 4);
+
+	for (int y = 0; y < _height; y++) {
+		uint32 *row = (uint32 *)surface.getBasePtr(0, y);
+		const uint32 *packed = getPackedPixels(y);
+		const uint16 *runs = getRuns(y);
+		for (uint i = 0; i < getRunCount(y); i++) {
+			const uint length = getLength(runs[i]);
+			if (getType(runs[i]) == kRunTransparent) {
+				memset(row, 0, length * 4);
+			} else {
+				memcpy(row, packed, length * 4);
+				packed += length;
+			}
+			row += length;
+		}
+	}
+}
+
+uint AlphaRuns::countPixels(RunType type) const {
+	uint count = 0;
+	for (uint i = 0; i < _runs.size(); i++) {
+		if (getType(_runs[i]) == type)
+			count += getLength(_runs[i]);
+	}
+	return count;
+}
+
+uint AlphaRuns::getMemorySize() const {
+	return _rows.size() * sizeof(uint32) + _runs.size() * sizeof(uint16) +
+	       _packedRows.size() * sizeof(uint32) + _packed.size() * sizeof(uint32);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_ALPHA_RUNS_H
+#define GRAPHICS_ALPHA_RUNS_H
+
+#include "common/array.h"
+
+namespace Graphics {
+
+struct Surface;
+
+/**
+ * The rows of a 32 bit sprite split into runs of fully transparent, fully
+ * opaque and blended pixels.
+ *
+ * The runs are computed once, usually when the sprite is loaded. Blits can
+ * then skip transparent runs and copy opaque ones without looking at the
+ * alpha value of every single pixel.
+ *
+ * The runs can also keep a packed copy of the pixels which are not fully
+ * transparent, so that the sprite can be drawn without its pixel buffer.
+ */
+class AlphaRuns {
+public:
+	enum RunType {
+		kRunTransparent = 0,
+		kRunOpaque = 1,
+		kRunBlended = 2
+	};
+
+	enum {
+		/** Longest run which fits into one entry; longer ones are split. */
+		kMaxRunLength = 0x3FFF
+	};
+
+	AlphaRuns() : _width(0), _height(0), _pitch(0), _pixels(nullptr), _generation(0) {}
+
+	/**
+	 * Analyse the alpha channel of a surface. Surfaces without an alpha
+	 * channel consist of opaque runs only.
+	 *
+	 * @param surface     the surface to analyse
+	 * @param packPixels  whether to keep a copy of the pixels which are not
+	 *                    fully transparent, see getPackedPixels()
+	 * @return false if the surface doesn't use 32 bits per pixel.
+	 */
+	bool build(const Surface &surface, bool packPixels = false);
+
+	/** Forget the runs. */
+	void clear();
+
+	/**
+	 * Check whether the runs were built for the given surface in its current
+	 * state, that is with the same pixel buffer, size and pitch, and with no
+	 * change of the pixel data through Surface::create() and the like since
+	 * then. Drawing to the pixels directly is not noticed; the runs have to
+	 * be built again after that.
+	 */
+	bool matches(const Surface &surface) const;
+
+	/**
+	 * Let the runs describe the surface again after the owner of packed runs
+	 * freed or replaced its pixel buffer, without a change to the image.
+	 */
+	void rebind(const Surface &surface);
+
+	bool empty() const { return _rows.empty(); }
+
+	/** Number of run entries of a row. */
+	uint getRunCount(int y) const { return _rows[y + 1] - _rows[y]; }
+
+	/** The run entries of a row, which can be decoded with getType() and getLength(). */
+	const uint16 *getRuns(int y) const { return &_runs[_rows[y]]; }
+
+	static RunType getType(uint16 run) { return (RunType)(run >> 14); }
+	static uint getLength(uint16 run) { return run & kMaxRunLength; }
+
+	/** Whether build() kept the pixels which are not fully transparent. */
+	bool hasPackedPixels() const { return !empty() && _packedRows.size() == _rows.size(); }
+
+	/**
+	 * The pixels of a row which are not fully transparent, one after the
+	 * other in the order of the runs.
+	 */
+	const uint32 *getPackedPixels(int y) const { return _packed.begin() + _packedRows[y]; }
+
+	/**
+	 * Write the image back to a surface of the same size and format.
+	 * Fully transparent pixels become 0.
+	 */
+	void unpack(Surface &surface) const;
+
+	/** Number of pixels in runs of the given type, mostly for statistics. */
+	uint countPixels(RunType type) const;
+
+	/** Number of bytes used by the runs and the packed pixels. */
+	uint getMemorySize() const;
+
+private:
+	void addRun(RunType type, uint length);
+	void pack(const Surface &surface);
+
+	int _width, _height, _pitch;
+	const void *_pixels;
+	uint32 _generation;
+
+	/** Index of the first run of each row, followed by the total number of runs. */
+	Common::Array<uint32> _rows;
+	Common::Array<uint16> _runs;
+
+	/** Index of the first packed pixel of each row, followed by the total. */
+	Common::Array<uint32> _packedRows;
+	Common::Array<uint32> _packed;
+};
+
+} // End of namespace Graphics
+
+#endif
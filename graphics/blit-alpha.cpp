@@ -0,0 +1,584 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/blit.h"
+#include "graphics/alpha_runs.h"
+#include "graphics/pixelformat.h"
+#include "graphics/transform_struct.h"
+
+#include "common/util.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLEND_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Graphics {
+
+namespace {
+
+typedef void (*SpanFunc)(const byte *in, int inStep, byte *out, uint width, uint32 color);
+
+/**
+ * The blending operations of TransparentSurface, working on spans of
+ * pixels. The template parameters are the byte offsets of the channels
+ * within a pixel, so that one instantiation serves each memory layout.
+ *
+ * The color modulation is always given in the TS_ARGB layout, i.e.
+ * 0xRRGGBBAA.
+ */
+template<int kA, int kR, int kG, int kB>
+struct BlendSpans {
+	static void opaque(const byte *in, int inStep, byte *out, uint width, uint32 color) {
+		if (inStep == 4) {
+			memcpy(out, in, width * 4);
+			for (uint x = 0; x < width; x++, out += 4)
+				out[kA] = 0xFF;
+			return;
+		}
+
+		for (uint x = 0; x < width; x++) {
+			*(uint32 *)out = *(const uint32 *)in;
+			out[kA] = 0xFF;
+			in += inStep;
+			out += 4;
+		}
+	}
+
+	static void binary(const byte *in, int inStep, byte *out, uint width, uint32 color) {
+		for (uint x = 0; x < width; x++) {
+			// Any value not exactly 0 is opaque here
+			if (in[kA] != 0) {
+				*(uint32 *)out = *(const uint32 *)in;
+				out[kA] = 0xFF;
+			}
+			in += inStep;
+			out += 4;
+		}
+	}
+
+	template<bool rgbmod, bool alphamod, bool premultiplied>
+	static void alphaBlend(const byte *in, int inStep, byte *out, uint width, uint32 color) {
+		const uint ca = alphamod ? (color & 0xFF) : 255;
+		const uint cr = rgbmod ? ((color >> 24) & 0xFF) : 255;
+		const uint cg = rgbmod ? ((color >> 16) & 0xFF) : 255;
+		const uint cb = rgbmod ? ((color >> 8) & 0xFF) : 255;
+
+		uint x = 0;
+#ifdef BLEND_SSE2
+		if (inStep == 4)
+			x = alphaBlendSSE2<premultiplied>(in, out, width, ca, cr, cg, cb);
+		in += x * 4;
+		out += x * 4;
+#endif
+
+		for (; x < width; x++) {
+			const uint ina = in[kA] * ca >> 8;
+
+			if (ina != 0) {
+				// Premultiplied colors already carry their alpha
+				const uint inw = premultiplied ? ca : ina;
+				const uint outb = (out[kB] * (255 - ina) >> 8);
+				const uint outg = (out[kG] * (255 - ina) >> 8);
+				const uint outr = (out[kR] * (255 - ina) >> 8);
+
+				out[kA] = 255;
+				out[kB] = outb + (in[kB] * inw * cb >> 16);
+				out[kG] = outg + (in[kG] * inw * cg >> 16);
+				out[kR] = outr + (in[kR] * inw * cr >> 16);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	}
+
+#ifdef BLEND_SSE2
+	/**
+	 * Blend groups of four pixels with the same arithmetic as alphaBlend(),
+	 * on 16 bit lanes. Returns the number of pixels processed.
+	 */
+	template<bool premultiplied>
+	static uint alphaBlendSSE2(const byte *in, byte *out, uint width, uint ca, uint cr, uint cg, uint cb) {
+		uint16 modLanes[8], alphaLanes[8];
+		for (int i = 0; i < 8; i += 4) {
+			modLanes[i + kA] = 0;
+			modLanes[i + kR] = cr;
+			modLanes[i + kG] = cg;
+			modLanes[i + kB] = cb;
+			alphaLanes[i + kA] = 0xFFFF;
+			alphaLanes[i + kR] = alphaLanes[i + kG] = alphaLanes[i + kB] = 0;
+		}
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i c255 = _mm_set1_epi16(255);
+		const __m128i caV = _mm_set1_epi16(ca);
+		const __m128i modV = _mm_loadu_si128((const __m128i *)modLanes);
+		const __m128i alphaV = _mm_loadu_si128((const __m128i *)alphaLanes);
+
+		uint x = 0;
+		for (; x + 4 <= width; x += 4, in += 16, out += 16) {
+			const __m128i inPx = _mm_loadu_si128((const __m128i *)in);
+			const __m128i outPx = _mm_loadu_si128((const __m128i *)out);
+
+			const __m128i lo = blendLanesSSE2<premultiplied>(_mm_unpacklo_epi8(inPx, zero), _mm_unpacklo_epi8(outPx, zero), zero, c255, caV, modV, alphaV);
+			const __m128i hi = blendLanesSSE2<premultiplied>(_mm_unpackhi_epi8(inPx, zero), _mm_unpackhi_epi8(outPx, zero), zero, c255, caV, modV, alphaV);
+			_mm_storeu_si128((__m128i *)out, _mm_packus_epi16(lo, hi));
+		}
+
+		return x;
+	}
+
+	template<bool premultiplied>
+	static inline __m128i blendLanesSSE2(__m128i in, __m128i out, __m128i zero, __m128i c255, __m128i caV, __m128i modV, __m128i alphaV) {
+		// Spread the alpha of each of the two pixels to all its lanes.
+		__m128i a = _mm_shufflelo_epi16(in, _MM_SHUFFLE(kA, kA, kA, kA));
+		a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(kA, kA, kA, kA));
+		a = _mm_srli_epi16(_mm_mullo_epi16(a, caV), 8);
+
+		// All products fit into 16 bits; the tint is applied with the upper
+		// half of a 16x16 bit product, which is the ">> 16" of the C code.
+		__m128i blended = _mm_srli_epi16(_mm_mullo_epi16(out, _mm_sub_epi16(c255, a)), 8);
+		blended = _mm_add_epi16(blended, _mm_mulhi_epu16(_mm_mullo_epi16(in, premultiplied ? caV : a), modV));
+		blended = _mm_or_si128(_mm_andnot_si128(alphaV, blended), _mm_and_si128(alphaV, c255));
+
+		// Leave pixels with no coverage untouched.
+		const __m128i keep = _mm_cmpeq_epi16(a, zero);
+		return _mm_or_si128(_mm_and_si128(keep, out), _mm_andnot_si128(keep, blended));
+	}
+#endif
+
+	template<bool rgbmod, bool alphamod, bool premultiplied>
+	static void additive(const byte *in, int inStep, byte *out, uint width, uint32 color) {
+		const uint ca = alphamod ? (color & 0xFF) : 255;
+		const uint cr = rgbmod ? ((color >> 24) & 0xFF) : 255;
+		const uint cg = rgbmod ? ((color >> 16) & 0xFF) : 255;
+		const uint cb = rgbmod ? ((color >> 8) & 0xFF) : 255;
+
+		for (uint x = 0; x < width; x++) {
+			const uint ina = in[kA] * ca >> 8;
+
+			if (ina != 0) {
+				const uint inw = premultiplied ? ca : ina;
+
+				if (cb != 255)
+					out[kB] = MIN<uint>(out[kB] + ((in[kB] * cb * inw) >> 16), 255u);
+				else
+					out[kB] = MIN<uint>(out[kB] + (in[kB] * inw >> 8), 255u);
+
+				if (cg != 255)
+					out[kG] = MIN<uint>(out[kG] + ((in[kG] * cg * inw) >> 16), 255u);
+				else
+					out[kG] = MIN<uint>(out[kG] + (in[kG] * inw >> 8), 255u);
+
+				if (cr != 255)
+					out[kR] = MIN<uint>(out[kR] + ((in[kR] * cr * inw) >> 16), 255u);
+				else
+					out[kR] = MIN<uint>(out[kR] + (in[kR] * inw >> 8), 255u);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	}
+
+	template<bool rgbmod, bool premultiplied>
+	static void subtractive(const byte *in, int inStep, byte *out, uint width, uint32 color) {
+		const int cr = rgbmod ? ((color >> 24) & 0xFF) : 255;
+		const int cg = rgbmod ? ((color >> 16) & 0xFF) : 255;
+		const int cb = rgbmod ? ((color >> 8) & 0xFF) : 255;
+
+		for (uint x = 0; x < width; x++) {
+			const int ina = premultiplied ? 255 : in[kA];
+
+			out[kA] = 255;
+			if (cb != 255)
+				out[kB] = MAX(out[kB] - ((in[kB] * cb * (out[kB]) * ina) >> 24), 0);
+			else
+				out[kB] = MAX(out[kB] - (in[kB] * (out[kB]) * ina >> 16), 0);
+
+			if (cg != 255)
+				out[kG] = MAX(out[kG] - ((in[kG] * cg * (out[kG]) * ina) >> 24), 0);
+			else
+				out[kG] = MAX(out[kG] - (in[kG] * (out[kG]) * ina >> 16), 0);
+
+			if (cr != 255)
+				out[kR] = MAX(out[kR] - ((in[kR] * cr * (out[kR]) * ina) >> 24), 0);
+			else
+				out[kR] = MAX(out[kR] - (in[kR] * (out[kR]) * ina >> 16), 0);
+
+			in += inStep;
+			out += 4;
+		}
+	}
+
+	template<bool rgbmod, bool alphamod, bool premultiplied>
+	static void multiply(const byte *in, int inStep, byte *out, uint width, uint32 color) {
+		const uint ca = alphamod ? (color & 0xFF) : 255;
+		const uint cr = rgbmod ? ((color >> 24) & 0xFF) : 255;
+		const uint cg = rgbmod ? ((color >> 16) & 0xFF) : 255;
+		const uint cb = rgbmod ? ((color >> 8) & 0xFF) : 255;
+
+		for (uint x = 0; x < width; x++) {
+			const uint ina = in[kA] * ca >> 8;
+
+			if (ina != 0) {
+				const uint inw = premultiplied ? ca : ina;
+
+				if (cb != 255)
+					out[kB] = MIN<uint>(out[kB] * ((in[kB] * cb * inw) >> 16) >> 8, 255u);
+				else
+					out[kB] = MIN<uint>(out[kB] * (in[kB] * inw >> 8) >> 8, 255u);
+
+				if (cg != 255)
+					out[kG] = MIN<uint>(out[kG] * ((in[kG] * cg * inw) >> 16) >> 8, 255u);
+				else
+					out[kG] = MIN<uint>(out[kG] * (in[kG] * inw >> 8) >> 8, 255u);
+
+				if (cr != 255)
+					out[kR] = MIN<uint>(out[kR] * ((in[kR] * cr * inw) >> 16) >> 8, 255u);
+				else
+					out[kR] = MIN<uint>(out[kR] * (in[kR] * inw >> 8) >> 8, 255u);
+			}
+
+			in += inStep;
+			out += 4;
+		}
+	}
+
+	/** Pick the span function for a set of blit parameters. */
+	static SpanFunc getSpanFunc(uint32 color, TSpriteBlendMode blendMode, AlphaType alphaType, bool premultiplied) {
+		const bool rgbmod = ((color & 0xFFFFFF00) != 0xFFFFFF00);
+		const bool alphamod = ((color & 0xFF) != 0xFF);
+
+		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaType == ALPHA_OPAQUE)
+			return &opaque;
+		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaType == ALPHA_BINARY)
+			return &binary;
+
+		if (premultiplied)
+			return getBlendFunc<true>(rgbmod, alphamod, blendMode);
+		else
+			return getBlendFunc<false>(rgbmod, alphamod, blendMode);
+	}
+
+	template<bool premultiplied>
+	static SpanFunc getBlendFunc(bool rgbmod, bool alphamod, TSpriteBlendMode blendMode) {
+#define PICK_SPAN_FUNC(FUNC) \
+		if (rgbmod) \
+			return alphamod ? &FUNC<true, true, premultiplied> : &FUNC<true, false, premultiplied>; \
+		else \
+			return alphamod ? &FUNC<false, true, premultiplied> : &FUNC<false, false, premultiplied>;
+
+		switch (blendMode) {
+		case BLEND_ADDITIVE:
+			PICK_SPAN_FUNC(additive)
+		case BLEND_SUBTRACTIVE:
+			return rgbmod ? &subtractive<true, premultiplied> : &subtractive<false, premultiplied>;
+		case BLEND_MULTIPLY:
+			PICK_SPAN_FUNC(multiply)
+		default:
+			assert(blendMode == BLEND_NORMAL);
+			PICK_SPAN_FUNC(alphaBlend)
+		}
+#undef PICK_SPAN_FUNC
+	}
+};
+
+/**
+ * Steps through the source positions src * srcSize / dstSize for
+ * consecutive values of dst, without a division per step.
+ */
+class ScaleStepper {
+public:
+	ScaleStepper(uint dst, uint srcSize, uint dstSize) :
+		_pos(dst * srcSize / dstSize), _rem(dst * srcSize % dstSize),
+		_step(srcSize / dstSize), _remStep(srcSize % dstSize), _dstSize(dstSize) {}
+
+	uint get() const { return _pos; }
+
+	void next() {
+		_pos += _step;
+		_rem += _remStep;
+		if (_rem >= _dstSize) {
+			_rem -= _dstSize;
+			_pos++;
+		}
+	}
+
+private:
+	uint _pos, _rem;
+	const uint _step, _remStep, _dstSize;
+};
+
+/** Linear interpolation of all four channels, with an 8 bit weight. */
+inline uint32 lerpPixel(uint32 a, uint32 b, uint w) {
+	const uint32 rb = ((a & 0x00FF00FF) * (256 - w) + (b & 0x00FF00FF) * w) >> 8;
+	const uint32 ag = ((a >> 8) & 0x00FF00FF) * (256 - w) + ((b >> 8) & 0x00FF00FF) * w;
+	return (rb & 0x00FF00FF) | (ag & 0xFF00FF00);
+}
+
+/**
+ * Position of a bilinear sample for the pixel centers of the scaled image,
+ * in 16.16 fixed point.
+ */
+class BilinearStepper {
+public:
+	BilinearStepper(uint dst, uint srcSize, uint dstSize) :
+		_step(((uint64)srcSize << 16) / dstSize), _max((srcSize - 1) << 16) {
+		_pos = (int64)dst * _step + _step / 2 - 0x8000;
+	}
+
+	uint getIndex() const { return clamp() >> 16; }
+	uint getNextIndex(uint srcSize) const { return MIN<uint>(getIndex() + 1, srcSize - 1); }
+	uint getWeight() const { return (clamp() & 0xFFFF) >> 8; }
+	void next() { _pos += _step; }
+
+private:
+	uint32 clamp() const { return (uint32)CLIP<int64>(_pos, 0, _max); }
+
+	int64 _pos;
+	const int64 _step, _max;
+};
+
+/**
+ * Blend the pixels first to first + count - 1 of a sprite row, skipping or
+ * copying whole runs where possible. Flipped rows are drawn from their end.
+ * With packed pixels, row is not used and transparent pixels read as 0.
+ */
+void blendRowRuns(SpanFunc span, const uint16 *runs, uint runCount, const byte *row,
+				  const uint32 *packed, int first, int count, bool flipX, byte *out, uint32 color,
+				  bool skipTransparent, bool copyOpaque) {
+	static const uint32 transparent = 0;
+
+	const int end = first + count;
+	int pos = 0;
+	for (uint i = 0; i < runCount && pos < end; i++) {
+		const int length = AlphaRuns::getLength(runs[i]);
+		const AlphaRuns::RunType type = AlphaRuns::getType(runs[i]);
+		const int start = MAX(pos, first);
+		const int stop = MIN(pos + length, end);
+
+		// The pixels of the run, addressed by their position in the row
+		const byte *in = row;
+		int inStep = 4;
+		if (packed) {
+			if (type == AlphaRuns::kRunTransparent) {
+				in = (const byte *)&transparent;
+				inStep = 0;
+			} else {
+				in = (const byte *)(packed - pos);
+				packed += length;
+			}
+		}
+		pos += length;
+
+		if (start >= stop)
+			continue;
+
+		if (type == AlphaRuns::kRunTransparent && skipTransparent)
+			continue;
+
+		const int n = stop - start;
+		const bool copy = (type == AlphaRuns::kRunOpaque && copyOpaque);
+		if (!inStep) {
+			byte *o = out + (flipX ? end - stop : start - first) * 4;
+			span(in, 0, o, n, color);
+		} else if (!flipX) {
+			byte *o = out + (start - first) * 4;
+			if (copy)
+				memcpy(o, in + start * 4, n * 4);
+			else
+				span(in + start * 4, 4, o, n, color);
+		} else {
+			// The last pixel of the run is the leftmost one drawn
+			uint32 *o = (uint32 *)(out + (end - stop) * 4);
+			if (copy) {
+				const uint32 *p = (const uint32 *)in + stop - 1;
+				for (int x = 0; x < n; x++)
+					o[x] = *p--;
+			} else {
+				span(in + (stop - 1) * 4, -4, (byte *)o, n, color);
+			}
+		}
+	}
+}
+
+enum {
+	/** Number of scaled pixels gathered at once. */
+	kSpanChunk = 256
+};
+
+template<int kA, int kR, int kG, int kB>
+void blendBlitLogic(byte *dst, const byte *src,
+					const uint dstPitch, const uint srcPitch,
+					const uint srcW, const uint srcH,
+					const uint scaledW, const uint scaledH,
+					const int areaX, const int areaY,
+					const uint areaW, const uint areaH,
+					const uint32 color, const int flip,
+					const TSpriteBlendMode blendMode, const AlphaType alphaType,
+					const bool filtering, const bool premultiplied,
+					const AlphaRuns *runs, const int runsX, const int runsY) {
+	typedef BlendSpans<kA, kR, kG, kB> Spans;
+	const SpanFunc span = Spans::getSpanFunc(color, blendMode, alphaType, premultiplied);
+
+	const bool flipX = (flip & FLIP_H) != 0;
+	const bool flipY = (flip & FLIP_V) != 0;
+
+	// Unscaled images with known runs only look at the pixels which matter.
+	if (runs && srcW == scaledW && srcH == scaledH) {
+		const bool opaqueSpan = (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaType == ALPHA_OPAQUE);
+		// Subtractive blending makes the destination opaque even below transparent pixels
+		const bool skipTransparent = !opaqueSpan && blendMode != BLEND_SUBTRACTIVE;
+		const bool copyOpaque = (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL);
+		const int first = runsX + (flipX ? srcW - areaX - areaW : areaX);
+
+		for (uint y = 0; y < areaH; y++) {
+			const int srcY = flipY ? srcH - 1 - (areaY + y) : areaY + y;
+			const int runsRow = runsY + srcY;
+			if (runs->hasPackedPixels()) {
+				blendRowRuns(span, runs->getRuns(runsRow), runs->getRunCount(runsRow),
+				             nullptr, runs->getPackedPixels(runsRow), first, areaW, flipX,
+				             dst + y * dstPitch, color, skipTransparent, copyOpaque);
+			} else {
+				blendRowRuns(span, runs->getRuns(runsRow), runs->getRunCount(runsRow),
+				             src + srcY * srcPitch - runsX * 4, nullptr, first, areaW, flipX,
+				             dst + y * dstPitch, color, skipTransparent, copyOpaque);
+			}
+		}
+		return;
+	}
+
+	// Unscaled images are read straight from the source.
+	if (srcW == scaledW && srcH == scaledH) {
+		const int inStep = flipX ? -4 : 4;
+		const int startX = flipX ? srcW - 1 - areaX : areaX;
+		for (uint y = 0; y < areaH; y++) {
+			const int srcY = flipY ? srcH - 1 - (areaY + y) : areaY + y;
+			span(src + srcY * srcPitch + startX * 4, inStep, dst + y * dstPitch, areaW, color);
+		}
+		return;
+	}
+
+	// Scaled images are gathered into a small buffer, chunk by chunk.
+	uint32 buffer[kSpanChunk];
+
+	for (uint y = 0; y < areaH; y++) {
+		const uint scaledY = flipY ? scaledH - 1 - (areaY + y) : areaY + y;
+
+		const byte *row0, *row1 = nullptr;
+		uint weightY = 0;
+		if (filtering) {
+			BilinearStepper stepY(scaledY, srcH, scaledH);
+			row0 = src + stepY.getIndex() * srcPitch;
+			row1 = src + stepY.getNextIndex(srcH) * srcPitch;
+			weightY = stepY.getWeight();
+		} else {
+			row0 = src + (scaledY * srcH / scaledH) * srcPitch;
+		}
+
+		for (uint x = 0; x < areaW; x += kSpanChunk) {
+			const uint count = MIN<uint>(kSpanChunk, areaW - x);
+
+			// The scaled pixels covered by this chunk, in source order
+			const uint first = flipX ? scaledW - (areaX + x + count) : areaX + x;
+
+			if (filtering) {
+				BilinearStepper stepX(first, srcW, scaledW);
+				for (uint i = 0; i < count; i++, stepX.next()) {
+					const uint x0 = stepX.getIndex(), x1 = stepX.getNextIndex(srcW);
+					const uint weightX = stepX.getWeight();
+					const uint32 top = lerpPixel(((const uint32 *)row0)[x0], ((const uint32 *)row0)[x1], weightX);
+					const uint32 bottom = lerpPixel(((const uint32 *)row1)[x0], ((const uint32 *)row1)[x1], weightX);
+					buffer[flipX ? count - 1 - i : i] = lerpPixel(top, bottom, weightY);
+				}
+			} else {
+				ScaleStepper stepX(first, srcW, scaledW);
+				for (uint i = 0; i < count; i++, stepX.next())
+					buffer[flipX ? count - 1 - i : i] = ((const uint32 *)row0)[stepX.get()];
+			}
+
+			span((const byte *)buffer, 4, dst + y * dstPitch + x * 4, count, color);
+		}
+	}
+}
+
+/** The offset of a channel within a 32 bit pixel in memory. */
+inline int getChannelOffset(uint8 shift) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	return shift / 8;
+#else
+	return 3 - shift / 8;
+#endif
+}
+
+} // End of anonymous namespace
+
+bool blendBlit(byte *dst, const byte *src,
+			   const uint dstPitch, const uint srcPitch,
+			   const uint srcW, const uint srcH,
+			   const uint scaledW, const uint scaledH,
+			   const int areaX, const int areaY,
+			   const uint areaW, const uint areaH,
+			   const Graphics::PixelFormat &fmt,
+			   const uint32 color, const int flip,
+			   const TSpriteBlendMode blendMode, const AlphaType alphaType,
+			   const bool filtering, const bool premultiplied,
+			   const AlphaRuns *runs, const int runsX, const int runsY) {
+	if (fmt.bytesPerPixel != 4 || fmt.rLoss || fmt.gLoss || fmt.bLoss || fmt.aLoss ||
+	    (fmt.rShift | fmt.gShift | fmt.bShift | fmt.aShift) & 7)
+		return false;
+
+	if (!srcW || !srcH || !scaledW || !scaledH)
+		return false;
+
+	assert(areaX >= 0 && areaY >= 0 && areaX + areaW <= scaledW && areaY + areaH <= scaledH);
+	assert(!runs || (runsX >= 0 && runsY >= 0));
+
+	// Nothing is drawn without coverage
+	if ((color & 0xFF) == 0 || !areaW || !areaH)
+		return true;
+
+	const int a = getChannelOffset(fmt.aShift);
+	const int r = getChannelOffset(fmt.rShift);
+	const int g = getChannelOffset(fmt.gShift);
+	const int b = getChannelOffset(fmt.bShift);
+
+#define BLEND_BLIT(A, R, G, B) \
+	if (a == A && r == R && g == G && b == B) { \
+		blendBlitLogic<A, R, G, B>(dst, src, dstPitch, srcPitch, srcW, srcH, scaledW, scaledH, \
+		                           areaX, areaY, areaW, areaH, color, flip, blendMode, alphaType, filtering, \
+		                           premultiplied, runs, runsX, runsY); \
+		return true; \
+	}
+
+	// The layouts of TransparentSurface and of the usual ARGB screens
+	BLEND_BLIT(0, 3, 2, 1)
+	BLEND_BLIT(3, 2, 1, 0)
+	BLEND_BLIT(3, 0, 1, 2)
+	BLEND_BLIT(0, 1, 2, 3)
+#undef BLEND_BLIT
+
+	return false;
+}
+
+} // End of namespace Graphics
@@ -58,6 +58,7 @@ void Surface::free() {
 		::free(pixels);
 
 	pixels = 0;
+	pixelGeneration++;
 	w = h = pitch = 0;
 	format = PixelFormat();
 }
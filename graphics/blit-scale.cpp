@@ -31,6 +31,11 @@
 #include "common/math.h"
 #include "common/rect.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALE_BILINEAR_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Graphics {
 
 namespace {
@@ -171,6 +176,85 @@ Size scaleBlitBilinearInterpolate(Size c01, Size c00, Size c11, Size c10, int ex
 	return fmt.ARGBToColorT<ColorMask>(dp_a, dp_r, dp_g, dp_b);
 }
 
+/**
+ * Tag for 32 bit formats with four 8 bit channels on byte boundaries. These
+ * are interpolated byte by byte, without unpacking the channels.
+ */
+struct ByteChannels {};
+
+inline bool hasByteChannels(const Graphics::PixelFormat &fmt) {
+	return fmt.bytesPerPixel == 4 && fmt.aBits() == 8 && fmt.rBits() == 8 && fmt.gBits() == 8 && fmt.bBits() == 8 &&
+	       !((fmt.aShift | fmt.rShift | fmt.gShift | fmt.bShift) & 7);
+}
+
+#ifdef SCALE_BILINEAR_SSE2
+/** The upper half of the products of signed 16 bit lanes with an unsigned 16 bit factor. */
+inline __m128i mulhiSignedUnsigned(__m128i value, __m128i factor) {
+	// The factor is read as signed, which is 65536 too little for values
+	// from 32768 on; add the missing value * 65536 >> 16 back.
+	return _mm_add_epi16(_mm_mulhi_epi16(value, factor), _mm_and_si128(value, _mm_srai_epi16(factor, 15)));
+}
+#endif
+
+template <>
+inline uint32 scaleBlitBilinearInterpolate<ByteChannels, uint32>(uint32 c01, uint32 c00, uint32 c11, uint32 c10, int ex, int ey,
+																  const Graphics::PixelFormat &fmt) {
+#ifdef SCALE_BILINEAR_SSE2
+	// The top pixels go to the lower lanes, the bottom ones to the upper lanes.
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i left = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(c00), _mm_cvtsi32_si128(c10)), zero);
+	const __m128i right = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(c01), _mm_cvtsi32_si128(c11)), zero);
+
+	const __m128i t = _mm_add_epi16(left, mulhiSignedUnsigned(_mm_sub_epi16(right, left), _mm_set1_epi16((int16)ex)));
+	const __m128i d = _mm_sub_epi16(_mm_srli_si128(t, 8), t);
+	const __m128i result = _mm_add_epi16(t, mulhiSignedUnsigned(d, _mm_set1_epi16((int16)ey)));
+
+	return (uint32)_mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+#else
+	uint32 result = 0;
+	for (int shift = 0; shift < 32; shift += 8) {
+		result |= (uint32)scaleBlitBilinearInterpolate((byte)(c01 >> shift), (byte)(c00 >> shift),
+		                                               (byte)(c11 >> shift), (byte)(c10 >> shift), ex, ey) << shift;
+	}
+	return result;
+#endif
+}
+
+/** Division rounding towards negative infinity, for positive divisors. */
+inline int64 floorDiv(int64 a, int64 b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * Find the range of steps x for which (start + x * step) >> 16 lies within
+ * [lo, hi], narrowing [first, last). The range may end up empty.
+ */
+inline void clipSpan(int64 start, int64 step, int lo, int hi, int &first, int &last) {
+	const int64 minPos = (int64)lo << 16;
+	const int64 maxPos = ((int64)hi << 16) + 0xFFFF;
+
+	if (step == 0) {
+		if (start < minPos || start > maxPos)
+			last = first;
+		return;
+	}
+
+	int64 from, to;
+	if (step > 0) {
+		from = -floorDiv(start - minPos, step);
+		to = floorDiv(maxPos - start, step);
+	} else {
+		from = -floorDiv(maxPos - start, -step);
+		to = floorDiv(start - minPos, -step);
+	}
+
+	// to is inclusive
+	first = (int)MAX<int64>(first, from);
+	last = (int)MIN<int64>(last, to + 1);
+	if (last < first)
+		last = first;
+}
+
 template <typename ColorMask, typename Size>
 void scaleBlitBilinearLogic(byte *dst, const byte *src,
 							const uint dstPitch, const uint srcPitch,
@@ -300,13 +384,28 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 	int sw = srcW - 1;
 	int sh = srcH - 1;
 
-	Size *pc = (Size *)dst;
+	// The source positions which can be sampled, before flipping
+	const int loX = (filtering && flipx) ? 1 : 0;
+	const int hiX = (filtering && !flipx) ? sw - 1 : sw;
+	const int loY = (filtering && flipy) ? 1 : 0;
+	const int hiY = (filtering && !flipy) ? sh - 1 : sh;
 
 	for (uint y = 0; y < dstH; y++) {
 		int t = cy - y;
 		int sdx = ax + (isinx * t) + xd;
 		int sdy = ay - (icosy * t) + yd;
-		for (uint x = 0; x < dstW; x++) {
+
+		// Skip the parts of the row which map to outside of the source
+		// up front, instead of checking every pixel.
+		int first = 0, last = dstW;
+		clipSpan(sdx, icosx, loX, hiX, first, last);
+		clipSpan(sdy, isiny, loY, hiY, first, last);
+
+		Size *pc = (Size *)(dst + y * dstPitch) + first;
+		sdx += icosx * first;
+		sdy += isiny * first;
+
+		for (int x = first; x < last; x++) {
 			int dx = (sdx >> 16);
 			int dy = (sdy >> 16);
 			if (flipx) {
@@ -316,37 +415,32 @@ void rotoscaleBlitLogic(byte *dst, const byte *src,
 				dy = sh - dy;
 			}
 
+			const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
 			if (filtering) {
-				if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
-					const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
-					Size c00, c01, c10, c11;
-					c00 = *(const Size *)sp;
-					sp += sizeof(Size);
-					c01 = *(const Size *)sp;
-					sp += srcPitch;
-					c11 = *(const Size *)sp;
-					sp -= sizeof(Size);
-					c10 = *(const Size *)sp;
-					if (flipx) {
-						SWAP(c00, c01);
-						SWAP(c10, c11);
-					}
-					if (flipy) {
-						SWAP(c00, c10);
-						SWAP(c01, c11);
-					}
-					/*
-					* Interpolate colors
-					*/
-					int ex = (sdx & 0xffff);
-					int ey = (sdy & 0xffff);
-					*pc = scaleBlitBilinearInterpolate<ColorMask, Size>(c01, c00, c11, c10, ex, ey, fmt);
+				Size c00, c01, c10, c11;
+				c00 = *(const Size *)sp;
+				sp += sizeof(Size);
+				c01 = *(const Size *)sp;
+				sp += srcPitch;
+				c11 = *(const Size *)sp;
+				sp -= sizeof(Size);
+				c10 = *(const Size *)sp;
+				if (flipx) {
+					SWAP(c00, c01);
+					SWAP(c10, c11);
 				}
-			} else {
-				if ((dx >= 0) && (dy >= 0) && (dx < (int)srcW) && (dy < (int)srcH)) {
-					const byte *sp = src + dy * srcPitch + dx * sizeof(Size);
-					*pc = *(const Size *)sp;
+				if (flipy) {
+					SWAP(c00, c10);
+					SWAP(c01, c11);
 				}
+				/*
+				* Interpolate colors
+				*/
+				int ex = (sdx & 0xffff);
+				int ey = (sdy & 0xffff);
+				*pc = scaleBlitBilinearInterpolate<ColorMask, Size>(c01, c00, c11, c10, ex, ey, fmt);
+			} else {
+				*pc = *(const Size *)sp;
 			}
 			sdx += icosx;
 			sdy += isiny;
@@ -410,8 +504,8 @@ bool scaleBlitBilinear(byte *dst, const byte *src,
 		}
 	}
 
-	if (fmt == createPixelFormat<8888>()) {
-		scaleBlitBilinearLogic<ColorMasks<8888>, uint32>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, flip);
+	if (hasByteChannels(fmt)) {
+		scaleBlitBilinearLogic<ByteChannels, uint32>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, flip);
 	} else if (fmt == createPixelFormat<888>()) {
 		scaleBlitBilinearLogic<ColorMasks<888>,  uint32>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, sax, say, flip);
 	} else if (fmt == createPixelFormat<565>()) {
@@ -463,8 +557,8 @@ bool rotoscaleBlitBilinear(byte *dst, const byte *src,
 						   const Graphics::PixelFormat &fmt,
 						   const TransformStruct &transform,
 						   const Common::Point &newHotspot) {
-	if (fmt == createPixelFormat<8888>()) {
-		rotoscaleBlitLogic<ColorMasks<8888>, uint32, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
+	if (hasByteChannels(fmt)) {
+		rotoscaleBlitLogic<ByteChannels, uint32, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 	} else if (fmt == createPixelFormat<888>()) {
 		rotoscaleBlitLogic<ColorMasks<888>,  uint32, true>(dst, src, dstPitch, srcPitch, dstW, dstH, srcW, srcH, fmt, transform, newHotspot);
 	} else if (fmt == createPixelFormat<565>()) {
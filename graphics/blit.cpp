@@ -22,6 +22,8 @@
 #include "graphics/blit.h"
 #include "graphics/pixelformat.h"
 
+#include "common/endian.h"
+
 namespace Graphics {
 
 // see graphics/blit-atari.cpp, Atari Falcon's SuperVidel addon allows accelerated blitting
@@ -156,6 +158,41 @@ inline void crossBlitLogic1BppSource(byte *dst, const byte *src, const uint w, c
 	}
 }
 
+/**
+ * Palette lookup for non overlapping buffers. The indices are read four at
+ * a time, which lets the lookups and stores be scheduled independently of
+ * each other.
+ */
+template<typename DstColor>
+inline void crossBlitLogic1BppSourceForward(byte *dst, const byte *src, const uint w, const uint h,
+											const uint srcPitch, const uint dstPitch, const uint32 *map) {
+	for (uint y = 0; y < h; ++y) {
+		const byte *s = src;
+		DstColor *d = (DstColor *)dst;
+
+		uint x = 0;
+		for (; x + 4 <= w; x += 4) {
+			const uint32 colors = READ_UINT32(s + x);
+#ifdef SCUMM_LITTLE_ENDIAN
+			d[x + 0] = map[colors & 0xFF];
+			d[x + 1] = map[(colors >> 8) & 0xFF];
+			d[x + 2] = map[(colors >> 16) & 0xFF];
+			d[x + 3] = map[colors >> 24];
+#else
+			d[x + 0] = map[colors >> 24];
+			d[x + 1] = map[(colors >> 16) & 0xFF];
+			d[x + 2] = map[(colors >> 8) & 0xFF];
+			d[x + 3] = map[colors & 0xFF];
+#endif
+		}
+		for (; x < w; ++x)
+			d[x] = map[s[x]];
+
+		src += srcPitch;
+		dst += dstPitch;
+	}
+}
+
 template<typename DstColor, bool backward, bool hasKey>
 inline void crossBlitLogic3BppSource(byte *dst, const byte *src, const uint w, const uint h,
 									 const PixelFormat &srcFmt, const PixelFormat &dstFmt,
@@ -320,6 +357,20 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if ((bytesPerPixel == 3) || (!bytesPerPixel))
 		return false;
 
+	// When converting between separate buffers, which is the common case
+	// for palette conversion, there is no need to care about the order.
+	if (dst + h * dstPitch <= src || src + h * srcPitch <= dst) {
+		if (bytesPerPixel == 1)
+			crossBlitLogic1BppSourceForward<uint8>(dst, src, w, h, srcPitch, dstPitch, map);
+		else if (bytesPerPixel == 2)
+			crossBlitLogic1BppSourceForward<uint16>(dst, src, w, h, srcPitch, dstPitch, map);
+		else if (bytesPerPixel == 4)
+			crossBlitLogic1BppSourceForward<uint32>(dst, src, w, h, srcPitch, dstPitch, map);
+		else
+			return false;
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
@@ -23,6 +23,7 @@
 #define GRAPHICS_BLIT_H
 
 #include "graphics/pixelformat.h"
+#include "graphics/transform_struct.h"
 
 namespace Common {
 struct Point;
@@ -39,7 +40,7 @@ namespace Graphics {
  * @{
  */
 
-struct TransformStruct;
+class AlphaRuns;
 
 /** Converting a palette for use with crossBlitMap(). */
 inline static void convertPaletteToMap(uint32 *dst, const byte *src, uint colors, const Graphics::PixelFormat &format) {
@@ -176,6 +177,55 @@ bool rotoscaleBlitBilinear(byte *dst, const byte *src,
 						   const Graphics::PixelFormat &fmt,
 						   const TransformStruct &transform,
 						   const Common::Point &newHotspot);
+
+/**
+ * Blends a sprite onto a surface, with color modulation, scaling and
+ * flipping done in a single pass.
+ *
+ * The sprite is scaled to scaledW x scaledH and flipped; the part of this
+ * transformed image given by areaX, areaY, areaW and areaH is drawn at dst.
+ * Source and destination share the pixel format, which has to be a 32 bit
+ * one with 8 bits per channel.
+ *
+ * @param dst			the first pixel of the destination area
+ * @param src			the top left pixel of the unscaled sprite
+ * @param dstPitch		width in bytes of one full line of the dest buffer
+ * @param srcPitch		width in bytes of one full line of the source buffer
+ * @param srcW			the width of the sprite
+ * @param srcH			the height of the sprite
+ * @param scaledW		the width the sprite is scaled to
+ * @param scaledH		the height the sprite is scaled to
+ * @param areaX			the left edge of the drawn area within the scaled sprite
+ * @param areaY			the top edge of the drawn area within the scaled sprite
+ * @param areaW			the width of the drawn area
+ * @param areaH			the height of the drawn area
+ * @param fmt			the pixel format of source and destination
+ * @param color			color modulation in TS_ARGB layout, 0xFFFFFFFF for none
+ * @param flip			a combination of FLIP_FLAGS
+ * @param blendMode		how the sprite is combined with the destination
+ * @param alphaType		the kind of alpha channel the sprite has
+ * @param filtering		whether to use bilinear filtering when scaling
+ * @param premultiplied	whether the colors of the sprite are premultiplied by its alpha
+ * @param runs			optional alpha runs of the sprite, used by unscaled blits
+ *						to skip transparent and copy opaque pixels in bulk. If
+ *						the runs have packed pixels, these are drawn instead of
+ *						src, which then may be nullptr.
+ * @param runsX			the left edge of src within the sprite the runs describe
+ * @param runsY			the top edge of src within the sprite the runs describe
+ * @return false if the pixel format is not supported
+ */
+bool blendBlit(byte *dst, const byte *src,
+			   const uint dstPitch, const uint srcPitch,
+			   const uint srcW, const uint srcH,
+			   const uint scaledW, const uint scaledH,
+			   const int areaX, const int areaY,
+			   const uint areaW, const uint areaH,
+			   const Graphics::PixelFormat &fmt,
+			   const uint32 color = 0xFFFFFFFF, const int flip = FLIP_NONE,
+			   const TSpriteBlendMode blendMode = BLEND_NORMAL,
+			   const AlphaType alphaType = ALPHA_FULL,
+			   const bool filtering = false, const bool premultiplied = false,
+			   const AlphaRuns *runs = nullptr, const int runsX = 0, const int runsY = 0);
 /** @} */
 } // End of namespace Graphics
 
@@ -20,7 +20,9 @@
  */
 
 #include "graphics/framelimiter.h"
+#include "graphics/frametimings.h"
 
+#include "common/debug.h"
 #include "common/util.h"
 
 namespace Graphics {
@@ -29,7 +31,9 @@ FrameLimiter::FrameLimiter(OSystem *system, const uint framerate) :
 		_system(system),
 		_speedLimitMs(0),
 		_startFrameTime(0),
-		_lastFrameDurationMs(_speedLimitMs) {
+		_lastFrameDurationMs(_speedLimitMs),
+		_lastDelayMs(0),
+		_lateFrames(0) {
 	// The frame limiter is disabled when vsync is enabled.
 	_enabled = !_system->getFeatureState(OSystem::kFeatureVSync) && framerate != 0;
 
@@ -52,9 +56,16 @@ void FrameLimiter::delayBeforeSwap() {
 	uint endFrameTime = _system->getMillis();
 	uint frameDuration = endFrameTime - _startFrameTime;
 
+	_lastDelayMs = 0;
 	if (_enabled && frameDuration < _speedLimitMs) {
-		_system->delayMillis(_speedLimitMs - frameDuration);
+		_lastDelayMs = _speedLimitMs - frameDuration;
+		_system->delayMillis(_lastDelayMs);
+	} else if (_enabled && frameDuration > _speedLimitMs) {
+		++_lateFrames;
+		debug(9, "FrameLimiter: Frame took %u ms instead of %u ms", frameDuration, _speedLimitMs);
 	}
+
+	FrameTimings::reportFrameLimiter(getLastDelay(), getLateFrames());
 }
 
 void FrameLimiter::pause(bool pause) {
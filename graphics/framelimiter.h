@@ -44,6 +44,12 @@ public:
 	void pause(bool pause);
 
 	uint getLastFrameDuration() const;
+
+	/** How long the last call to delayBeforeSwap() waited, in milliseconds. */
+	uint getLastDelay() const { return _lastDelayMs; }
+
+	/** Number of frames which took longer than the frame rate allows. */
+	uint getLateFrames() const { return _lateFrames; }
 private:
 	OSystem *_system;
 
@@ -51,6 +57,8 @@ private:
 	uint _speedLimitMs;
 	uint _startFrameTime;
 	uint _lastFrameDurationMs;
+	uint _lastDelayMs;
+	uint _lateFrames;
 };
 
 } // End of namespace Graphics
@@ -0,0 +1,223 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/frametimings.h"
+#include "graphics/surface.h"
+
+#include "common/rect.h"
+#include "common/stream.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Graphics {
+
+/** The enabled instance the frame limiter reports to. */
+static FrameTimings *s_limiterTarget = nullptr;
+
+FrameTimings::FrameTimings() : _enabled(false), _limiterLateFrames(0) {
+	clear();
+}
+
+FrameTimings::~FrameTimings() {
+	if (s_limiterTarget == this)
+		s_limiterTarget = nullptr;
+}
+
+void FrameTimings::setEnabled(bool enabled) {
+	if (enabled == _enabled)
+		return;
+
+	_enabled = enabled;
+	if (enabled)
+		s_limiterTarget = this;
+	else if (s_limiterTarget == this)
+		s_limiterTarget = nullptr;
+
+	// Don't count the time while disabled towards the next frame.
+	memset(&_current, 0, sizeof(_current));
+	_current.start = g_system->getMicros();
+	_activeCount = 0;
+}
+
+void FrameTimings::clear() {
+	memset(_frames, 0, sizeof(_frames));
+	memset(&_current, 0, sizeof(_current));
+	memset(_phaseStart, 0, sizeof(_phaseStart));
+	_activeCount = 0;
+	_next = 0;
+	_count = 0;
+}
+
+const FrameTimings::Frame &FrameTimings::getFrame(uint index) const {
+	assert(index < _count);
+	return _frames[(_next + kHistorySize - _count + index) % kHistorySize];
+}
+
+void FrameTimings::startPhaseImpl(Phase phase) {
+	const uint64 now = g_system->getMicros();
+
+	// Pause the enclosing phase until this one ends.
+	if (_activeCount > 0) {
+		const Phase outer = _activePhases[_activeCount - 1];
+		_current.phases[outer] += (uint32)(now - _phaseStart[outer]);
+	}
+
+	if (_activeCount < kPhaseCount)
+		_activePhases[_activeCount++] = phase;
+	_phaseStart[phase] = now;
+}
+
+void FrameTimings::endPhaseImpl(Phase phase) {
+	// Timing may have been enabled in the middle of the phase.
+	if (_activeCount == 0 || _activePhases[_activeCount - 1] != phase)
+		return;
+
+	const uint64 now = g_system->getMicros();
+	_current.phases[phase] += (uint32)(now - _phaseStart[phase]);
+
+	// Resume the enclosing phase.
+	if (--_activeCount > 0)
+		_phaseStart[_activePhases[_activeCount - 1]] = now;
+}
+
+void FrameTimings::reportFrameLimiter(uint delayMs, uint lateFrames) {
+	FrameTimings *timings = s_limiterTarget;
+	if (!timings)
+		return;
+
+	timings->_current.phases[kPhaseWait] += delayMs * 1000;
+	// A new limiter starts counting from 0 again.
+	if (lateFrames > timings->_limiterLateFrames)
+		timings->_current.late = true;
+	timings->_limiterLateFrames = lateFrames;
+}
+
+void FrameTimings::endFrameImpl() {
+	const uint64 now = g_system->getMicros();
+	_current.duration = (uint32)(now - _current.start);
+
+	uint32 covered = 0;
+	for (int i = kPhaseEngine + 1; i < kPhaseCount; ++i)
+		covered += _current.phases[i];
+	_current.phases[kPhaseEngine] = _current.duration > covered ? _current.duration - covered : 0;
+
+	_frames[_next] = _current;
+	_next = (_next + 1) % kHistorySize;
+	if (_count < kHistorySize)
+		++_count;
+
+	memset(&_current, 0, sizeof(_current));
+	_current.start = now;
+}
+
+bool FrameTimings::writeCSV(Common::WriteStream &stream) const {
+	Common::String line = "frame,start,duration";
+	for (int i = 0; i < kPhaseCount; ++i)
+		line += Common::String::format(",%s", getPhaseName((Phase)i));
+	stream.writeString(line + ",late\n");
+
+	for (uint i = 0; i < _count; ++i) {
+		const Frame &frame = getFrame(i);
+		line = Common::String::format("%u,%llu,%u", i, (unsigned long long)frame.start, frame.duration);
+		for (int j = 0; j < kPhaseCount; ++j)
+			line += Common::String::format(",%u", frame.phases[j]);
+		stream.writeString(line + (frame.late ? ",1\n" : ",0\n"));
+	}
+
+	return !stream.err();
+}
+
+void FrameTimings::drawGraph(Surface &dst) const {
+	static const byte colors[kPhaseCount][3] = {
+		{ 128, 128, 128 }, // Engine
+		{ 255, 224,  64 }, // CopyRect
+		{  48,  48,  48 }, // Wait
+		{ 255,  96,  32 }, // Scale
+		{ 224,  64, 224 }, // Cursor
+		{ 224, 224, 224 }, // Graph
+		{  64, 224,  64 }, // Upload
+		{  64, 128, 255 }  // Present
+	};
+
+	uint32 phaseColors[kPhaseCount];
+	for (int i = 0; i < kPhaseCount; ++i)
+		phaseColors[i] = dst.format.ARGBToColor(255, colors[i][0], colors[i][1], colors[i][2]);
+
+	const uint32 red = dst.format.ARGBToColor(255, 255, 0, 0);
+
+	dst.fillRect(Common::Rect(dst.w, dst.h), dst.format.ARGBToColor(160, 0, 0, 0));
+
+	const int columns = MIN<int>(dst.w, _count);
+	for (int x = 0; x < columns; ++x) {
+		const Frame &frame = getFrame(_count - columns + x);
+		const int column = dst.w - columns + x;
+
+		// Stack the phases from the bottom up, in the order they happen.
+		uint32 elapsed = 0;
+		int y = dst.h;
+		for (int i = 0; i < kPhaseCount && y > 0; ++i) {
+			elapsed += frame.phases[i];
+			const int top = dst.h - (int)MIN<uint64>((uint64)elapsed * dst.h / kGraphRange, dst.h);
+			if (top < y)
+				dst.vLine(column, top, y - 1, phaseColors[i]);
+			y = top;
+		}
+
+		// Mark the frames the frame limiter found late at the top.
+		if (frame.late)
+			dst.vLine(column, 0, MIN(1, dst.h - 1), red);
+	}
+
+	// Mark the durations of frames at 60 and 30 frames per second.
+	const uint32 white = dst.format.ARGBToColor(255, 255, 255, 255);
+	const uint32 targets[] = { 1000000 / 60, 1000000 / 30 };
+	for (uint i = 0; i < ARRAYSIZE(targets); ++i) {
+		const int y = dst.h - (int)(targets[i] * dst.h / kGraphRange);
+		if (y >= 0 && y < dst.h)
+			dst.hLine(0, y, dst.w - 1, white);
+	}
+}
+
+const char *FrameTimings::getPhaseName(Phase phase) {
+	switch (phase) {
+	case kPhaseEngine:
+		return "engine";
+	case kPhaseCopyRect:
+		return "copyrect";
+	case kPhaseWait:
+		return "wait";
+	case kPhaseScale:
+		return "scale";
+	case kPhaseCursor:
+		return "cursor";
+	case kPhaseGraph:
+		return "graph";
+	case kPhaseUpload:
+		return "upload";
+	case kPhasePresent:
+		return "present";
+	default:
+		return "unknown";
+	}
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,157 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_FRAMETIMINGS_H
+#define GRAPHICS_FRAMETIMINGS_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+class WriteStream;
+}
+
+namespace Graphics {
+
+struct Surface;
+
+/**
+ * Records how long the recent frames took, split into the stages a frame
+ * passes through, so that dropped frames can be attributed to the right one.
+ *
+ * Graphics managers wrap their work in startPhase()/endPhase() pairs and call
+ * endFrame() once a frame has been presented. Phases may be nested, the time
+ * of the inner phase is then not counted towards the outer one. Time not
+ * covered by any phase is attributed to the engine.
+ */
+class FrameTimings {
+public:
+	enum Phase {
+		kPhaseEngine,    ///< Everything outside of the graphics manager
+		kPhaseCopyRect,  ///< copyRectToScreen() and similar calls
+		kPhaseWait,      ///< Sleeping in Graphics::FrameLimiter
+		kPhaseScale,     ///< Scaling and conversion on the CPU
+		kPhaseCursor,    ///< Scaling, drawing and removing the mouse cursor
+		kPhaseGraph,     ///< Drawing the graph of the frame timings
+		kPhaseUpload,    ///< Uploading to textures
+		kPhasePresent,   ///< Drawing and presenting the frame
+		kPhaseCount
+	};
+
+	enum {
+		/** Number of frames kept. */
+		kHistorySize = 256
+	};
+
+	struct Frame {
+		/** Time the frame started, as returned by OSystem::getMicros(). */
+		uint64 start;
+		/** Duration of the whole frame in microseconds. */
+		uint32 duration;
+		/** Durations of the single phases in microseconds. */
+		uint32 phases[kPhaseCount];
+		/** Whether the frame limiter found the frame took longer than its time slot. */
+		bool late;
+	};
+
+	FrameTimings();
+	~FrameTimings();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return _enabled; }
+
+	/**
+	 * Start timing a phase. A phase may be timed several times per frame,
+	 * the durations add up.
+	 */
+	void startPhase(Phase phase) {
+		if (_enabled)
+			startPhaseImpl(phase);
+	}
+
+	void endPhase(Phase phase) {
+		if (_enabled)
+			endPhaseImpl(phase);
+	}
+
+	/** Finish the current frame and start the next one. */
+	void endFrame() {
+		if (_enabled)
+			endFrameImpl();
+	}
+
+	/** Forget all recorded frames. */
+	void clear();
+
+	/** Number of recorded frames, at most kHistorySize. */
+	uint size() const { return _count; }
+
+	/** Get a recorded frame, 0 being the oldest one. */
+	const Frame &getFrame(uint index) const;
+
+	/** Write all recorded frames as CSV, one line per frame. */
+	bool writeCSV(Common::WriteStream &stream) const;
+
+	/**
+	 * Draw the most recent frames as a bar graph with one column per frame,
+	 * newest on the right. The full height corresponds to kGraphRange.
+	 */
+	void drawGraph(Surface &dst) const;
+
+	static const char *getPhaseName(Phase phase);
+
+	/**
+	 * Report the state of a Graphics::FrameLimiter to the enabled instance,
+	 * if there is one. The delay is added to kPhaseWait of the current
+	 * frame, which is marked as late if the late frame count went up.
+	 *
+	 * @param delayMs    How long the limiter slept before the swap.
+	 * @param lateFrames The number of late frames the limiter counted so far.
+	 */
+	static void reportFrameLimiter(uint delayMs, uint lateFrames);
+
+	/** Frame duration in microseconds shown by the full height of the graph. */
+	static const uint32 kGraphRange = 50000;
+
+private:
+	void startPhaseImpl(Phase phase);
+	void endPhaseImpl(Phase phase);
+	void endFrameImpl();
+
+	bool _enabled;
+
+	Frame _frames[kHistorySize];
+	uint _next;
+	uint _count;
+
+	Frame _current;
+	uint64 _phaseStart[kPhaseCount];
+
+	/** The phases currently being timed, innermost last. */
+	Phase _activePhases[kPhaseCount];
+	uint _activeCount;
+
+	/** Late frames of the frame limiter at its last report. */
+	uint _limiterLateFrames;
+};
+
+} // End of namespace Graphics
+
+#endif
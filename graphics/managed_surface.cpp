@@ -23,6 +23,7 @@
 #include "common/algorithm.h"
 #include "common/textconsole.h"
 #include "common/endian.h"
+#include "graphics/blit.h"
 
 namespace Graphics {
 
@@ -270,6 +271,29 @@ void ManagedSurface::blitFrom(const ManagedSurface &src, const Common::Rect &src
 		blitFromInner(src._innerSurface, srcRect, destRect, src._paletteSet ? src._palette : nullptr);
 }
 
+bool ManagedSurface::blendBlitFrom(const Surface &src, const Common::Rect &srcRect, const Common::Rect &destRect,
+		int flipping, uint32 colorMod, TSpriteBlendMode blend, AlphaType alphaType, bool filtering) {
+	if (src.format != format)
+		return false;
+
+	if (destRect.isEmpty() || !srcRect.isValidRect() || srcRect.isEmpty())
+		return true;
+
+	Common::Rect area = destRect;
+	area.clip(Common::Rect(0, 0, this->w, this->h));
+	if (area.isEmpty())
+		return true;
+
+	if (!blendBlit((byte *)getBasePtr(area.left, area.top), (const byte *)src.getBasePtr(srcRect.left, srcRect.top),
+			pitch, src.pitch, srcRect.width(), srcRect.height(), destRect.width(), destRect.height(),
+			area.left - destRect.left, area.top - destRect.top, area.width(), area.height(),
+			format, colorMod, flipping, blend, alphaType, filtering))
+		return false;
+
+	addDirtyRect(area);
+	return true;
+}
+
 void ManagedSurface::blitFromInner(const Surface &src, const Common::Rect &srcRect,
 		const Common::Rect &destRect, const uint32 *srcPalette) {
 
@@ -24,6 +24,7 @@
 
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
+#include "graphics/transform_struct.h"
 #include "common/rect.h"
 #include "common/types.h"
 
@@ -496,6 +497,38 @@ public:
 		uint32 transColor = 0, bool flipped = false, uint32 overrideColor = 0, uint32 srcAlpha = 0xff,
 		const Surface *mask = nullptr, bool maskOnly = false);
 
+	/**
+	 * Blend another surface into this one using its alpha channel, with color
+	 * modulation, scaling and flipping done in a single pass.
+	 *
+	 * Both surfaces need to share the same 32 bit pixel format.
+	 *
+	 * @param src			Source surface.
+	 * @param srcRect		Subsection of the source surface to draw.
+	 * @param destRect		Destination area to draw the surface in. This can be sized differently
+	 *						then @p srcRect, allowing for arbitrary scaling of the image.
+	 * @param flipping		Combination of FLIP_FLAGS to apply to the image.
+	 * @param colorMod		Color modulation in TS_ARGB layout, 0xFFFFFFFF for none.
+	 * @param blend			How the source is combined with this surface.
+	 * @param alphaType		The kind of alpha channel of @p src.
+	 * @param filtering		Whether to use bilinear filtering when scaling.
+	 * @return false if the pixel formats are not supported.
+	 */
+	bool blendBlitFrom(const Surface &src, const Common::Rect &srcRect, const Common::Rect &destRect,
+		int flipping = FLIP_NONE, uint32 colorMod = 0xFFFFFFFF, TSpriteBlendMode blend = BLEND_NORMAL,
+		AlphaType alphaType = ALPHA_FULL, bool filtering = false);
+
+	/**
+	 * Blend another surface into this one using its alpha channel.
+	 *
+	 * @see blendBlitFrom(const Surface &, const Common::Rect &, const Common::Rect &, int, uint32, TSpriteBlendMode, AlphaType, bool)
+	 */
+	bool blendBlitFrom(const ManagedSurface &src, const Common::Rect &srcRect, const Common::Rect &destRect,
+		int flipping = FLIP_NONE, uint32 colorMod = 0xFFFFFFFF, TSpriteBlendMode blend = BLEND_NORMAL,
+		AlphaType alphaType = ALPHA_FULL, bool filtering = false) {
+		return blendBlitFrom(src._innerSurface, srcRect, destRect, flipping, colorMod, blend, alphaType, filtering);
+	}
+
 	/**
 	 * Does a blitFrom ignoring any transparency settings
 	 */
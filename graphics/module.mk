@@ -1,8 +1,10 @@
 MODULE := graphics
 
 MODULE_OBJS := \
+	alpha_runs.o \
 	big5.o \
 	blit.o \
+	blit-alpha.o \
 	blit-scale.o \
 	cursorman.o \
 	font.o \
@@ -17,6 +19,7 @@ MODULE_OBJS := \
 	fonts/ttf.o \
 	fonts/winfont.o \
 	framelimiter.o \
+	frametimings.o \
 	korfont.o \
 	larryScale.o \
 	maccursor.o \
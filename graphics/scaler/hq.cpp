@@ -22,6 +22,14 @@
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HQ_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HQ_NEON
+#include <arm_neon.h>
+#endif
+
 // RGB-to-YUV lookup table
 
 #ifdef USE_NASM
@@ -173,7 +181,18 @@ void HQScaler::initLUT(Graphics::PixelFormat format) {
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate_2_3_3(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate_14_1_1(w5, w6, w8);
 
-#define YUV(x)	(sizeof(Pixel) == 2 ? RGBtoYUV[w ## x] : ConvertYUV<ColorMask>(w ## x, RGBtoYUV))
+// The YUV values of the 3x3 pixels around the current one, taken from the
+// YUV rows computed by convertRowYUV.
+#define YUV(x)	YUV_ ## x
+#define YUV_1	yuvAbove[0]
+#define YUV_2	yuvAbove[1]
+#define YUV_3	yuvAbove[2]
+#define YUV_4	yuvRow[0]
+#define YUV_5	yuvRow[1]
+#define YUV_6	yuvRow[2]
+#define YUV_7	yuvBelow[0]
+#define YUV_8	yuvBelow[1]
+#define YUV_9	yuvBelow[2]
 
 /**
  * Convert 32 bit RGB values to Yuv
@@ -193,13 +212,120 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Convert a row of pixels to YUV, including the pixels left and right of
+ * it. This way every pixel is converted once instead of up to nine times
+ * when computing the patterns.
+ */
+template<typename ColorMask>
+static void convertRowYUV(uint32 *yuv, const typename ColorMask::PixelType *p, int width, const uint32 *RGBtoYUV) {
+	for (int x = -1; x <= width; ++x) {
+		if (ColorMask::kBytesPerPixel == 2)
+			*yuv++ = RGBtoYUV[p[x]];
+		else
+			*yuv++ = ConvertYUV<ColorMask>(p[x], RGBtoYUV);
+	}
+}
+
+#if defined(HQ_SSE2)
+/**
+ * Compare four YUV values against their neighbors like diffYUV does.
+ * @return @p bit in every lane where the colors differ, 0 otherwise.
+ */
+static inline __m128i diffYUVBits(__m128i yuv1, __m128i yuv2, __m128i threshold, int bit) {
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(yuv1, yuv2), _mm_subs_epu8(yuv2, yuv1));
+	const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(absDiff, threshold), _mm_setzero_si128());
+	return _mm_andnot_si128(same, _mm_set1_epi32(bit));
+}
+#elif defined(HQ_NEON)
+/**
+ * Compare four YUV values against their neighbors like diffYUV does.
+ * @return @p bit in every lane where the colors differ, 0 otherwise.
+ */
+static inline uint32x4_t diffYUVBits(uint32x4_t yuv1, uint32x4_t yuv2, uint8x16_t threshold, uint32 bit) {
+	const uint8x16_t absDiff = vabdq_u8(vreinterpretq_u8_u32(yuv1), vreinterpretq_u8_u32(yuv2));
+	const uint32x4_t over = vreinterpretq_u32_u8(vqsubq_u8(absDiff, threshold));
+	return vandq_u32(vtstq_u32(over, over), vdupq_n_u32(bit));
+}
+#endif
+
+/**
+ * Compute the pattern of every pixel in a row. The pattern has a bit set
+ * for each of the eight neighbors of a pixel which differs noticeably from
+ * it according to diffYUV.
+ *
+ * @param patterns Receives one pattern per pixel. Must have room for four
+ *                 more.
+ * @param yuvAbove YUV values of the row above, as set up by convertRowYUV.
+ * @param yuvRow   YUV values of the row itself.
+ * @param yuvBelow YUV values of the row below.
+ * @param width    Number of pixels in the row.
+ */
+static void computePatterns(uint8 *patterns, const uint32 *yuvAbove, const uint32 *yuvRow, const uint32 *yuvBelow, int width) {
+	int x = 0;
+
+	// The YUV components are stored in separate bytes, thus the SIMD
+	// versions work on bytes with the thresholds of diffYUV for Y, U and V.
+#if defined(HQ_SSE2)
+	const __m128i threshold = _mm_set1_epi32(0x00300706);
+	for (; x + 4 <= width; x += 4) {
+		const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(yuvRow + x + 1));
+
+		__m128i pattern = diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvAbove + x)), threshold, 0x01);
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvAbove + x + 1)), threshold, 0x02));
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvAbove + x + 2)), threshold, 0x04));
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvRow + x)), threshold, 0x08));
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvRow + x + 2)), threshold, 0x10));
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvBelow + x)), threshold, 0x20));
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvBelow + x + 1)), threshold, 0x40));
+		pattern = _mm_or_si128(pattern, diffYUVBits(yuv5, _mm_loadu_si128((const __m128i *)(yuvBelow + x + 2)), threshold, 0x80));
+
+		pattern = _mm_packs_epi32(pattern, pattern);
+		pattern = _mm_packus_epi16(pattern, pattern);
+		WRITE_UINT32(patterns + x, _mm_cvtsi128_si32(pattern));
+	}
+#elif defined(HQ_NEON)
+	const uint8x16_t threshold = vreinterpretq_u8_u32(vdupq_n_u32(0x00300706));
+	for (; x + 4 <= width; x += 4) {
+		const uint32x4_t yuv5 = vld1q_u32(yuvRow + x + 1);
+
+		uint32x4_t pattern = diffYUVBits(yuv5, vld1q_u32(yuvAbove + x), threshold, 0x01);
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvAbove + x + 1), threshold, 0x02));
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvAbove + x + 2), threshold, 0x04));
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvRow + x), threshold, 0x08));
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvRow + x + 2), threshold, 0x10));
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvBelow + x), threshold, 0x20));
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvBelow + x + 1), threshold, 0x40));
+		pattern = vorrq_u32(pattern, diffYUVBits(yuv5, vld1q_u32(yuvBelow + x + 2), threshold, 0x80));
+
+		const uint16x4_t pattern16 = vmovn_u32(pattern);
+		// The patterns buffer has room for the four extra bytes.
+		vst1_u8(patterns + x, vmovn_u16(vcombine_u16(pattern16, pattern16)));
+	}
+#endif
+
+	for (; x < width; ++x) {
+		const int yuv5 = yuvRow[x + 1];
+		int pattern = 0;
+		if (diffYUV(yuv5, yuvAbove[x]))     pattern |= 0x0001;
+		if (diffYUV(yuv5, yuvAbove[x + 1])) pattern |= 0x0002;
+		if (diffYUV(yuv5, yuvAbove[x + 2])) pattern |= 0x0004;
+		if (diffYUV(yuv5, yuvRow[x]))       pattern |= 0x0008;
+		if (diffYUV(yuv5, yuvRow[x + 2]))   pattern |= 0x0010;
+		if (diffYUV(yuv5, yuvBelow[x]))     pattern |= 0x0020;
+		if (diffYUV(yuv5, yuvBelow[x + 1])) pattern |= 0x0040;
+		if (diffYUV(yuv5, yuvBelow[x + 2])) pattern |= 0x0080;
+		patterns[x] = pattern;
+	}
+}
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (https://web.archive.org/web/20090204033742/http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, uint32 *yuvBuffer, uint8 *patterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,7 +347,20 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// YUV values of the rows above, at and below the current one.
+	uint32 *yuvRows[3] = { yuvBuffer, yuvBuffer + width + 2, yuvBuffer + 2 * (width + 2) };
+	convertRowYUV<ColorMask>(yuvRows[0], p - nextlineSrc, width, RGBtoYUV);
+	convertRowYUV<ColorMask>(yuvRows[1], p, width, RGBtoYUV);
+
 	while (height--) {
+		convertRowYUV<ColorMask>(yuvRows[2], p + nextlineSrc, width, RGBtoYUV);
+		computePatterns(patterns, yuvRows[0], yuvRows[1], yuvRows[2], width);
+
+		const uint32 *yuvAbove = yuvRows[0];
+		const uint32 *yuvRow = yuvRows[1];
+		const uint32 *yuvBelow = yuvRows[2];
+		const uint8 *pattern = patterns;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -238,18 +377,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
-
-			switch (pattern) {
+			switch (*pattern++) {
 			case 0:
 			case 1:
 			case 4:
@@ -2049,10 +2177,19 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w5 = w6;
 			w8 = w9;
 
+			++yuvAbove;
+			++yuvRow;
+			++yuvBelow;
+
 			q += 2;
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 2;
+
+		uint32 *yuvTmp = yuvRows[0];
+		yuvRows[0] = yuvRows[1];
+		yuvRows[1] = yuvRows[2];
+		yuvRows[2] = yuvTmp;
 	}
 }
 
@@ -2116,7 +2253,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, uint32 *yuvBuffer, uint8 *patterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,7 +2276,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// YUV values of the rows above, at and below the current one.
+	uint32 *yuvRows[3] = { yuvBuffer, yuvBuffer + width + 2, yuvBuffer + 2 * (width + 2) };
+	convertRowYUV<ColorMask>(yuvRows[0], p - nextlineSrc, width, RGBtoYUV);
+	convertRowYUV<ColorMask>(yuvRows[1], p, width, RGBtoYUV);
+
 	while (height--) {
+		convertRowYUV<ColorMask>(yuvRows[2], p + nextlineSrc, width, RGBtoYUV);
+		computePatterns(patterns, yuvRows[0], yuvRows[1], yuvRows[2], width);
+
+		const uint32 *yuvAbove = yuvRows[0];
+		const uint32 *yuvRow = yuvRows[1];
+		const uint32 *yuvBelow = yuvRows[2];
+		const uint8 *pattern = patterns;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2156,18 +2306,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
-
-			switch (pattern) {
+			switch (*pattern++) {
 			case 0:
 			case 1:
 			case 4:
@@ -4940,10 +5079,19 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w5 = w6;
 			w8 = w9;
 
+			++yuvAbove;
+			++yuvRow;
+			++yuvBelow;
+
 			q += 3;
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 3;
+
+		uint32 *yuvTmp = yuvRows[0];
+		yuvRows[0] = yuvRows[1];
+		yuvRows[1] = yuvRows[2];
+		yuvRows[2] = yuvTmp;
 	}
 }
 
@@ -4987,19 +5135,19 @@ void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 }
 
 void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 }
 #endif
 
@@ -5007,15 +5155,15 @@ void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ2x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 		} else {
 			HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 	}
 }
 
@@ -5023,20 +5171,25 @@ void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ3x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 		} else {
 			HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _yuvBuffer.data(), _patterns.data());
 	}
 }
 
 void HQScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	if (_patterns.size() < (uint)width + 4) {
+		_yuvBuffer.resize(3 * (width + 2));
+		_patterns.resize(width + 4);
+	}
+
 	if (_format.bytesPerPixel == 2) {
 		switch (_factor) {
 		case 2:
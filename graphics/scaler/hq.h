@@ -22,6 +22,7 @@
 #define GRAPHICS_SCALER_HQ_H
 
 #include "graphics/scalerplugin.h"
+#include "common/array.h"
 
 #ifdef USE_NASM
 struct hqx_parameters;
@@ -44,6 +45,10 @@ protected:
 	inline void HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 
 	uint32 *_RGBtoYUV;
+
+	/** Scratch space for three rows of YUV values and one row of patterns */
+	Common::Array<uint32> _yuvBuffer;
+	Common::Array<uint8> _patterns;
 #ifdef USE_NASM
 	hqx_parameters *_hqx_params;
 #endif
@@ -39,9 +39,9 @@ void Normal2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 
 			*(Pixel *)(r) = color;
 			*(Pixel *)(r + b) = color;
-			*(Pixel *)(r + dstPitch) = color;
-			*(Pixel *)(r + b + dstPitch) = color;
 		}
+		// The second row is the same, copying it is faster
+		memcpy(dstPtr + dstPitch, dstPtr, width * b * 2);
 		srcPtr += srcPitch;
 		dstPtr += dstPitch << 1;
 	}
@@ -74,8 +74,8 @@ void Normal2x<uint16>(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 			color |= color << 16;
 
 			*(uint32 *)(r) = color;
-			*(uint32 *)(r + dstPitch) = color;
 		}
+		memcpy(dstPtr + dstPitch, dstPtr, width * 4);
 		srcPtr += srcPitch;
 		dstPtr += dstPitch << 1;
 	}
@@ -102,13 +102,10 @@ void Normal3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 			*(Pixel *)(r + b * 0) = color;
 			*(Pixel *)(r + b * 1) = color;
 			*(Pixel *)(r + b * 2) = color;
-			*(Pixel *)(r + b * 0 + dstPitch) = color;
-			*(Pixel *)(r + b * 1 + dstPitch) = color;
-			*(Pixel *)(r + b * 2 + dstPitch) = color;
-			*(Pixel *)(r + b * 0 + dstPitch2) = color;
-			*(Pixel *)(r + b * 1 + dstPitch2) = color;
-			*(Pixel *)(r + b * 2 + dstPitch2) = color;
 		}
+		// The other rows are the same, copying them is faster
+		memcpy(dstPtr + dstPitch, dstPtr, width * b * 3);
+		memcpy(dstPtr + dstPitch2, dstPtr, width * b * 3);
 		srcPtr += srcPitch;
 		dstPtr += dstPitch3;
 	}
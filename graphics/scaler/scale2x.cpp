@@ -20,7 +20,8 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C, SSE2/NEON and MMX implementation of the Scale2x
+ * effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -147,6 +148,86 @@ void scale2x_32_def(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_ui
 	scale2x_32_def_single(dst1, src2, src1, src0, count);
 }
 
+/***************************************************************************/
+/* Scale2x SSE2/NEON implementation */
+
+#ifdef SCALE_SIMD
+
+/*
+ * Apply the Scale2x effect at a single row, for a multiple of the vector
+ * size of pixels. It works like scale2x_16_def_single().
+ */
+template<typename Pixel>
+static inline void scale2x_simd_single(Pixel* __restrict__ dst, const Pixel* __restrict__ src0, const Pixel* __restrict__ src1, const Pixel* __restrict__ src2, unsigned count) {
+	typedef ScaleSIMD<Pixel> SIMD;
+	typedef typename SIMD::Vector Vector;
+
+	while (count) {
+		const Vector B = SIMD::load(src0);
+		const Vector D = SIMD::load(src1 - 1);
+		const Vector E = SIMD::load(src1);
+		const Vector F = SIMD::load(src1 + 1);
+		const Vector H = SIMD::load(src2);
+
+		const Vector skip = SIMD::bitOr(SIMD::eq(B, H), SIMD::eq(D, F));
+		const Vector E0 = SIMD::select(SIMD::andNot(SIMD::eq(D, B), skip), B, E);
+		const Vector E1 = SIMD::select(SIMD::andNot(SIMD::eq(F, B), skip), B, E);
+		SIMD::store2(dst, E0, E1);
+
+		src0 += SIMD::kLanes;
+		src1 += SIMD::kLanes;
+		src2 += SIMD::kLanes;
+		dst += 2 * SIMD::kLanes;
+		count -= SIMD::kLanes;
+	}
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_8_def() but for 16 bits pixels.
+ * The bulk of the row is handled with SSE2 or NEON instructions.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * It must be at least 2.
+ * @param dst0 First destination row, double length in pixels.
+ * @param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_16_simd(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	const unsigned rest = count % ScaleSIMD<scale2x_uint16>::kLanes;
+	const unsigned bulk = count - rest;
+
+	scale2x_simd_single(dst0, src0, src1, src2, bulk);
+	scale2x_simd_single(dst1, src2, src1, src0, bulk);
+	scale2x_16_def_single(dst0 + 2 * bulk, src0 + bulk, src1 + bulk, src2 + bulk, rest);
+	scale2x_16_def_single(dst1 + 2 * bulk, src2 + bulk, src1 + bulk, src0 + bulk, rest);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 32 bits.
+ * This function operates like scale2x_8_def() but for 32 bits pixels.
+ * The bulk of the row is handled with SSE2 or NEON instructions.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * It must be at least 2.
+ * @param dst0 First destination row, double length in pixels.
+ * @param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_32_simd(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count) {
+	const unsigned rest = count % ScaleSIMD<scale2x_uint32>::kLanes;
+	const unsigned bulk = count - rest;
+
+	scale2x_simd_single(dst0, src0, src1, src2, bulk);
+	scale2x_simd_single(dst1, src2, src1, src0, bulk);
+	scale2x_32_def_single(dst0 + 2 * bulk, src0 + bulk, src1 + bulk, src2 + bulk, rest);
+	scale2x_32_def_single(dst1 + 2 * bulk, src2 + bulk, src1 + bulk, src0 + bulk, rest);
+}
+
+#endif
+
 /***************************************************************************/
 /* Scale2x MMX implementation */
 
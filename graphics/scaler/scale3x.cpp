@@ -20,7 +20,7 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C and SSE2/NEON implementation of the Scale3x effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -221,3 +221,124 @@ void scale3x_32_def(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32*
 	scale3x_32_def_center(dst1, src0, src1, src2, count);
 	scale3x_32_def_border(dst2, src2, src1, src0, count);
 }
+
+/***************************************************************************/
+/* Scale3x SSE2/NEON implementation */
+
+#ifdef SCALE_SIMD
+
+/*
+ * Apply the Scale3x effect at the first or last row of the output, for a
+ * multiple of the vector size of pixels. It works like
+ * scale3x_16_def_border().
+ */
+template<typename Pixel>
+static inline void scale3x_simd_border(Pixel* __restrict__ dst, const Pixel* __restrict__ src0, const Pixel* __restrict__ src1, const Pixel* __restrict__ src2, unsigned count) {
+	typedef ScaleSIMD<Pixel> SIMD;
+	typedef typename SIMD::Vector Vector;
+
+	while (count) {
+		const Vector A = SIMD::load(src0 - 1);
+		const Vector B = SIMD::load(src0);
+		const Vector C = SIMD::load(src0 + 1);
+		const Vector D = SIMD::load(src1 - 1);
+		const Vector E = SIMD::load(src1);
+		const Vector F = SIMD::load(src1 + 1);
+		const Vector H = SIMD::load(src2);
+
+		const Vector skip = SIMD::bitOr(SIMD::eq(B, H), SIMD::eq(D, F));
+		const Vector DB = SIMD::andNot(SIMD::eq(D, B), skip);
+		const Vector FB = SIMD::andNot(SIMD::eq(F, B), skip);
+		const Vector B1 = SIMD::bitOr(SIMD::andNot(DB, SIMD::eq(E, C)), SIMD::andNot(FB, SIMD::eq(E, A)));
+
+		SIMD::store3(dst, SIMD::select(DB, D, E), SIMD::select(B1, B, E), SIMD::select(FB, F, E));
+
+		src0 += SIMD::kLanes;
+		src1 += SIMD::kLanes;
+		src2 += SIMD::kLanes;
+		dst += 3 * SIMD::kLanes;
+		count -= SIMD::kLanes;
+	}
+}
+
+/*
+ * Apply the Scale3x effect at the center row of the output, for a multiple
+ * of the vector size of pixels. It works like scale3x_16_def_center().
+ */
+template<typename Pixel>
+static inline void scale3x_simd_center(Pixel* __restrict__ dst, const Pixel* __restrict__ src0, const Pixel* __restrict__ src1, const Pixel* __restrict__ src2, unsigned count) {
+	typedef ScaleSIMD<Pixel> SIMD;
+	typedef typename SIMD::Vector Vector;
+
+	while (count) {
+		const Vector A = SIMD::load(src0 - 1);
+		const Vector B = SIMD::load(src0);
+		const Vector C = SIMD::load(src0 + 1);
+		const Vector D = SIMD::load(src1 - 1);
+		const Vector E = SIMD::load(src1);
+		const Vector F = SIMD::load(src1 + 1);
+		const Vector G = SIMD::load(src2 - 1);
+		const Vector H = SIMD::load(src2);
+		const Vector I = SIMD::load(src2 + 1);
+
+		const Vector skip = SIMD::bitOr(SIMD::eq(B, H), SIMD::eq(D, F));
+		const Vector D3 = SIMD::bitOr(SIMD::andNot(SIMD::eq(D, B), SIMD::eq(E, G)), SIMD::andNot(SIMD::eq(D, H), SIMD::eq(E, A)));
+		const Vector F5 = SIMD::bitOr(SIMD::andNot(SIMD::eq(F, B), SIMD::eq(E, I)), SIMD::andNot(SIMD::eq(F, H), SIMD::eq(E, C)));
+
+		SIMD::store3(dst, SIMD::select(SIMD::andNot(D3, skip), D, E), E, SIMD::select(SIMD::andNot(F5, skip), F, E));
+
+		src0 += SIMD::kLanes;
+		src1 += SIMD::kLanes;
+		src2 += SIMD::kLanes;
+		dst += 3 * SIMD::kLanes;
+		count -= SIMD::kLanes;
+	}
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_8_def() but for 16 bits pixels.
+ * The bulk of the row is handled with SSE2 or NEON instructions.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * It must be at least 2.
+ * @param dst0 First destination row, triple length in pixels.
+ * @param dst1 Second destination row, triple length in pixels.
+ * @param dst2 Third destination row, triple length in pixels.
+ */
+void scale3x_16_simd(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	const unsigned rest = count % ScaleSIMD<scale3x_uint16>::kLanes;
+	const unsigned bulk = count - rest;
+
+	scale3x_simd_border(dst0, src0, src1, src2, bulk);
+	scale3x_simd_center(dst1, src0, src1, src2, bulk);
+	scale3x_simd_border(dst2, src2, src1, src0, bulk);
+	scale3x_16_def(dst0 + 3 * bulk, dst1 + 3 * bulk, dst2 + 3 * bulk, src0 + bulk, src1 + bulk, src2 + bulk, rest);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 32 bits.
+ * This function operates like scale3x_8_def() but for 32 bits pixels.
+ * The bulk of the row is handled with SSE2 or NEON instructions.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * It must be at least 2.
+ * @param dst0 First destination row, triple length in pixels.
+ * @param dst1 Second destination row, triple length in pixels.
+ * @param dst2 Third destination row, triple length in pixels.
+ */
+void scale3x_32_simd(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count) {
+	const unsigned rest = count % ScaleSIMD<scale3x_uint32>::kLanes;
+	const unsigned bulk = count - rest;
+
+	scale3x_simd_border(dst0, src0, src1, src2, bulk);
+	scale3x_simd_center(dst1, src0, src1, src2, bulk);
+	scale3x_simd_border(dst2, src2, src1, src0, bulk);
+	scale3x_32_def(dst0 + 3 * bulk, dst1 + 3 * bulk, dst2 + 3 * bulk, src0 + bulk, src1 + bulk, src2 + bulk, rest);
+}
+
+#endif
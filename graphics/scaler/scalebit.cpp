@@ -48,8 +48,16 @@
  */
 static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const void* src1, const void* src2, unsigned pixel, unsigned pixel_per_row) {
 	switch (pixel) {
+#if defined(SCALE_SIMD)
 #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 	case 1: scale2x_8_mmx( DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
+#else
+	case 1: scale2x_8_def( DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
+#endif
+	case 2: scale2x_16_simd(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
+	case 4: scale2x_32_simd(DST(32,0), DST(32,1), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	case 1: scale2x_8_mmx( DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
 	case 2: scale2x_16_mmx(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
 	case 4: scale2x_32_mmx(DST(32,0), DST(32,1), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
 #elif defined(USE_ARM_SCALER_ASM)
@@ -71,8 +79,13 @@ static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const
 static inline void stage_scale3x(void* dst0, void* dst1, void* dst2, const void* src0, const void* src1, const void* src2, unsigned pixel, unsigned pixel_per_row) {
 	switch (pixel) {
 	case 1: scale3x_8_def( DST( 8,0), DST( 8,1), DST( 8,2), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
+#if defined(SCALE_SIMD)
+	case 2: scale3x_16_simd(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
+	case 4: scale3x_32_simd(DST(32,0), DST(32,1), DST(32,2), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
+#else
 	case 2: scale3x_16_def(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
 	case 4: scale3x_32_def(DST(32,0), DST(32,1), DST(32,2), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
+#endif
 	default: break;
 	}
 }
@@ -159,6 +172,15 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	}
 }
 
+/**
+ * Repeat the border pixels of an intermediate row into the pixels to its left
+ * and right, which the Scale2x stages read as neighbours.
+ */
+static inline void extend_row(unsigned char* row, unsigned pixel, unsigned count) {
+	memcpy(row - pixel, row, pixel);
+	memcpy(row + count * pixel, row + (count - 1) * pixel, pixel);
+}
+
 /**
  * Apply the Scale4x effect on a bitmap.
  * The destination bitmap is filled with the scaled version of the source bitmap.
@@ -166,7 +188,7 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * The destination bitmap must be manually allocated before calling the function,
  * note that the resulting size is exactly 4x4 times the size of the source bitmap.
  * \note This function requires also a small buffer bitmap used internally to store
- * intermediate results. This bitmap must have at least an horizontal size in bytes of 2*width*pixel,
+ * intermediate results. This bitmap must have at least an horizontal size in bytes of 2*(width+1)*pixel,
  * and a vertical size of 6 rows. The memory of this buffer must not be allocated
  * in video memory because it's also read and not only written. Generally
  * a heap (malloc) or a stack (alloca) buffer is the best choices.
@@ -190,8 +212,8 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 
 	count = height;
 
-	/* set the 6 buffer pointers */
-	mid[0] = (unsigned char*)void_mid;
+	/* set the 6 buffer pointers, leaving one pixel on each side of the rows */
+	mid[0] = (unsigned char*)void_mid + pixel;
 	mid[1] = mid[0] + mid_slice;
 	mid[2] = mid[1] + mid_slice;
 	mid[3] = mid[2] + mid_slice;
@@ -200,10 +222,14 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 
 	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width);
 	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width);
+	for (unsigned i = 0; i < 4; ++i)
+		extend_row(SCMID(i), pixel, 2 * width);
 	while (count) {
 		unsigned char* tmp;
 
 		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width);
+		extend_row(SCMID(4), pixel, 2 * width);
+		extend_row(SCMID(5), pixel, 2 * width);
 		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1), SCMID(2), SCMID(3), SCMID(4), pixel, width);
 
 		dst = SCDST(4);
@@ -246,7 +272,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	unsigned mid_slice;
 	void* mid;
 
-	mid_slice = 2 * pixel * width; /* required space for 1 row buffer */
+	mid_slice = 2 * pixel * (width + 1); /* required space for 1 row buffer, with a pixel on each side */
 
 	mid_slice = (mid_slice + 0x7) & ~0x7; /* align to 8 bytes */
 
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCALER_SCALESIMD_H
+#define SCALER_SCALESIMD_H
+
+/*
+ * Thin wrappers around the SSE2 and NEON intrinsics used by the Scale2x and
+ * Scale3x effects. This allows one vector implementation of the effects for
+ * both 16 and 32 bits pixels. SCALE_SIMD is defined when they are available.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALE_SIMD
+#define SCALE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCALE_SIMD
+#define SCALE_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef SCALE_SIMD
+
+template<typename Pixel>
+struct ScaleSIMD;
+
+#if defined(SCALE_SSE2)
+
+struct ScaleSIMDSSE2 {
+	typedef __m128i Vector;
+
+	static inline Vector load(const void *p) { return _mm_loadu_si128((const __m128i *)p); }
+	static inline Vector bitOr(Vector a, Vector b) { return _mm_or_si128(a, b); }
+	/** @return a with all bits set in mask cleared. */
+	static inline Vector andNot(Vector a, Vector mask) { return _mm_andnot_si128(mask, a); }
+	/** @return a where mask is set, b otherwise. */
+	static inline Vector select(Vector mask, Vector a, Vector b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+	/** Store the pixels of a, b and c interleaved. */
+	template<typename Pixel>
+	static inline void store3(Pixel *dst, Vector a, Vector b, Vector c) {
+		const unsigned lanes = sizeof(Vector) / sizeof(Pixel);
+		Pixel pa[lanes], pb[lanes], pc[lanes];
+		_mm_storeu_si128((__m128i *)pa, a);
+		_mm_storeu_si128((__m128i *)pb, b);
+		_mm_storeu_si128((__m128i *)pc, c);
+		for (unsigned i = 0; i < lanes; ++i) {
+			*dst++ = pa[i];
+			*dst++ = pb[i];
+			*dst++ = pc[i];
+		}
+	}
+};
+
+template<>
+struct ScaleSIMD<unsigned short> : public ScaleSIMDSSE2 {
+	enum { kLanes = 8 };
+
+	static inline Vector eq(Vector a, Vector b) { return _mm_cmpeq_epi16(a, b); }
+
+	/** Store the pixels of a and b interleaved. */
+	static inline void store2(unsigned short *dst, Vector a, Vector b) {
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(a, b));
+		_mm_storeu_si128((__m128i *)(dst + kLanes), _mm_unpackhi_epi16(a, b));
+	}
+};
+
+template<>
+struct ScaleSIMD<unsigned> : public ScaleSIMDSSE2 {
+	enum { kLanes = 4 };
+
+	static inline Vector eq(Vector a, Vector b) { return _mm_cmpeq_epi32(a, b); }
+
+	/** Store the pixels of a and b interleaved. */
+	static inline void store2(unsigned *dst, Vector a, Vector b) {
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi32(a, b));
+		_mm_storeu_si128((__m128i *)(dst + kLanes), _mm_unpackhi_epi32(a, b));
+	}
+};
+
+#elif defined(SCALE_NEON)
+
+template<>
+struct ScaleSIMD<unsigned short> {
+	typedef uint16x8_t Vector;
+	enum { kLanes = 8 };
+
+	static inline Vector load(const unsigned short *p) { return vld1q_u16(p); }
+	static inline Vector eq(Vector a, Vector b) { return vceqq_u16(a, b); }
+	static inline Vector bitOr(Vector a, Vector b) { return vorrq_u16(a, b); }
+	static inline Vector andNot(Vector a, Vector mask) { return vbicq_u16(a, mask); }
+	static inline Vector select(Vector mask, Vector a, Vector b) { return vbslq_u16(mask, a, b); }
+
+	static inline void store2(unsigned short *dst, Vector a, Vector b) {
+		uint16x8x2_t v = {{ a, b }};
+		vst2q_u16(dst, v);
+	}
+
+	static inline void store3(unsigned short *dst, Vector a, Vector b, Vector c) {
+		uint16x8x3_t v = {{ a, b, c }};
+		vst3q_u16(dst, v);
+	}
+};
+
+template<>
+struct ScaleSIMD<unsigned> {
+	typedef uint32x4_t Vector;
+	enum { kLanes = 4 };
+
+	static inline Vector load(const unsigned *p) { return vld1q_u32((const uint32_t *)p); }
+	static inline Vector eq(Vector a, Vector b) { return vceqq_u32(a, b); }
+	static inline Vector bitOr(Vector a, Vector b) { return vorrq_u32(a, b); }
+	static inline Vector andNot(Vector a, Vector mask) { return vbicq_u32(a, mask); }
+	static inline Vector select(Vector mask, Vector a, Vector b) { return vbslq_u32(mask, a, b); }
+
+	static inline void store2(unsigned *dst, Vector a, Vector b) {
+		uint32x4x2_t v = {{ a, b }};
+		vst2q_u32((uint32_t *)dst, v);
+	}
+
+	static inline void store3(unsigned *dst, Vector a, Vector b, Vector c) {
+		uint32x4x3_t v = {{ a, b, c }};
+		vst3q_u32((uint32_t *)dst, v);
+	}
+};
+
+#endif
+
+#endif // SCALE_SIMD
+
+#endif
@@ -83,6 +83,7 @@ void Surface::create(int16 width, int16 height, const PixelFormat &f) {
 void Surface::free() {
 	::free(pixels);
 	pixels = 0;
+	pixelGeneration++;
 	w = h = pitch = 0;
 	format = PixelFormat();
 }
@@ -93,6 +94,7 @@ void Surface::init(int16 width, int16 height, int16 newPitch, void *newPixels, c
 	h = height;
 	pitch = newPitch;
 	pixels = newPixels;
+	pixelGeneration++;
 	format = f;
 }
 
@@ -522,6 +524,7 @@ void Surface::convertToInPlace(const PixelFormat &dstFormat, const byte *palette
 	// Update the surface specific data.
 	format = dstFormat;
 	pitch = w * dstFormat.bytesPerPixel;
+	pixelGeneration++;
 }
 
 Graphics::Surface *Surface::convertTo(const PixelFormat &dstFormat, const byte *srcPalette, int srcPaletteCount, const byte *dstPalette, int dstPaletteCount, DitherMethod method) const {
@@ -87,6 +87,11 @@ protected:
 	 */
 	void *pixels;
 
+	/**
+	 * Changed whenever the pixel data is replaced or freed.
+	 */
+	uint32 pixelGeneration;
+
 public:
 	/**
 	 * Pixel format of the surface.
@@ -96,7 +101,7 @@ public:
 	/**
 	 * Construct a simple Surface object.
 	 */
-	Surface() : w(0), h(0), pitch(0), pixels(0), format() {
+	Surface() : w(0), h(0), pitch(0), pixels(0), pixelGeneration(0), format() {
 	}
 
 	/**
@@ -124,7 +129,16 @@ public:
 	 *
 	 * @param newPixels The new pixel data.
 	 */
-	void setPixels(void *newPixels) { pixels = newPixels; }
+	void setPixels(void *newPixels) { pixels = newPixels; pixelGeneration++; }
+
+	/**
+	 * Return a number which changes whenever create(), free(), init(),
+	 * setPixels() or convertToInPlace() replace or free the pixel data.
+	 *
+	 * Data derived from the pixels can use this to notice that it is out of
+	 * date. Drawing to the surface does not change the number.
+	 */
+	uint32 getPixelGeneration() const { return pixelGeneration; }
 
 	/**
 	 * Return a pointer to the pixel at the specified point.
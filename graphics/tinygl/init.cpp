@@ -349,8 +349,10 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	color_mask_red = color_mask_green = color_mask_blue = color_mask_alpha = true;
 
 	_currentAllocatorIndex = 0;
-	_drawCallAllocator[0].initialize(drawCallMemorySize);
-	_drawCallAllocator[1].initialize(drawCallMemorySize);
+	for (int i = 0; i < 2; i++) {
+		_drawCallAllocator[i].setBlockSize(drawCallMemorySize);
+		_drawCallAllocator[i].setName("TinyGL draw calls");
+	}
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
 
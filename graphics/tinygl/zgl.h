@@ -30,6 +30,7 @@
 
 #include "common/util.h"
 #include "common/textconsole.h"
+#include "common/arena.h"
 #include "common/array.h"
 #include "common/list.h"
 #include "common/scummsys.h"
@@ -224,56 +225,6 @@ struct GLSharedState {
 	GLTexture **texture_hash_table;
 };
 
-/**
- * A linear allocator implementation.
- * The allocator can be initialized to a specific buffer size only once.
- * The allocation scheme is pretty simple: pointers are returned relative to a current memory position,
- * the allocator starts with an offset of 0 and increases its offset by the allocated amount every time.
- * Memory is released through the method free(), care has to be taken to call the destructors of the deallocated objects either manually (for complex struct arrays) or
- * by overriding the delete operator (with an empty implementation).
- */
-class LinearAllocator {
-public:
-	LinearAllocator() {
-		_memoryBuffer = nullptr;
-		_memorySize = 0;
-		_memoryPosition = 0;
-	}
-
-	void initialize(size_t newSize) {
-		assert(_memoryBuffer == nullptr);
-		void *newBuffer = gl_malloc(newSize);
-		if (newBuffer == nullptr) {
-			error("Couldn't allocate memory for linear allocator.");
-		}
-		_memoryBuffer = newBuffer;
-		_memorySize = newSize;
-	}
-
-	~LinearAllocator() {
-		if (_memoryBuffer != nullptr) {
-			gl_free(_memoryBuffer);
-		}
-	}
-
-	void *allocate(size_t size) {
-		if (_memoryPosition + size >= _memorySize) {
-			error("Allocator out of memory: couldn't allocate more memory from linear allocator.");
-		}
-		size_t returnPos = _memoryPosition;
-		_memoryPosition += size;
-		return ((byte *)_memoryBuffer) + returnPos;
-	}
-
-	void reset() {
-		_memoryPosition = 0;
-	}
-private:
-	void *_memoryBuffer;
-	size_t _memorySize;
-	size_t _memoryPosition;
-};
-
 struct GLContext;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
@@ -459,7 +410,7 @@ struct GLContext {
 	Common::List<DrawCall *> _drawCallsQueue;
 	Common::List<DrawCall *> _previousFrameDrawCallsQueue;
 	int _currentAllocatorIndex;
-	LinearAllocator _drawCallAllocator[2];
+	Common::Arena _drawCallAllocator[2];
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
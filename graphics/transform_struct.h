@@ -35,6 +35,16 @@ enum TSpriteBlendMode {
 	NUM_BLEND_MODES
 };
 
+/**
+ * The kind of alpha channel of an image, allowing blits to take a faster
+ * path when no blending is needed.
+ */
+enum AlphaType {
+	ALPHA_OPAQUE = 0,
+	ALPHA_BINARY = 1,
+	ALPHA_FULL = 2
+};
+
 /**
  @brief The possible flipping parameters for the blit method.
  */
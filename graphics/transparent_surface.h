@@ -22,6 +22,7 @@
 #ifndef GRAPHICS_TRANSPARENTSURFACE_H
 #define GRAPHICS_TRANSPARENTSURFACE_H
 
+#include "graphics/alpha_runs.h"
 #include "graphics/surface.h"
 #include "graphics/transform_struct.h"
 
@@ -48,13 +49,6 @@ namespace Graphics {
  * @{
  */
 
-// Enums
-enum AlphaType {
-	ALPHA_OPAQUE = 0,
-	ALPHA_BINARY = 1,
-	ALPHA_FULL = 2
-};
-
 /**
  * A transparent graphics surface, which implements alpha blitting.
  */
@@ -118,6 +112,51 @@ struct TransparentSurface : public Graphics::Surface {
 	void applyColorKey(uint8 r, uint8 g, uint8 b, bool overwriteAlpha = false);
 	void setAlpha(uint8 alpha, bool skipTransparent = false);
 
+	/**
+	 * Split the rows into runs of transparent, opaque and blended pixels, so
+	 * that unscaled blits can skip and copy whole runs.
+	 *
+	 * This is best done once after loading the image. The runs are no longer
+	 * used once the pixels are replaced or freed, also through a plain
+	 * Surface reference, and they are dropped when the alpha channel is
+	 * changed by applyColorKey() or setAlpha(). They need to be built again
+	 * if the pixels are drawn to otherwise.
+	 */
+	void buildAlphaRuns();
+	void freeAlphaRuns() { _alphaRuns.clear(); }
+	bool hasAlphaRuns() const { return _alphaRuns.matches(*this); }
+
+	/**
+	 * Keep only the pixels which are not fully transparent, packed along
+	 * with the alpha runs, and free the pixel buffer. Sprites with large
+	 * transparent areas then need much less memory.
+	 *
+	 * Unscaled blits draw the packed pixels directly. Scaled blits and the
+	 * other operations of TransparentSurface unpack the image first, which
+	 * turns fully transparent pixels into 0. getPixels() returns nullptr
+	 * while the surface is compressed, so it must not be used as a plain
+	 * Surface then. Like free(), this may only be used on surfaces which own
+	 * their pixels.
+	 *
+	 * @return false if the surface doesn't use 32 bits per pixel.
+	 */
+	bool compress();
+
+	/** Allocate the pixel buffer of a compressed surface again. */
+	void decompress();
+
+	bool isCompressed() const { return !pixels && hasAlphaRuns() && _alphaRuns.hasPackedPixels(); }
+
+	/**
+	 * Multiply the colors by the alpha value of each pixel. Blits take this into
+	 * account, and scaling with filtering doesn't bleed the colors of
+	 * transparent pixels into the image anymore.
+	 *
+	 * applyColorKey() and setAlpha() must not be used on premultiplied images.
+	 */
+	void premultiplyAlpha();
+	bool isPremultiplied() const { return _premultiplied; }
+
 	/**
 	 * @brief Scale function; this returns a transformed version of this surface after rotation and
 	 * scaling. Please do not use this if angle != 0, use rotoscale.
@@ -152,6 +191,8 @@ struct TransparentSurface : public Graphics::Surface {
 	void setAlphaMode(AlphaType);
 private:
 	AlphaType _alphaMode;
+	AlphaRuns _alphaRuns;
+	bool _premultiplied;
 };
 
 /**
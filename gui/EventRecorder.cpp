@@ -29,7 +29,6 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 }
 
 #include "common/debug-channels.h"
-#include "backends/timer/sdl/sdl-timer.h"
 #include "backends/mixer/mixer.h"
 #include "common/config-manager.h"
 #include "common/md5.h"
@@ -78,6 +77,10 @@ EventRecorder::EventRecorder() {
 	_screenshotPeriod = 0;
 	_playbackFile = nullptr;
 	_recordFile = nullptr;
+	_benchmark = false;
+	_benchmarkStart = 0;
+	_benchmarkStartTime = 0;
+	_benchmarkFrames = 0;
 }
 
 EventRecorder::~EventRecorder() {
@@ -88,7 +91,9 @@ void EventRecorder::deinit() {
 	if (!_initialized) {
 		return;
 	}
+	reportBenchmark();
 	setFileHeader();
+	_fastPlayback = false;
 	_needRedraw = false;
 	_initialized = false;
 	_recordMode = kPassthrough;
@@ -235,6 +240,25 @@ bool EventRecorder::processDelayMillis() {
 	return _fastPlayback;
 }
 
+void EventRecorder::processPlaybackEnd() {
+	// The backend quits right after this, without deinitializing the recorder
+	reportBenchmark();
+}
+
+void EventRecorder::reportBenchmark() {
+	if (!_benchmark) {
+		return;
+	}
+	_benchmark = false;
+
+	const uint32 wallTime = (uint32)((g_system->getMicros() - _benchmarkStart) / 1000);
+	const uint32 recordedTime = _fakeTimer - _benchmarkStartTime;
+	const double fps = wallTime ? _benchmarkFrames * 1000.0 / wallTime : 0.0;
+	debug("benchmark:file=%s frames=%u walltime=%u recordedtime=%u fps=%.2f screenshots=%u mismatches=%u",
+		_playbackFile->getHeader().fileName.c_str(), _benchmarkFrames, wallTime, recordedTime, fps,
+		_playbackFile->getCheckedScreenshots(), _playbackFile->getFailedScreenshots());
+}
+
 bool EventRecorder::processAutosave() {
 	return _recordMode == kPassthrough;
 }
@@ -270,6 +294,9 @@ void EventRecorder::processScreenUpdate() {
 		}
 		_processingMillis = true;
 		_fakeTimer = _nextEvent.time;
+		if (_benchmark) {
+			_benchmarkFrames++;
+		}
 		updateSubsystems();
 		_nextEvent = _playbackFile->getNextEvent();
 		if (_recordMode == kRecorderUpdate) {
@@ -380,7 +407,7 @@ Common::String EventRecorder::generateRecordFileName(const Common::String &targe
 }
 
 
-void EventRecorder::init(const Common::String &recordFileName, RecordMode mode) {
+void EventRecorder::init(const Common::String &recordFileName, RecordMode mode, bool benchmark) {
 	_fakeMixerManager = new NullMixerManager();
 	_fakeMixerManager->init();
 	_fakeMixerManager->suspendAudio();
@@ -417,6 +444,15 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 		applyPlaybackSettings();
 		_nextEvent = _playbackFile->getNextEvent();
 	}
+	_benchmark = benchmark && (_recordMode == kRecorderPlayback);
+	if (_benchmark) {
+		// Time only advances along the recorded timeline, so any delay
+		// requested by the engine can be skipped.
+		_fastPlayback = true;
+		_benchmarkFrames = 0;
+		_benchmarkStartTime = _fakeTimer;
+		_benchmarkStart = g_system->getMicros();
+	}
 	if ((_recordMode == kRecorderRecord) || (_recordMode == kRecorderUpdate)) {
 		getConfig();
 	}
@@ -557,7 +593,11 @@ void EventRecorder::registerTimerManager(DefaultTimerManager *timerManager) {
 void EventRecorder::switchTimerManagers() {
 	delete _timerManager;
 	if (_recordMode == kPassthrough) {
+#ifdef SDL_BACKEND
 		_timerManager = new SdlTimerManager();
+#else
+		_timerManager = new DefaultTimerManager();
+#endif
 	} else {
 		_timerManager = new DefaultTimerManager();
 	}
@@ -697,6 +737,10 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
+	// Benchmarks measure the engine, not the drawing of the control panel
+	if (_benchmark) {
+		return;
+	}
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -714,6 +758,9 @@ void EventRecorder::preDrawOverlayGui() {
 }
 
 void EventRecorder::postDrawOverlayGui() {
+	if (_benchmark) {
+		return;
+	}
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -754,10 +801,12 @@ void EventRecorder::setFileHeader() {
 	_recordFile->getHeader().name = _name;
 }
 
+#ifdef SDL_BACKEND
 SDL_Surface *EventRecorder::getSurface(int width, int height) {
 	// Create a RGB565 surface of the requested dimensions.
 	return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 16, 0xF800, 0x07E0, 0x001F, 0x0000);
 }
+#endif
 
 bool EventRecorder::switchMode() {
 	const Plugin *plugin = EngineMan.findPlugin(ConfMan.get("engineid"));
@@ -38,7 +38,10 @@
 #include "backends/mixer/mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "backends/timer/default/default-timer.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
+#endif
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
@@ -77,9 +80,16 @@ public:
 		kRecorderUpdate = 4			/**< kRecorderUpdate, playback existing recording and update all hashes */
 	};
 
-	void init(const Common::String &recordFileName, RecordMode mode);
+	/**
+	 * Start recording or playing back a session.
+	 *
+	 * @param benchmark Play the recording back as fast as possible and report
+	 *                  the time it took when it ends. Only used for playback.
+	 */
+	void init(const Common::String &recordFileName, RecordMode mode, bool benchmark = false);
 	void deinit();
 	bool processDelayMillis();
+	void processPlaybackEnd();
 	uint32 getRandomSeed(const Common::String &name);
 	void processTimeAndDate(TimeDate &td, bool skipRecord);
 	void processMillis(uint32 &millis, bool skipRecord);
@@ -177,7 +187,9 @@ public:
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
@@ -249,6 +261,12 @@ private:
 	bool _fastPlayback;
 	bool _needRedraw;
 	bool _processingMillis;
+
+	void reportBenchmark();
+	bool _benchmark;
+	uint64 _benchmarkStart;
+	uint32 _benchmarkStartTime;
+	uint32 _benchmarkFrames;
 };
 
 } // End of namespace GUI
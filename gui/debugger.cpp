@@ -31,6 +31,8 @@
 #include "common/md5.h"
 #include "common/archive.h"
 #include "common/macresman.h"
+#include "common/memtrack.h"
+#include "common/profiler.h"
 #include "common/stream.h"
 #endif
 
@@ -79,6 +81,12 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+#ifdef ENABLE_MEMORY_TRACKING
+	registerCmd("memory",			WRAP_METHOD(Debugger, cmdMemory));
+#endif
+#ifdef ENABLE_PROFILER
+	registerCmd("profile",			WRAP_METHOD(Debugger, cmdProfile));
+#endif
 }
 
 Debugger::~Debugger() {
@@ -846,6 +854,46 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+#ifdef ENABLE_MEMORY_TRACKING
+bool Debugger::cmdMemory(int argc, const char **argv) {
+	debugPrintf("%s", Common::formatMemoryTagStats().c_str());
+	return true;
+}
+#endif
+
+#ifdef ENABLE_PROFILER
+bool Debugger::cmdProfile(int argc, const char **argv) {
+	if (argc >= 2 && !strcmp(argv[1], "start")) {
+		Common::startProfiling();
+		debugPrintf("Profiling started\n");
+		return true;
+	}
+
+	if (argc >= 2 && !strcmp(argv[1], "stop")) {
+		Common::stopProfiling();
+
+		const char *filename = argc >= 3 ? argv[2] : "scummvm-trace.json";
+		Common::DumpFile out;
+		if (!out.open(filename)) {
+			debugPrintf("Failed to open '%s' for writing\n", filename);
+			return true;
+		}
+
+		if (Common::writeProfilingTrace(out) && out.flush())
+			debugPrintf("Wrote %u zones to '%s', open it in chrome://tracing or https://ui.perfetto.dev\n",
+			            Common::getProfilingZoneCount(), filename);
+		else
+			debugPrintf("Failed to write '%s'\n", filename);
+		return true;
+	}
+
+	debugPrintf("Usage: %s start | stop [<file>]\n", argv[0]);
+	debugPrintf("Records profiling zones until stopped, then writes them as a Chrome trace\n");
+	debugPrintf("(default file: scummvm-trace.json)\n");
+	return true;
+}
+#endif
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
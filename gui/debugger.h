@@ -276,6 +276,12 @@ protected:
 	bool cmdDebugFlagEnable(int argc, const char **argv);
 	bool cmdDebugFlagDisable(int argc, const char **argv);
 	bool cmdExecFile(int argc, const char **argv);
+#ifdef ENABLE_MEMORY_TRACKING
+	bool cmdMemory(int argc, const char **argv);
+#endif
+#ifdef ENABLE_PROFILER
+	bool cmdProfile(int argc, const char **argv);
+#endif
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
@@ -197,6 +197,8 @@ void OptionsDialog::init() {
 	_scalerPopUp = nullptr;
 	_scalerPopUpDesc = nullptr;
 	_scaleFactorPopUp = nullptr;
+	_scalerThreadsPopUp = nullptr;
+	_scalerThreadsPopUpDesc = nullptr;
 	_fullscreenCheckbox = nullptr;
 	_filteringCheckbox = nullptr;
 	_aspectCheckbox = nullptr;
@@ -426,10 +428,17 @@ void OptionsDialog::build() {
 				}
 
 			}
+
+			// Values of 0 and below mean one thread per CPU
+			_scalerThreadsPopUp->setSelected(0);
+			if (ConfMan.hasKey("scaler_threads", _domain))
+				_scalerThreadsPopUp->setSelectedTag(CLIP(ConfMan.getInt("scaler_threads", _domain), 0, 8));
 		} else {
 			_scalerPopUpDesc->setVisible(false);
 			_scalerPopUp->setVisible(false);
 			_scaleFactorPopUp->setVisible(false);
+			_scalerThreadsPopUpDesc->setVisible(false);
+			_scalerThreadsPopUp->setVisible(false);
 		}
 	}
 
@@ -712,6 +721,17 @@ void OptionsDialog::apply() {
 					else if (g_system->getScaleFactor() != defaultScaleFactor)
 						graphicsModeChanged = true;
 				}
+
+				if ((int32)_scalerThreadsPopUp->getSelectedTag() >= 0) {
+					int threads = _scalerThreadsPopUp->getSelectedTag();
+					if (!ConfMan.hasKey("scaler_threads", _domain) || ConfMan.getInt("scaler_threads", _domain) != threads) {
+						ConfMan.setInt("scaler_threads", threads, _domain);
+						graphicsModeChanged = true;
+					}
+				} else if (ConfMan.hasKey("scaler_threads", _domain)) {
+					ConfMan.removeKey("scaler_threads", _domain);
+					graphicsModeChanged = true;
+				}
 			}
 
 			if (_rendererTypePopUp) {
@@ -740,6 +760,7 @@ void OptionsDialog::apply() {
 			ConfMan.removeKey("stretch_mode", _domain);
 			ConfMan.removeKey("scaler", _domain);
 			ConfMan.removeKey("scale_factor", _domain);
+			ConfMan.removeKey("scaler_threads", _domain);
 			ConfMan.removeKey("render_mode", _domain);
 			ConfMan.removeKey("renderer", _domain);
 			ConfMan.removeKey("antialiasing", _domain);
@@ -1259,12 +1280,16 @@ void OptionsDialog::setGraphicSettingsState(bool enabled) {
 		_scalerPopUpDesc->setEnabled(enabled);
 		_scalerPopUp->setEnabled(enabled);
 		_scaleFactorPopUp->setEnabled(enabled);
+		_scalerThreadsPopUpDesc->setEnabled(enabled);
+		_scalerThreadsPopUp->setEnabled(enabled);
 	} else {
 		// Happens when we switch to backend that doesn't support scalers
 		if (_scalerPopUp) {
 			_scalerPopUpDesc->setEnabled(false);
 			_scalerPopUp->setEnabled(false);
 			_scaleFactorPopUp->setEnabled(false);
+			_scalerThreadsPopUpDesc->setEnabled(false);
+			_scalerThreadsPopUp->setEnabled(false);
 		}
 	}
 
@@ -1636,6 +1661,15 @@ void OptionsDialog::addGraphicControls(GuiObject *boss, const Common::String &pr
 
 		_scaleFactorPopUp = new PopUpWidget(boss, prefix + "grScaleFactorPopup");
 		updateScaleFactors(_scalerPopUp->getSelectedTag());
+
+		_scalerThreadsPopUpDesc = new StaticTextWidget(boss, prefix + "grScalerThreadsPopupDesc", _("Scaler threads:"), _("Number of threads scaling the game screen. Only used by the SDL Surface renderer"));
+		_scalerThreadsPopUp = new PopUpWidget(boss, prefix + "grScalerThreadsPopup", _("Number of threads scaling the game screen. Only used by the SDL Surface renderer"));
+
+		_scalerThreadsPopUp->appendEntry(_("<default>"));
+		_scalerThreadsPopUp->appendEntry(Common::U32String());
+		_scalerThreadsPopUp->appendEntry(_("One per CPU"), 0);
+		for (int threads = 1; threads <= 8; threads++)
+			_scalerThreadsPopUp->appendEntry(Common::U32String::format("%d", threads), threads);
 	}
 
 	if (g_system->hasFeature(OSystem::kFeatureShaders)) {
@@ -2055,6 +2089,8 @@ void OptionsDialog::setupGraphicsTab() {
 			_scalerPopUpDesc->setFontColor(ThemeEngine::FontColor::kFontColorOverride);
 		_scalerPopUp->setVisible(true);
 		_scaleFactorPopUp->setVisible(true);
+		_scalerThreadsPopUpDesc->setVisible(true);
+		_scalerThreadsPopUp->setVisible(true);
 	}
 
 	if (g_system->hasFeature(OSystem::kFeatureShaders)) {
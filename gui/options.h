@@ -153,6 +153,8 @@ private:
 	PopUpWidget *_stretchPopUp;
 	StaticTextWidget *_scalerPopUpDesc;
 	PopUpWidget *_scalerPopUp, *_scaleFactorPopUp;
+	StaticTextWidget *_scalerThreadsPopUpDesc;
+	PopUpWidget *_scalerThreadsPopUp;
 	ButtonWidget *_shaderButton;
 	CheckboxWidget *_fullscreenCheckbox;
 	CheckboxWidget *_filteringCheckbox;
@@ -90,13 +90,14 @@ private:
 
 	byte *_ditherPalette;
 	bool _dirtyPalette;
-	byte *_colorMap;
+	const byte *_colorMap;
 	DitherType _ditherType;
 
 	void initializeCodebook(uint16 strip, byte codebookType);
 	void loadCodebook(Common::SeekableReadStream &stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
 	void decodeVectors(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize);
 
+	void freeColorMap();
 	byte findNearestRGB(int index) const;
 	void ditherVectors(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize);
 	void ditherCodebookQT(uint16 strip, byte codebookType, uint16 codebookIndex);
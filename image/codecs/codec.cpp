@@ -44,7 +44,9 @@
 #include "image/codecs/truemotion1.h"
 #include "image/codecs/xan.h"
 
+#include "common/debug.h"
 #include "common/endian.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 namespace Image {
@@ -71,6 +73,40 @@ inline uint16 makeQuickTimeDitherColor(byte r, byte g, byte b) {
 	return ((r & 0xF8) << 6) | ((g & 0xF8) << 1) | (b >> 4);
 }
 
+/**
+ * A shared QuickTime dither table, along with the palette it was built for.
+ */
+struct QuickTimeDitherTableEntry {
+	uint32 hash;
+	uint colorCount;
+	byte palette[256 * 3];
+	byte *table;
+	uint refCount;
+	uint32 buildTime;
+};
+
+typedef Common::List<QuickTimeDitherTableEntry *> QuickTimeDitherTableList;
+
+// Most recently used entries are at the front
+QuickTimeDitherTableList *s_quickTimeDitherTables = nullptr;
+
+// How many tables nobody references anymore are kept around, so that
+// reopening a movie (or opening the next one) with the same palette
+// does not rebuild the table.
+const uint kMaxUnusedQuickTimeDitherTables = 2;
+
+const uint kQuickTimeDitherTableSize = 0x10000;
+
+uint32 hashPalette(const byte *palette, uint colorCount) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+
+	for (uint i = 0; i < colorCount * 3; i++)
+		hash = (hash ^ palette[i]) * 16777619u;
+
+	return hash;
+}
+
 } // End of anonymous namespace
 
 byte *Codec::createQuickTimeDitherTable(const byte *palette, uint colorCount) {
@@ -195,6 +231,100 @@ byte *Codec::createQuickTimeDitherTable(const byte *palette, uint colorCount) {
 	return buf;
 }
 
+const byte *Codec::acquireQuickTimeDitherTable(const byte *palette, uint colorCount) {
+	assert(colorCount <= 256);
+
+	if (!s_quickTimeDitherTables)
+		s_quickTimeDitherTables = new QuickTimeDitherTableList();
+
+	uint32 hash = hashPalette(palette, colorCount);
+
+	for (QuickTimeDitherTableList::iterator it = s_quickTimeDitherTables->begin(); it != s_quickTimeDitherTables->end(); ++it) {
+		QuickTimeDitherTableEntry *entry = *it;
+
+		if (entry->hash != hash || entry->colorCount != colorCount || memcmp(entry->palette, palette, colorCount * 3) != 0)
+			continue;
+
+		entry->refCount++;
+
+		// Move to the front of the list
+		s_quickTimeDitherTables->erase(it);
+		s_quickTimeDitherTables->push_front(entry);
+
+		debug(3, "Codec: Reusing QuickTime dither table for palette %08x (%d users, saved %d bytes and %d ms)",
+			hash, entry->refCount, kQuickTimeDitherTableSize, entry->buildTime);
+		return entry->table;
+	}
+
+	QuickTimeDitherTableEntry *entry = new QuickTimeDitherTableEntry();
+	entry->hash = hash;
+	entry->colorCount = colorCount;
+	memcpy(entry->palette, palette, colorCount * 3);
+	entry->refCount = 1;
+
+	uint32 startTime = g_system->getMillis();
+	entry->table = createQuickTimeDitherTable(palette, colorCount);
+	entry->buildTime = g_system->getMillis() - startTime;
+
+	debug(3, "Codec: Created QuickTime dither table for palette %08x in %d ms", hash, entry->buildTime);
+
+	s_quickTimeDitherTables->push_front(entry);
+	return entry->table;
+}
+
+void Codec::releaseQuickTimeDitherTable(const byte *table) {
+	if (!table || !s_quickTimeDitherTables)
+		return;
+
+	for (QuickTimeDitherTableList::iterator it = s_quickTimeDitherTables->begin(); it != s_quickTimeDitherTables->end(); ++it) {
+		if ((*it)->table != table)
+			continue;
+
+		assert((*it)->refCount > 0);
+		(*it)->refCount--;
+		break;
+	}
+
+	// Throw out the least recently used tables nobody references anymore
+	uint unusedCount = 0;
+
+	for (QuickTimeDitherTableList::iterator it = s_quickTimeDitherTables->begin(); it != s_quickTimeDitherTables->end();) {
+		QuickTimeDitherTableEntry *entry = *it;
+
+		if (entry->refCount == 0 && ++unusedCount > kMaxUnusedQuickTimeDitherTables) {
+			delete[] entry->table;
+			delete entry;
+			it = s_quickTimeDitherTables->erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void Codec::freeQuickTimeDitherTables() {
+	if (!s_quickTimeDitherTables)
+		return;
+
+	for (QuickTimeDitherTableList::iterator it = s_quickTimeDitherTables->begin(); it != s_quickTimeDitherTables->end();) {
+		QuickTimeDitherTableEntry *entry = *it;
+
+		if (entry->refCount == 0) {
+			delete[] entry->table;
+			delete entry;
+			it = s_quickTimeDitherTables->erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (s_quickTimeDitherTables->empty()) {
+		delete s_quickTimeDitherTables;
+		s_quickTimeDitherTables = nullptr;
+	} else {
+		warning("Codec: %d QuickTime dither tables are still in use", (int)s_quickTimeDitherTables->size());
+	}
+}
+
 Codec *createBitmapCodec(uint32 tag, uint32 streamTag, int width, int height, int bitsPerPixel) {
 	// Crusader videos are special cased here because the frame type is not in the "compression"
 	// tag but in the "stream handler" tag for these files
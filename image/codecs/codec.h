@@ -114,6 +114,29 @@ public:
 	 * Create a dither table, as used by QuickTime codecs.
 	 */
 	static byte *createQuickTimeDitherTable(const byte *palette, uint colorCount);
+
+	/**
+	 * Get a shared QuickTime dither table for the given palette.
+	 *
+	 * Tables are cached by palette, so several codecs (or several streams
+	 * opened one after another) dithering to the same palette share one
+	 * table instead of each building its own 64KB copy.
+	 *
+	 * The returned table must be handed back with releaseQuickTimeDitherTable().
+	 */
+	static const byte *acquireQuickTimeDitherTable(const byte *palette, uint colorCount);
+
+	/**
+	 * Release a table obtained from acquireQuickTimeDitherTable().
+	 */
+	static void releaseQuickTimeDitherTable(const byte *table);
+
+	/**
+	 * Free the QuickTime dither tables kept around for later users.
+	 *
+	 * Called at shutdown, once all tables have been released.
+	 */
+	static void freeQuickTimeDitherTables();
 };
 
 /**
@@ -55,7 +55,7 @@ QTRLEDecoder::~QTRLEDecoder() {
 		delete _surface;
 	}
 
-	delete[] _colorMap;
+	releaseQuickTimeDitherTable(_colorMap);
 	delete[] _ditherPalette;
 }
 
@@ -525,8 +525,8 @@ void QTRLEDecoder::setDither(DitherType type, const byte *palette) {
 	memcpy(_ditherPalette, palette, 256 * 3);
 	_dirtyPalette = true;
 
-	delete[] _colorMap;
-	_colorMap = createQuickTimeDitherTable(palette, 256);
+	releaseQuickTimeDitherTable(_colorMap);
+	_colorMap = acquireQuickTimeDitherTable(palette, 256);
 }
 
 void QTRLEDecoder::createSurface() {
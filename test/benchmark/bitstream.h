@@ -0,0 +1,82 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Measures how fast bit streams hand out bits, read in the mixed widths
+ * codecs read codes and fields in. Each layout is read through a memory
+ * bit stream, which refills its whole container at once, and through a
+ * generic stream, which refills one data value at a time.
+ *
+ * Run with "make benchmark"; the results are printed as traces.
+ */
+class BitStreamBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kDataSize = 16 * 1024 * 1024,
+		kPasses = 5
+	};
+
+	template<class BS, class STREAM>
+	static void run(const char *name, const byte *data) {
+		static const uint32 widths[] = { 1, 3, 5, 7, 9, 12, 16, 2, 1, 4, 6, 24 };
+
+		// Stop well before the end, so that all reads are full ones
+		const uint32 end = (kDataSize - 16) * 8;
+		uint32 sum = 0;
+		uint i = 0;
+
+		// Keep the fastest pass, the others were disturbed
+		uint32 time = 0xFFFFFFFF;
+		for (int pass = 0; pass < kPasses; ++pass) {
+			STREAM stream(data, kDataSize);
+			BS bits(stream);
+			sum = 0;
+			i = 0;
+
+			const uint32 start = g_system->getMillis();
+			while (bits.pos() < end)
+				sum += bits.getBits(widths[i++ % ARRAYSIZE(widths)]);
+			time = MIN<uint32>(time, MAX<uint32>(g_system->getMillis() - start, 1));
+		}
+
+		TS_TRACE(Common::String::format("%-18s %6u MB/s, %6u Mreads/s (%08x)",
+		                                name, (uint)(kDataSize / 1000 / time),
+		                                (uint)(i / 1000 / time), sum).c_str());
+	}
+
+public:
+	void test_getBits() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		byte *data = new byte[kDataSize];
+		uint32 seed = 1;
+		for (uint i = 0; i < kDataSize; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = seed >> 16;
+		}
+
+		run<Common::BitStreamMemory8MSB, Common::BitStreamMemoryStream>("Memory 8MSB", data);
+		run<Common::BitStream8MSB, Common::MemoryReadStream>("Stream 8MSB", data);
+		run<Common::BitStreamMemory8LSB, Common::BitStreamMemoryStream>("Memory 8LSB", data);
+		run<Common::BitStream8LSB, Common::MemoryReadStream>("Stream 8LSB", data);
+		run<Common::BitStreamMemory16LELSB, Common::BitStreamMemoryStream>("Memory 16LELSB", data);
+		run<Common::BitStream16LELSB, Common::MemoryReadStream>("Stream 16LELSB", data);
+		run<Common::BitStreamMemory32BEMSB, Common::BitStreamMemoryStream>("Memory 32BEMSB", data);
+		run<Common::BitStream32BEMSB, Common::MemoryReadStream>("Stream 32BEMSB", data);
+
+		// The bit order does not follow the byte order here, so memory bit
+		// streams also refill value by value
+		run<Common::BitStreamMemory16LEMSB, Common::BitStreamMemoryStream>("Memory 16LEMSB", data);
+		run<Common::BitStream16LEMSB, Common::MemoryReadStream>("Stream 16LEMSB", data);
+
+		delete[] data;
+#endif
+	}
+};
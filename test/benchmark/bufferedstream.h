@@ -0,0 +1,143 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bufferedstream.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#include "backends/fs/stdiostream.h"
+#endif
+
+/**
+ * Measures the throughput of file streams read the way engines read their
+ * resources, with many small readUint32LE() calls: once sequentially
+ * through the whole file, and once in small records at random offsets. The
+ * plain file stream, with its default and with a larger stdio buffer, is
+ * compared with the buffered wrappers of the same stream.
+ *
+ * Each pattern is run with the file dropped from the cache of the operating
+ * system first (where supported), and with the file already cached.
+ *
+ * The file is created once as test/stream-benchmark.dat in the build
+ * directory. Run with "make benchmark"; the results are printed as traces.
+ */
+class BufferedStreamBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kFileSize = 32 * 1024 * 1024,
+		kRecords = 4000,
+		kRecordSize = 64
+	};
+
+	enum Wrapper {
+		kPlainFile,
+		kLargeStdioBuffer,
+		kBuffered,
+		kLargeBuffered,
+		kAdaptive
+	};
+
+	static const char *wrapperName(Wrapper wrapper) {
+		switch (wrapper) {
+		case kPlainFile:
+			return "File";
+		case kLargeStdioBuffer:
+			return "File, 256K stdio buffer";
+		case kBuffered:
+			return "Buffered 4K";
+		case kLargeBuffered:
+			return "Buffered 256K";
+		case kAdaptive:
+		default:
+			return "Adaptive 4K-1M";
+		}
+	}
+
+	static Common::FSNode createFile() {
+		Common::FSNode node(Common::Path("test/stream-benchmark.dat"));
+		if (node.exists())
+			return node;
+
+		Common::DumpFile file;
+		file.open(node);
+		uint32 value = 1;
+		for (uint i = 0; i < kFileSize / 4; ++i) {
+			value = value * 1103515245 + 12345;
+			file.writeUint32LE(value);
+		}
+		file.close();
+		return node;
+	}
+
+	static Common::SeekableReadStream *open(const Common::FSNode &node, Wrapper wrapper) {
+		Common::SeekableReadStream *file = node.createReadStream();
+		switch (wrapper) {
+		case kPlainFile:
+			return file;
+		case kLargeStdioBuffer:
+			if (StdioStream *stdioStream = dynamic_cast<StdioStream *>(file))
+				stdioStream->setBufferSize(256 * 1024);
+			return file;
+		case kBuffered:
+			return Common::wrapBufferedSeekableReadStream(file, 4 * 1024, DisposeAfterUse::YES);
+		case kLargeBuffered:
+			return Common::wrapBufferedSeekableReadStream(file, 256 * 1024, DisposeAfterUse::YES);
+		case kAdaptive:
+		default:
+			return Common::wrapAdaptiveBufferedSeekableReadStream(file, 4 * 1024, 1024 * 1024, DisposeAfterUse::YES);
+		}
+	}
+
+	static void run(const Common::FSNode &node, Wrapper wrapper, bool cold) {
+		const Common::String path = node.getPath();
+		if (cold && !Common::evict_file_from_os_cache(path.c_str()))
+			return;
+
+		Common::SeekableReadStream *stream = open(node, wrapper);
+		uint32 sum = 0;
+
+		uint64 start = g_system->getMicros();
+		for (uint i = 0; i < kFileSize / 4; ++i)
+			sum += stream->readUint32LE();
+		const uint64 sequentialTime = MAX<uint64>(g_system->getMicros() - start, 1);
+		TS_ASSERT(!stream->err() && !stream->eos());
+
+		if (cold)
+			Common::evict_file_from_os_cache(path.c_str());
+
+		uint32 seed = 1;
+		start = g_system->getMicros();
+		for (uint i = 0; i < kRecords; ++i) {
+			seed = seed * 1103515245 + 12345;
+			stream->seek((seed >> 4) % (kFileSize / kRecordSize) * kRecordSize);
+			for (uint j = 0; j < kRecordSize / 4; ++j)
+				sum += stream->readUint32LE();
+		}
+		const uint64 randomTime = MAX<uint64>(g_system->getMicros() - start, 1);
+		TS_ASSERT(!stream->err() && !stream->eos());
+
+		delete stream;
+
+		TS_TRACE(Common::String::format("%-24s %s: sequential %5u MB/s, random %7u records/s (%08x)",
+		                                wrapperName(wrapper), cold ? "cold" : "warm",
+		                                (uint)((uint64)kFileSize / sequentialTime),
+		                                (uint)(kRecords * 1000000ULL / randomTime), sum).c_str());
+	}
+
+public:
+	void test_throughput() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Common::FSNode node = createFile();
+		for (int cold = 1; cold >= 0; --cold) {
+			for (int wrapper = kPlainFile; wrapper <= kAdaptive; ++wrapper)
+				run(node, (Wrapper)wrapper, cold);
+		}
+#endif
+	}
+};
@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Compares the time the first file lookup in a game directory of many files
+ * takes when the directories are listed on demand, when the whole tree is
+ * listed, as done before an FSDirectory can be indexed, and when the tree
+ * has been prefetched in the background meanwhile. Also compares many
+ * lookups through a SearchSet, which indexes the directory, with the same
+ * lookups made on the directory itself.
+ *
+ * The tree is created once in test/fsdirectory-benchmark of the build
+ * directory. Run with "make benchmark"; the results are printed as traces.
+ */
+class FSDirectoryBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kDirs = 40,
+		kSubDirs = 5,
+		kFilesPerDir = 50
+	};
+
+	static Common::FSNode createTree() {
+		Common::FSNode root(Common::Path("test/fsdirectory-benchmark"));
+		if (root.exists())
+			return root;
+
+		root.createDirectory();
+		for (int i = 0; i < kDirs; ++i) {
+			Common::FSNode dir = root.getChild(Common::String::format("dir%d", i));
+			dir.createDirectory();
+			for (int j = 0; j < kSubDirs; ++j) {
+				Common::FSNode sub = dir.getChild(Common::String::format("sub%d", j));
+				sub.createDirectory();
+				for (int k = 0; k < kFilesPerDir; ++k) {
+					Common::DumpFile file;
+					file.open(sub.getChild(Common::String::format("file%d.dat", k)));
+				}
+			}
+		}
+		return root;
+	}
+
+	static void report(const char *name, const Common::FSDirectory &dir, uint64 time) {
+		TS_TRACE(Common::String::format("%-24s first lookup %7u us, %4u directories listed, %7u us spent caching",
+		                                name, (uint)time, dir.getListedDirectoryCount(), (uint)dir.getCachingTime()).c_str());
+	}
+
+	static void reportLookups(const char *name, uint count, uint firstTime, uint secondTime, const Common::FSDirectory &dir, uint found) {
+		TS_TRACE(Common::String::format("%-24s %u lookups %7u us, again %7u us, %4u directories listed (%u found)",
+		                                name, count, firstTime, secondTime, dir.getListedDirectoryCount(), found).c_str());
+	}
+
+public:
+	void test_first_lookup() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Common::FSNode root = createTree();
+		const Common::Path path("DIR7/sub3/FILE42.DAT");
+
+		{
+			Common::FSDirectory dir(root, 4);
+			uint64 start = g_system->getMicros();
+			TS_ASSERT(dir.hasFile(path));
+			report("On demand", dir, g_system->getMicros() - start);
+		}
+
+		{
+			Common::FSDirectory dir(root, 4);
+			Common::ArchiveMemberList list;
+			uint64 start = g_system->getMicros();
+			dir.listMembers(list);
+			TS_ASSERT(dir.hasFile(path));
+			report("Whole tree", dir, g_system->getMicros() - start);
+		}
+
+		{
+			Common::FSDirectory dir(root, 4);
+			dir.prefetch();
+			// Give the worker thread time to list the tree
+			g_system->delayMillis(500);
+			Common::ArchiveMemberList list;
+			uint64 start = g_system->getMicros();
+			dir.listMembers(list);
+			TS_ASSERT(dir.hasFile(path));
+			report("Prefetched", dir, g_system->getMicros() - start);
+		}
+#endif
+	}
+
+	void test_search_set_lookups() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Common::FSNode root = createTree();
+
+		// Files all over the tree, a quarter of them missing
+		Common::Array<Common::Path> paths;
+		for (int i = 0; i < 2000; ++i) {
+			const int dir = (i * 7) % kDirs, sub = (i * 3) % kSubDirs, file = (i * 11) % (kFilesPerDir * 4 / 3);
+			paths.push_back(Common::Path(Common::String::format("dir%d/sub%d/file%d.dat", dir, sub, file)));
+		}
+
+		uint found = 0;
+		{
+			Common::FSDirectory dir(root, 4);
+			uint64 start = g_system->getMicros();
+			for (uint i = 0; i < paths.size(); ++i)
+				found += dir.hasFile(paths[i]);
+			const uint firstTime = g_system->getMicros() - start;
+			start = g_system->getMicros();
+			for (uint i = 0; i < paths.size(); ++i)
+				found += dir.hasFile(paths[i]);
+			reportLookups("FSDirectory", paths.size(), firstTime, g_system->getMicros() - start, dir, found);
+		}
+
+		found = 0;
+		{
+			Common::SearchSet set;
+			Common::FSDirectory *dir = new Common::FSDirectory(root, 4);
+			set.add("game", dir);
+			uint64 start = g_system->getMicros();
+			for (uint i = 0; i < paths.size(); ++i)
+				found += set.hasFile(paths[i]);
+			const uint firstTime = g_system->getMicros() - start;
+			start = g_system->getMicros();
+			for (uint i = 0; i < paths.size(); ++i)
+				found += set.hasFile(paths[i]);
+			reportLookups("SearchSet, indexed", paths.size(), firstTime, g_system->getMicros() - start, *dir, found);
+		}
+#endif
+	}
+};
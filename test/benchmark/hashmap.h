@@ -0,0 +1,80 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Compares the speed of inserting, looking up, iterating over and erasing
+ * entries of HashMap and FlatHashMap, with integer and string keys.
+ *
+ * Run with "make benchmark"; the results are printed as traces.
+ */
+class HashMapBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kEntries = 20000,
+		kRounds = 20
+	};
+
+	template<class Map, class Key>
+	static void run(const char *name, const Common::Array<Key> &keys) {
+		uint32 insertTime = 0, lookupTime = 0, iterateTime = 0, eraseTime = 0;
+		uint found = 0, sum = 0;
+
+		for (int round = 0; round < kRounds; ++round) {
+			Map map;
+
+			uint32 start = g_system->getMillis();
+			for (uint i = 0; i < keys.size(); ++i)
+				map[keys[i]] = i;
+			insertTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int repeat = 0; repeat < 4; ++repeat) {
+				for (uint i = 0; i < keys.size(); ++i)
+					found += map.contains(keys[(i * 7919) % keys.size()]);
+			}
+			lookupTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int repeat = 0; repeat < 4; ++repeat) {
+				for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+					sum += it->_value;
+			}
+			iterateTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (uint i = 0; i < keys.size(); ++i)
+				map.erase(keys[i]);
+			eraseTime += g_system->getMillis() - start;
+		}
+
+		TS_TRACE(Common::String::format("%-24s insert %5u ms, lookup %5u ms, iterate %5u ms, erase %5u ms (%u %u)",
+		                                name, insertTime, lookupTime, iterateTime, eraseTime, found, sum).c_str());
+	}
+
+public:
+	void test_hashmaps() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Common::Array<int> intKeys;
+		Common::Array<Common::String> stringKeys;
+		uint32 seed = 1;
+		for (int i = 0; i < kEntries; ++i) {
+			seed = seed * 1103515245 + 12345;
+			intKeys.push_back((int)seed);
+			stringKeys.push_back(Common::String::format("data/room%d/sprite_%08x.bmp", i % 97, seed));
+		}
+
+		run<Common::HashMap<int, uint>, int>("HashMap<int>", intKeys);
+		run<Common::FlatHashMap<int, uint>, int>("FlatHashMap<int>", intKeys);
+		run<Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>("HashMap<String>", stringKeys);
+		run<Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>, Common::String>("FlatHashMap<String>", stringKeys);
+#endif
+	}
+};
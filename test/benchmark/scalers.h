@@ -0,0 +1,74 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../graphics/scaler_helper.h"
+#include "../null_osystem.h"
+
+/**
+ * Measures the throughput of every scaler plugin, at every factor and in
+ * every pixel format, over the test screen of the scaler tests.
+ *
+ * Run with "make benchmark"; the results are printed as traces.
+ */
+class ScalerBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		/** Minimum time to scale for each configuration */
+		kMinimumMillis = 250
+	};
+
+public:
+	void test_scalers() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Common::Array<ScalerPluginObject *> plugins;
+		createScalerPlugins(plugins);
+
+		for (uint i = 0; i < plugins.size(); ++i) {
+			const ScalerPluginObject *plugin = plugins[i];
+			const Common::Array<uint> &factors = plugin->getFactors();
+
+			for (int f = 0; f < ScalerTest::kFormatCount; ++f) {
+				const ScalerTest::Format format = (ScalerTest::Format)f;
+				const Graphics::PixelFormat pixelFormat = ScalerTest::getFormat(format);
+
+				Graphics::Surface src, dst;
+				ScalerTest::createSource(src, pixelFormat);
+				Scaler *scaler = plugin->createInstance(pixelFormat);
+
+				for (uint j = 0; j < factors.size(); ++j) {
+					scaler->setFactor(factors[j]);
+
+					// Warm up caches and lookup tables first
+					ScalerTest::scaleSource(*scaler, src, dst);
+
+					uint frames = 0;
+					uint32 elapsed = 0;
+					const uint32 start = g_system->getMillis();
+					do {
+						ScalerTest::scaleSource(*scaler, src, dst);
+						++frames;
+						elapsed = g_system->getMillis() - start;
+					} while (elapsed < kMinimumMillis);
+
+					const double pixels = (double)frames * ScalerTest::kScreenWidth * ScalerTest::kScreenHeight;
+					const double mpixels = pixels / (elapsed * 1000.0);
+					TS_TRACE(Common::String::format("%-10s %ux %-8s %8.2f MPixel/s (source) %8.2f MPixel/s (output) %8.3f ms/frame",
+					                                plugin->getName(), factors[j], ScalerTest::getFormatName(format),
+					                                mpixels, mpixels * factors[j] * factors[j],
+					                                (double)elapsed / frames).c_str());
+				}
+
+				delete scaler;
+				dst.free();
+				src.free();
+			}
+		}
+
+		destroyScalerPlugins(plugins);
+#endif
+	}
+};
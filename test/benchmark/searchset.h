@@ -0,0 +1,132 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/hashmap.h"
+#include "common/memstream.h"
+#include "common/path.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Measures the number of files SearchMan-like search sets look up per
+ * second, on a set of archives which keep their members in a map indexed by
+ * Path, as FSDirectory does. The file names are built anew for each lookup,
+ * as engines do when opening files.
+ *
+ * The archives are searched through the index of the search set, and, for
+ * comparison, one by one as done for archives which cannot list their files,
+ * and for those which cannot list them yet, such as FSDirectory until its
+ * whole tree is cached.
+ *
+ * Run with "make benchmark"; the results are printed as traces.
+ */
+class SearchSetBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kArchives = 8,
+		kFilesPerArchive = 2500,
+		kLookups = 200000
+	};
+
+	class PathArchive : public Common::Archive {
+		typedef Common::HashMap<Common::Path, uint, Common::Path::IgnoreCaseAndMac_Hash, Common::Path::IgnoreCaseAndMac_EqualsTo> MemberMap;
+		MemberMap _members;
+		MemberPathListing _listing;
+
+	public:
+		explicit PathArchive(MemberPathListing listing) : _listing(listing) {}
+
+		void addMember(const Common::Path &path) {
+			_members[path] = _members.size();
+		}
+
+		bool hasFile(const Common::Path &path) const override {
+			return _members.contains(path);
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			for (MemberMap::const_iterator it = _members.begin(); it != _members.end(); ++it)
+				list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(it->_key.toString(), this)));
+			return _members.size();
+		}
+
+		MemberPathListing listMemberPaths(Common::Array<Common::Path> &paths) const override {
+			if (_listing != kMemberPathsListed)
+				return _listing;
+			for (MemberMap::const_iterator it = _members.begin(); it != _members.end(); ++it)
+				paths.push_back(it->_key);
+			return kMemberPathsListed;
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+			if (!hasFile(path))
+				return Common::ArchiveMemberPtr();
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path.toString(), this));
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+			static const byte data[4] = { 0, 1, 2, 3 };
+			if (!hasFile(path))
+				return nullptr;
+			return new Common::MemoryReadStream(data, sizeof(data));
+		}
+	};
+
+	static Common::String fileName(uint archive, uint file) {
+		return Common::String::format("Data%u/Room%u/Sprite_%04u.BMP", archive, file % 53, file);
+	}
+
+	static void run(const char *name, Common::Archive::MemberPathListing listing) {
+		Common::SearchSet searchSet;
+		for (uint i = 0; i < kArchives; ++i) {
+			PathArchive *archive = new PathArchive(listing);
+			for (uint j = 0; j < kFilesPerArchive; ++j)
+				archive->addMember(Common::Path(fileName(i, j)));
+			searchSet.add(Common::String::format("archive%u", i), archive, i);
+		}
+
+		// Look up lowercase names, as most engines don't match the case
+		Common::Array<Common::String> names;
+		uint32 seed = 1;
+		for (uint i = 0; i < kLookups; ++i) {
+			seed = seed * 1103515245 + 12345;
+			names.push_back(fileName((seed >> 8) % kArchives, (seed >> 16) % kFilesPerArchive));
+			names.back().toLowercase();
+		}
+
+		// Let the search set index the archives
+		searchSet.hasFile(Common::Path(names[0]));
+
+		uint found = 0;
+		uint32 start = g_system->getMillis();
+		for (uint i = 0; i < kLookups; ++i) {
+			Common::SeekableReadStream *stream = searchSet.createReadStreamForMember(Common::Path(names[i]));
+			found += stream != nullptr;
+			delete stream;
+		}
+		const uint32 openTime = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		start = g_system->getMillis();
+		for (uint i = 0; i < kLookups; ++i)
+			found += searchSet.hasFile(Common::Path(names[i] + ".missing"));
+		const uint32 missTime = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		TS_ASSERT_EQUALS(found, (uint)kLookups);
+		TS_TRACE(Common::String::format("%-20s %d archives: %8u opens/s, %8u missed lookups/s",
+		                                name, kArchives, (uint)(kLookups * 1000ULL / openTime),
+		                                (uint)(kLookups * 1000ULL / missTime)).c_str());
+	}
+
+public:
+	void test_lookups() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		run("Indexed archives", Common::Archive::kMemberPathsListed);
+		run("Unindexed archives", Common::Archive::kMemberPathsNotListable);
+		run("Not indexed yet", Common::Archive::kMemberPathsNotListedYet);
+#endif
+	}
+};
@@ -0,0 +1,78 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/rect.h"
+#include "common/smallarray.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Compares Array and SmallArray on short-lived lists, like the dirty
+ * rectangle lists engines build every frame: most of them are short, a few
+ * are long. Reports the time taken and the number of heap allocations, which
+ * are counted by watching the storage of the arrays change.
+ *
+ * Run with "make benchmark"; the results are printed as traces.
+ */
+class SmallArrayBenchmarkSuite : public CxxTest::TestSuite {
+	enum {
+		kFrames = 200000
+	};
+
+	static bool rectLess(const Common::Rect &a, const Common::Rect &b) {
+		return a.top < b.top || (a.top == b.top && a.left < b.left);
+	}
+
+	template<class ArrayType>
+	static void addRect(ArrayType &array, const Common::Rect &rect, uint &allocations) {
+		const Common::Rect *oldData = array.data();
+		array.push_back(rect);
+		if (array.data() != oldData)
+			allocations++;
+	}
+
+	template<class ArrayType>
+	static void run(const char *name, const Common::Array<uint> &counts) {
+		uint allocations = 0;
+		int sum = 0;
+
+		const uint32 start = g_system->getMillis();
+		for (uint frame = 0; frame < counts.size(); ++frame) {
+			ArrayType rects;
+			for (uint i = 0; i < counts[frame]; ++i) {
+				const int16 pos = (frame * 7 + i * 13) % 320;
+				addRect(rects, Common::Rect(pos, pos / 2, pos + 16, pos / 2 + 16), allocations);
+			}
+
+			Common::sort(rects.begin(), rects.end(), rectLess);
+			for (typename ArrayType::const_iterator it = rects.begin(); it != rects.end(); ++it)
+				sum += it->top;
+		}
+		const uint32 time = g_system->getMillis() - start;
+
+		TS_TRACE(Common::String::format("%-22s %5u ms, %7u allocations (%d)",
+		                                name, time, allocations, sum).c_str());
+	}
+
+public:
+	void test_smallarray() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		// Mostly a handful of entries, sometimes a few dozen
+		Common::Array<uint> counts;
+		uint32 seed = 1;
+		for (int frame = 0; frame < kFrames; ++frame) {
+			seed = seed * 1103515245 + 12345;
+			const uint r = (seed >> 16) & 0xFF;
+			counts.push_back(r < 240 ? r % 8 : 8 + r % 40);
+		}
+
+		run<Common::Array<Common::Rect> >("Array<Rect>", counts);
+		run<Common::SmallArray<Common::Rect, 8> >("SmallArray<Rect, 8>", counts);
+		run<Common::SmallArray<Common::Rect, 16> >("SmallArray<Rect, 16>", counts);
+#endif
+	}
+};
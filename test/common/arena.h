@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/arena.h"
+#include "common/str.h"
+
+class ArenaTestSuite : public CxxTest::TestSuite
+{
+	struct Point {
+		int x, y;
+		Point() : x(-1), y(-2) {}
+		Point(int x_, int y_) : x(x_), y(y_) {}
+	};
+
+	public:
+	void test_allocate() {
+		Common::Arena arena(256);
+		TS_ASSERT_EQUALS(arena.getCapacity(), 0U);
+
+		byte *a = (byte *)arena.allocate(10);
+		byte *b = (byte *)arena.allocate(10);
+		TS_ASSERT(a != nullptr && b != nullptr);
+		TS_ASSERT_EQUALS((uintptr)a % Common::Arena::kDefaultAlignment, 0U);
+		TS_ASSERT_EQUALS((uintptr)b % Common::Arena::kDefaultAlignment, 0U);
+		TS_ASSERT(b >= a + 10);
+
+		byte *c = (byte *)arena.allocate(3, 1);
+		byte *d = (byte *)arena.allocate(8, 64);
+		TS_ASSERT_EQUALS(c, b + 10);
+		TS_ASSERT_EQUALS((uintptr)d % 64, 0U);
+
+		memset(a, 1, 10);
+		memset(b, 2, 10);
+		TS_ASSERT_EQUALS(a[9], 1);
+		TS_ASSERT_EQUALS(b[0], 2);
+
+		// Allocations larger than the blocks get a block of their own
+		byte *big = (byte *)arena.allocate(1000);
+		memset(big, 3, 1000);
+		TS_ASSERT(arena.getCapacity() >= 1256U);
+		TS_ASSERT(arena.getUsedSize() >= 1033U);
+	}
+
+	void test_objects() {
+		Common::Arena arena(64);
+
+		Point *points = arena.allocArray<Point>(40);
+		for (int i = 0; i < 40; ++i) {
+			TS_ASSERT_EQUALS(points[i].x, -1);
+			TS_ASSERT_EQUALS(points[i].y, -2);
+		}
+
+		Point *p = new (arena) Point(3, 4);
+		TS_ASSERT_EQUALS(p->x, 3);
+		TS_ASSERT_EQUALS(p->y, 4);
+
+		const char *s1 = arena.copyString("hello");
+		const char *s2 = arena.copyString(Common::String("world"));
+		TS_ASSERT_EQUALS(Common::String(s1), "hello");
+		TS_ASSERT_EQUALS(Common::String(s2), "world");
+	}
+
+	void test_markers() {
+		Common::Arena arena(128);
+
+		arena.allocate(100);
+		const Common::Arena::Marker marker = arena.getMarker();
+		const size_t used = arena.getUsedSize();
+
+		// Fill a few more blocks, then rewind to the marker
+		for (int i = 0; i < 10; ++i)
+			arena.allocate(100);
+		const size_t capacity = arena.getCapacity();
+		const size_t highWaterMark = arena.getHighWaterMark();
+		TS_ASSERT(highWaterMark >= 1100U);
+
+		arena.rewind(marker);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), used);
+
+		// The blocks are reused
+		for (int i = 0; i < 10; ++i)
+			arena.allocate(100);
+		TS_ASSERT_EQUALS(arena.getCapacity(), capacity);
+		TS_ASSERT_EQUALS(arena.getHighWaterMark(), highWaterMark);
+
+		arena.reset();
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 0U);
+		TS_ASSERT_EQUALS(arena.getCapacity(), capacity);
+		byte *data = (byte *)arena.allocate(16);
+#ifndef RELEASE_BUILD
+		// Released memory is poisoned
+		TS_ASSERT_EQUALS(data[0], 0xDD);
+		TS_ASSERT_EQUALS(data[15], 0xDD);
+#endif
+		data[0] = 0;
+
+		// Nested markers
+		const Common::Arena::Marker outer = arena.getMarker();
+		arena.allocate(50);
+		const Common::Arena::Marker inner = arena.getMarker();
+		arena.allocate(500);
+		arena.rewind(inner);
+		arena.allocate(10);
+		arena.rewind(outer);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 16U);
+
+		arena.freeMemory();
+		TS_ASSERT_EQUALS(arena.getCapacity(), 0U);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 0U);
+		TS_ASSERT(arena.allocate(8) != nullptr);
+	}
+};
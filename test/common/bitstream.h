@@ -255,4 +255,52 @@ public:
 		tmpl_align_16<Common::MemoryReadStream, Common::BitStream16BELSB>();
 		tmpl_align_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BELSB>();
 	}
+
+private:
+	template<class BS, class BSMemory>
+	void tmpl_memory_matches_stream() {
+		// Reading the same data through a memory-backed bit stream, which
+		// refills several values at once, has to give the same bits as the
+		// generic stream-backed one, right up to and past the end.
+		byte contents[37];
+		for (uint i = 0; i < sizeof(contents); i++)
+			contents[i] = (byte)(i * 73 + 41);
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStreamMemoryStream bms(contents, sizeof(contents));
+
+		BS bs(ms);
+		BSMemory bsMemory(bms);
+
+		static const uint32 widths[] = { 1, 7, 13, 32, 3, 17, 24, 5, 31, 2 };
+
+		for (uint i = 0; bs.pos() < bs.size() + 32; i++) {
+			uint32 n = widths[i % ARRAYSIZE(widths)];
+
+			TS_ASSERT_EQUALS(bsMemory.peekBits(n), bs.peekBits(n));
+
+			if (i % 5 == 4) {
+				bs.skip(n);
+				bsMemory.skip(n);
+			} else {
+				TS_ASSERT_EQUALS(bsMemory.getBits(n), bs.getBits(n));
+			}
+
+			TS_ASSERT_EQUALS(bsMemory.pos(), bs.pos());
+			TS_ASSERT_EQUALS(bsMemory.eos(), bs.eos());
+		}
+	}
+public:
+	void test_memory_matches_stream() {
+		tmpl_memory_matches_stream<Common::BitStream8MSB, Common::BitStreamMemory8MSB>();
+		tmpl_memory_matches_stream<Common::BitStream8LSB, Common::BitStreamMemory8LSB>();
+		tmpl_memory_matches_stream<Common::BitStream16LEMSB, Common::BitStreamMemory16LEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream16LELSB, Common::BitStreamMemory16LELSB>();
+		tmpl_memory_matches_stream<Common::BitStream16BEMSB, Common::BitStreamMemory16BEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream16BELSB, Common::BitStreamMemory16BELSB>();
+		tmpl_memory_matches_stream<Common::BitStream32LEMSB, Common::BitStreamMemory32LEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>();
+		tmpl_memory_matches_stream<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream32BELSB, Common::BitStreamMemory32BELSB>();
+	}
 };
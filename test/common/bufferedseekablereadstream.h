@@ -1,5 +1,6 @@
 #include <cxxtest/TestSuite.h>
 
+#include "common/array.h"
 #include "common/memstream.h"
 #include "common/bufferedstream.h"
 
@@ -91,4 +92,134 @@ class BufferedSeekableReadStreamTestSuite : public CxxTest::TestSuite {
 
 		delete &ssrs;
 	}
+
+	/** Records the reads and the readahead hints of the wrapped stream. */
+	class RecordingReadStream : public Common::MemoryReadStream {
+	public:
+		Common::Array<uint32> reads;
+		Common::Array<int64> readAheads;
+
+		RecordingReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size) {}
+
+		uint32 read(void *dataPtr, uint32 dataSize) override {
+			reads.push_back(dataSize);
+			return Common::MemoryReadStream::read(dataPtr, dataSize);
+		}
+
+		void readAhead(int64 offset, uint32 size) override {
+			readAheads.push_back(offset);
+		}
+	};
+
+	void test_adaptive_traverse() {
+		byte contents[100];
+		for (byte i = 0; i < 100; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, 100);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapAdaptiveBufferedSeekableReadStream(&ms, 4, 16, DisposeAfterUse::NO);
+
+		byte i, b;
+		for (i = 0; i < 100; ++i) {
+			TS_ASSERT(!ssrs.eos());
+
+			TS_ASSERT_EQUALS(i, ssrs.pos());
+
+			ssrs.read(&b, 1);
+			TS_ASSERT_EQUALS(i, b);
+		}
+
+		TS_ASSERT(!ssrs.eos());
+
+		TS_ASSERT_EQUALS((uint)0, ssrs.read(&b, 1));
+		TS_ASSERT(ssrs.eos());
+
+		ssrs.seek(-10, SEEK_END);
+		TS_ASSERT(!ssrs.eos());
+		TS_ASSERT_EQUALS(ssrs.readByte(), 90);
+
+		delete &ssrs;
+	}
+
+	void test_adaptive_seek() {
+		byte contents[100];
+		for (byte i = 0; i < 100; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, 100);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapAdaptiveBufferedSeekableReadStream(&ms, 4, 16, DisposeAfterUse::NO);
+
+		ssrs.seek(1, SEEK_SET);
+		TS_ASSERT_EQUALS(ssrs.pos(), 1);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 1);
+
+		ssrs.seek(50, SEEK_CUR);
+		TS_ASSERT_EQUALS(ssrs.pos(), 52);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 52);
+
+		ssrs.seek(-3, SEEK_CUR);
+		TS_ASSERT_EQUALS(ssrs.pos(), 50);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 50);
+
+		ssrs.seek(0, SEEK_END);
+		TS_ASSERT_EQUALS(ssrs.pos(), 100);
+		TS_ASSERT(!ssrs.eos());
+		ssrs.readByte();
+		TS_ASSERT(ssrs.eos());
+
+		byte readBuffer[40];
+		ssrs.seek(10, SEEK_SET);
+		TS_ASSERT_EQUALS(ssrs.read(readBuffer, 40), 40U);
+		TS_ASSERT_EQUALS(readBuffer[0], 10);
+		TS_ASSERT_EQUALS(readBuffer[39], 49);
+		TS_ASSERT_EQUALS(ssrs.pos(), 50);
+		ssrs.seek(-1, SEEK_CUR);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 49);
+
+		ssrs.seek(90, SEEK_SET);
+		TS_ASSERT_EQUALS(ssrs.read(readBuffer, 40), 10U);
+		TS_ASSERT_EQUALS(readBuffer[9], 99);
+		TS_ASSERT(ssrs.eos());
+
+		delete &ssrs;
+	}
+
+	void test_adaptive_refills() {
+		byte contents[256] = { 0 };
+		RecordingReadStream rs(contents, 256);
+
+		Common::SeekableReadStream *stream
+			= Common::wrapAdaptiveBufferedSeekableReadStream(&rs, 4, 32, DisposeAfterUse::NO);
+
+		// Sequential reads get larger refills, and the next one is read ahead
+		for (int i = 0; i < 124; ++i)
+			stream->readByte();
+		TS_ASSERT_EQUALS(rs.reads.size(), 6U);
+		TS_ASSERT_EQUALS(rs.reads[0], 4U);
+		TS_ASSERT_EQUALS(rs.reads[1], 8U);
+		TS_ASSERT_EQUALS(rs.reads[2], 16U);
+		TS_ASSERT_EQUALS(rs.reads[3], 32U);
+		TS_ASSERT_EQUALS(rs.reads[5], 32U);
+		TS_ASSERT_EQUALS(rs.readAheads.size(), 5U);
+		TS_ASSERT_EQUALS(rs.readAheads[0], 12);
+
+		// Skipping less than a refill is still sequential
+		stream->skip(10);
+		stream->readByte();
+		TS_ASSERT_EQUALS(rs.reads.back(), 32U);
+
+		// Seeking elsewhere starts over with small refills, and seeking
+		// back into the buffer doesn't read anything
+		stream->seek(8, SEEK_SET);
+		stream->readUint32LE();
+		TS_ASSERT_EQUALS(rs.reads.back(), 4U);
+		const uint reads = rs.reads.size();
+		stream->seek(9, SEEK_SET);
+		stream->readUint16LE();
+		TS_ASSERT_EQUALS(rs.reads.size(), reads);
+
+		delete stream;
+	}
 };
@@ -0,0 +1,178 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringMap;
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		StringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT(!container2.contains("foo"));
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		StringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(1);
+		container.erase(2);
+		container.erase(container.find(3));
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 1U);
+	}
+
+	void test_lookup() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container.setVal(2, 45);
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+		TS_ASSERT_EQUALS(containerRef[0], 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(1), -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(2), 45);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int value = 0;
+		TS_ASSERT(containerRef.tryGetVal(2, value));
+		TS_ASSERT_EQUALS(value, 45);
+		TS_ASSERT(!containerRef.tryGetVal(3, value));
+		TS_ASSERT_EQUALS(containerRef.find(3), containerRef.end());
+		TS_ASSERT_EQUALS(containerRef.find(2)->_value, 45);
+	}
+
+	void test_copy() {
+		StringMap map1, map2;
+		map1["foo"] = "bar";
+		map1["baz"] = "quux";
+		map1.erase("baz");
+		map2 = map1;
+		StringMap map3(map2);
+		map1["foo"] = "changed";
+		TS_ASSERT_EQUALS(map2["foo"], "bar");
+		TS_ASSERT_EQUALS(map3["FOO"], "bar");
+		TS_ASSERT(!map3.contains("baz"));
+		TS_ASSERT_EQUALS(map3.size(), 1U);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT_EQUALS(found, 16+8+4);
+
+		// Erasing while iterating doesn't move the other entries
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			if (i->_key != 3)
+				container.erase(i);
+		}
+		TS_ASSERT_EQUALS(container.size(), 1U);
+		TS_ASSERT_EQUALS(container.begin()->_key, 3);
+	}
+
+	void test_grow() {
+		// Insert and erase enough keys to grow the table repeatedly and to
+		// fill it with erased slots, using keys which collide in the low bits.
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 5000; ++i)
+			container[i << 8] = i;
+		TS_ASSERT_EQUALS(container.size(), 5000U);
+		for (int i = 0; i < 5000; i += 2)
+			container.erase(i << 8);
+		TS_ASSERT_EQUALS(container.size(), 2500U);
+		for (int i = 0; i < 5000; ++i) {
+			TS_ASSERT_EQUALS(container.contains(i << 8), (i & 1) != 0);
+			if (i & 1)
+				TS_ASSERT_EQUALS(container[i << 8], i);
+		}
+
+		for (int round = 0; round < 10; ++round) {
+			for (int i = 0; i < 1000; ++i)
+				container[-1 - i] = round;
+			for (int i = 0; i < 1000; ++i)
+				container.erase(-1 - i);
+		}
+		TS_ASSERT_EQUALS(container.size(), 2500U);
+
+		uint count = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator i = container.begin(); i != container.end(); ++i)
+			++count;
+		TS_ASSERT_EQUALS(count, 2500U);
+
+		Common::FlatHashMap<int, int> reserved;
+		reserved.reserve(1000);
+		for (int i = 0; i < 1000; ++i)
+			reserved[i] = i;
+		TS_ASSERT_EQUALS(reserved.size(), 1000U);
+		TS_ASSERT_EQUALS(reserved[999], 999);
+	}
+};
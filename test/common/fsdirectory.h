@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/str.h"
+#include "../null_osystem.h"
+
+class FSDirectoryTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kSubDirs = 4,
+		kFilesPerDir = 5
+	};
+
+	// The temporary directory holding the tree, removed after each test
+	Common::String _tempDir;
+
+	// Creates root/file.txt, root/dirN/fileN.txt and root/dirN/sub/deep.txt
+	// in a new temporary directory
+	bool createTree(Common::FSNode &root) {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		_tempDir = Common::create_temp_directory();
+#endif
+		if (_tempDir.empty())
+			return false;
+
+		root = Common::FSNode(Common::Path(_tempDir));
+		createFile(root.getChild("file.txt"));
+
+		for (int i = 0; i < kSubDirs; ++i) {
+			Common::FSNode dir = root.getChild(Common::String::format("dir%d", i));
+			dir.createDirectory();
+			for (int j = 0; j < kFilesPerDir; ++j)
+				createFile(dir.getChild(Common::String::format("file%d.txt", j)));
+
+			Common::FSNode sub = dir.getChild("sub");
+			sub.createDirectory();
+			createFile(sub.getChild("deep.txt"));
+		}
+
+		return true;
+	}
+
+	static void createFile(const Common::FSNode &node) {
+		Common::DumpFile file;
+		TS_ASSERT(file.open(node));
+		file.writeString(node.getName());
+	}
+
+	public:
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!_tempDir.empty())
+			Common::remove_temp_directory(_tempDir.c_str());
+#endif
+		_tempDir.clear();
+	}
+
+	void test_lookups_on_demand() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::FSNode root;
+		if (!createTree(root))
+			return;
+
+		// Only the directories leading to the files looked up are listed
+		Common::FSDirectory dir(root, 3);
+		TS_ASSERT(dir.hasFile("DIR1/sub/deep.txt"));
+		TS_ASSERT_EQUALS(dir.getListedDirectoryCount(), 3U);
+		TS_ASSERT(dir.hasFile("dir2/file0.txt"));
+		TS_ASSERT(!dir.hasFile("dir2/missing.txt"));
+		TS_ASSERT(!dir.hasFile("missing/file0.txt"));
+		TS_ASSERT(dir.hasFile("file.txt"));
+		TS_ASSERT_EQUALS(dir.getListedDirectoryCount(), 4U);
+
+		Common::SeekableReadStream *stream = dir.createReadStreamForMember("dir3/file4.txt");
+		TS_ASSERT(stream);
+		if (stream)
+			TS_ASSERT_EQUALS(stream->readString(0, 9), "file4.txt");
+		delete stream;
+
+		// Listing the members lists the whole tree
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(dir.listMembers(list), 1 + kSubDirs * (kFilesPerDir + 1));
+		TS_ASSERT(dir.hasFile("dir0/sub/deep.txt"));
+
+		// The depth still limits the files found
+		Common::FSDirectory shallow(root, 2);
+		TS_ASSERT(shallow.hasFile("dir0/file0.txt"));
+		TS_ASSERT(!shallow.hasFile("dir0/sub/deep.txt"));
+		TS_ASSERT_EQUALS(shallow.listMembers(list), 1 + kSubDirs * kFilesPerDir);
+#endif
+	}
+
+	void test_search_set_index() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::FSNode root;
+		if (!createTree(root))
+			return;
+
+		// Listing the paths lists the whole tree, even after lookups on demand
+		Common::FSDirectory dir(root, 3);
+		TS_ASSERT(dir.hasFile("dir1/file0.txt"));
+		Common::Array<Common::Path> paths;
+		TS_ASSERT_EQUALS(dir.listMemberPaths(paths), Common::Archive::kMemberPathsListed);
+		TS_ASSERT_EQUALS(paths.size(), 1U + kSubDirs * (kFilesPerDir + 1));
+
+		// A SearchSet indexes the directory on its first lookup, and then
+		// doesn't need it to list anything else
+		Common::SearchSet set;
+		Common::FSDirectory *indexed = new Common::FSDirectory(root, 3);
+		set.add("dir", indexed);
+		TS_ASSERT(set.hasFile("dir2/sub/deep.txt"));
+		const uint listedDirs = indexed->getListedDirectoryCount();
+		TS_ASSERT_EQUALS(listedDirs, 1U + kSubDirs * 2);
+		TS_ASSERT(set.hasFile("DIR0/file1.txt"));
+		TS_ASSERT(!set.hasFile("dir3/missing.txt"));
+		TS_ASSERT_EQUALS(indexed->getListedDirectoryCount(), listedDirs);
+#endif
+	}
+
+	void test_prefetch() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::FSNode root;
+		if (!createTree(root))
+			return;
+
+		// Listing the members waits for the worker thread, the lookups are
+		// only done once it is over
+		Common::FSDirectory dir(root, 3);
+		dir.prefetch();
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(dir.listMembers(list), 1 + kSubDirs * (kFilesPerDir + 1));
+		TS_ASSERT_EQUALS(dir.getListedDirectoryCount(), 1U + kSubDirs * 2);
+
+		TS_ASSERT(dir.hasFile("dir1/sub/deep.txt"));
+		TS_ASSERT(dir.hasFile("dir3/FILE2.TXT"));
+		TS_ASSERT(!dir.hasFile("dir3/missing.txt"));
+		TS_ASSERT_EQUALS(dir.getListedDirectoryCount(), 1U + kSubDirs * 2);
+
+		// The worker thread rebuilds the prefix from its own copy
+		Common::FSDirectory prefixed(Common::Path("game/data"), root, 3);
+		prefixed.prefetch();
+		list.clear();
+		TS_ASSERT_EQUALS(prefixed.listMembers(list), 1 + kSubDirs * (kFilesPerDir + 1));
+		TS_ASSERT(prefixed.hasFile("game/data/dir1/sub/deep.txt"));
+		TS_ASSERT(!prefixed.hasFile("dir1/sub/deep.txt"));
+
+		// A directory being prefetched can be destroyed right away
+		Common::FSDirectory other(root, 3);
+		other.prefetch();
+#endif
+	}
+};
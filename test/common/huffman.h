@@ -94,4 +94,126 @@ class HuffmanTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[5]);
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[6]);
 	}
+
+	void test_multi_level_tables() {
+		/*
+		 * Codes longer than the primary lookup table go through sub-tables.
+		 * Build a deep canonical code (lengths 1 to 20, the longest one
+		 * twice), encode a pseudo-random symbol sequence with it and check
+		 * it decodes the same for different table sizes, bit orders and
+		 * data value sizes.
+		 */
+
+		const uint32 codeCount = 21;
+		uint8 lengths[codeCount];
+		uint32 codes[codeCount];
+		uint32 symbols[codeCount];
+
+		for (uint32 i = 0; i < codeCount; i++) {
+			lengths[i] = MIN<uint32>(i + 1, 20);
+			symbols[i] = i * 3 + 1;
+		}
+
+		makeCanonicalCodes(lengths, codeCount, codes);
+
+		uint32 sequence[200];
+		uint32 seed = 12345;
+		for (uint32 i = 0; i < ARRAYSIZE(sequence); i++) {
+			// Favor the short codes, but hit the long ones as well
+			seed = seed * 1103515245 + 12345;
+			uint32 r = (seed >> 16) & 0x7FFF;
+			sequence[i] = (r % 4 == 0) ? (r / 4) % codeCount : (r % 3);
+		}
+
+		byte msbData[1024];
+		byte lsbData[1024];
+		encode(sequence, ARRAYSIZE(sequence), codes, lengths, msbData, sizeof(msbData), true);
+		encode(sequence, ARRAYSIZE(sequence), codes, lengths, lsbData, sizeof(lsbData), false);
+
+		const uint8 tableBits[] = { 1, 4, 8, 11, 16 };
+
+		for (uint32 i = 0; i < ARRAYSIZE(tableBits); i++) {
+			checkDecode<Common::BitStream8MSB>(msbData, sizeof(msbData), tableBits[i], codeCount, codes, lengths, symbols, sequence, ARRAYSIZE(sequence));
+			checkDecode<Common::BitStream16BEMSB>(msbData, sizeof(msbData), tableBits[i], codeCount, codes, lengths, symbols, sequence, ARRAYSIZE(sequence));
+			checkDecode<Common::BitStream32BEMSB>(msbData, sizeof(msbData), tableBits[i], codeCount, codes, lengths, symbols, sequence, ARRAYSIZE(sequence));
+			checkDecode<Common::BitStream8LSB>(lsbData, sizeof(lsbData), tableBits[i], codeCount, codes, lengths, symbols, sequence, ARRAYSIZE(sequence));
+			checkDecode<Common::BitStream16LELSB>(lsbData, sizeof(lsbData), tableBits[i], codeCount, codes, lengths, symbols, sequence, ARRAYSIZE(sequence));
+			checkDecode<Common::BitStream32LELSB>(lsbData, sizeof(lsbData), tableBits[i], codeCount, codes, lengths, symbols, sequence, ARRAYSIZE(sequence));
+		}
+	}
+
+	void test_flat_code() {
+		/*
+		 * 64 codes of 6 bits each. With a 4-bit primary table every
+		 * code ends in a 2-bit sub-table.
+		 */
+
+		const uint32 codeCount = 64;
+		uint8 lengths[codeCount];
+		uint32 codes[codeCount];
+
+		for (uint32 i = 0; i < codeCount; i++)
+			lengths[i] = 6;
+
+		makeCanonicalCodes(lengths, codeCount, codes);
+
+		uint32 sequence[codeCount];
+		for (uint32 i = 0; i < codeCount; i++)
+			sequence[i] = (i * 37) % codeCount;
+
+		byte msbData[64];
+		byte lsbData[64];
+		encode(sequence, codeCount, codes, lengths, msbData, sizeof(msbData), true);
+		encode(sequence, codeCount, codes, lengths, lsbData, sizeof(lsbData), false);
+
+		checkDecode<Common::BitStream8MSB>(msbData, sizeof(msbData), 4, codeCount, codes, lengths, nullptr, sequence, codeCount);
+		checkDecode<Common::BitStream8LSB>(lsbData, sizeof(lsbData), 4, codeCount, codes, lengths, nullptr, sequence, codeCount);
+		checkDecode<Common::BitStream8MSB>(msbData, sizeof(msbData), 8, codeCount, codes, lengths, nullptr, sequence, codeCount);
+		checkDecode<Common::BitStream8LSB>(lsbData, sizeof(lsbData), 8, codeCount, codes, lengths, nullptr, sequence, codeCount);
+	}
+
+private:
+	static void makeCanonicalCodes(const uint8 *lengths, uint32 count, uint32 *codes) {
+		uint32 code = 0;
+
+		for (uint8 length = 1; length <= 32; length++) {
+			for (uint32 i = 0; i < count; i++)
+				if (lengths[i] == length)
+					codes[i] = code++;
+
+			code <<= 1;
+		}
+	}
+
+	static void encode(const uint32 *sequence, uint32 count, const uint32 *codes, const uint8 *lengths, byte *data, uint32 size, bool msb) {
+		memset(data, 0, size);
+
+		uint32 pos = 0;
+		for (uint32 i = 0; i < count; i++) {
+			uint32 index = sequence[i];
+
+			for (int bit = lengths[index] - 1; bit >= 0; bit--, pos++) {
+				if (!((codes[index] >> bit) & 1))
+					continue;
+
+				if (msb)
+					data[pos >> 3] |= 0x80 >> (pos & 7);
+				else
+					data[pos >> 3] |= 1 << (pos & 7);
+			}
+		}
+
+		TS_ASSERT_LESS_THAN_EQUALS(pos, size * 8);
+	}
+
+	template<class BITSTREAM>
+	static void checkDecode(const byte *data, uint32 size, uint8 tableBits, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols, const uint32 *sequence, uint32 count) {
+		Common::Huffman<BITSTREAM> h(0, codeCount, codes, lengths, symbols, tableBits);
+
+		Common::MemoryReadStream ms(data, size);
+		BITSTREAM bs(ms);
+
+		for (uint32 i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), symbols ? symbols[sequence[i]] : sequence[i]);
+	}
 };
@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memtrack.h"
+#include "common/memorypool.h"
+#include "common/str.h"
+
+class MemoryTrackingTestSuite : public CxxTest::TestSuite
+{
+#ifdef ENABLE_MEMORY_TRACKING
+	static Common::MemoryTagStats findTag(const char *name) {
+		for (uint i = 0; i < Common::getMemoryTagCount(); ++i) {
+			const Common::MemoryTagStats stats = Common::getMemoryTagStats(i);
+			if (!strcmp(stats.name, name))
+				return stats;
+		}
+
+		Common::MemoryTagStats none = { name, 0, 0, 0, 0 };
+		return none;
+	}
+#endif
+
+	public:
+	void test_tag_scopes() {
+#ifdef ENABLE_MEMORY_TRACKING
+		int *outer, *inner;
+		{
+			MEMORY_TAG_SCOPE("test/outer");
+			outer = new int[100];
+			{
+				MEMORY_TAG_SCOPE("test/inner");
+				inner = new int[50];
+			}
+		}
+
+		Common::MemoryTagStats stats = findTag("test/outer");
+		TS_ASSERT_EQUALS(stats.liveBytes, 100 * sizeof(int));
+		TS_ASSERT_EQUALS(stats.liveAllocations, 1U);
+		stats = findTag("test/inner");
+		TS_ASSERT_EQUALS(stats.liveBytes, 50 * sizeof(int));
+
+		// Freeing credits the tag of the allocation, not the current one
+		delete[] outer;
+		delete[] inner;
+		stats = findTag("test/outer");
+		TS_ASSERT_EQUALS(stats.liveBytes, 0U);
+		TS_ASSERT_EQUALS(stats.peakBytes, 100 * sizeof(int));
+		TS_ASSERT_EQUALS(stats.liveAllocations, 0U);
+		TS_ASSERT_EQUALS(stats.totalAllocations, 1U);
+		TS_ASSERT_EQUALS(findTag("test/inner").liveBytes, 0U);
+
+		TS_ASSERT(Common::formatMemoryTagStats().contains("test/outer"));
+#endif
+	}
+
+	void test_tag_scopes_in_one_block() {
+#ifdef ENABLE_MEMORY_TRACKING
+		{
+			MEMORY_TAG_SCOPE("test/first");
+			MEMORY_TAG_SCOPE("test/second");
+			int *p = new int[10];
+			TS_ASSERT_EQUALS(findTag("test/second").liveBytes, 10 * sizeof(int));
+			TS_ASSERT_EQUALS(findTag("test/first").liveBytes, 0U);
+			delete[] p;
+		}
+#endif
+	}
+
+	void test_tag_scope_in_loop() {
+#ifdef ENABLE_MEMORY_TRACKING
+		// The tag is looked up on the first run, and reused by the others
+		for (int i = 0; i < 3; ++i) {
+			MEMORY_TAG_SCOPE("test/loop");
+			int *p = new int[10];
+			TS_ASSERT_EQUALS(findTag("test/loop").liveBytes, 10 * sizeof(int));
+			delete[] p;
+		}
+		TS_ASSERT_EQUALS(findTag("test/loop").totalAllocations, 3U);
+		TS_ASSERT_EQUALS(findTag("test/loop").peakBytes, 10 * sizeof(int));
+
+		// A tag built at run time is looked up on each entry
+		for (int i = 0; i < 2; ++i) {
+			char name[16];
+			snprintf(name, sizeof(name), "test/dynamic%d", i);
+			MEMORY_DYNAMIC_TAG_SCOPE(name);
+			int *p = new int[5];
+			TS_ASSERT_EQUALS(findTag(name).liveBytes, 5 * sizeof(int));
+			delete[] p;
+		}
+#endif
+	}
+
+	void test_memory_pool() {
+#ifdef ENABLE_MEMORY_TRACKING
+		{
+			MEMORY_TAG_SCOPE("test/pool");
+			Common::MemoryPool pool(16);
+			void *chunk = pool.allocChunk();
+			TS_ASSERT(findTag("test/pool").liveBytes >= 16U);
+			pool.freeChunk(chunk);
+		}
+		TS_ASSERT_EQUALS(findTag("test/pool").liveBytes, 0U);
+#endif
+	}
+};
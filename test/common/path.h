@@ -66,4 +66,37 @@ class PathTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(p2.getParent().toString('#'), "par#nt/dir/fil#");
 		TS_ASSERT_EQUALS(p2.getParent().getParent().toString('#'), "par#");
 	}
+
+	void test_ignoreCaseAndMac() {
+		Common::Path::IgnoreCaseAndMac_Hash hash;
+		Common::Path::IgnoreCaseAndMac_EqualsTo equals;
+
+		Common::Path p1("Parent/Dir/FILE.txt");
+		Common::Path p2(TEST_PATH);
+		TS_ASSERT(equals(p1, p2));
+		TS_ASSERT_EQUALS(hash(p1), hash(p2));
+
+		// The cached identifier follows changes to the path
+		p2.joinInPlace("other");
+		TS_ASSERT(!equals(p1, p2));
+		p2 = p1;
+		TS_ASSERT(equals(p1, p2));
+		p2.appendInPlace(".bak");
+		TS_ASSERT(!equals(p1, p2));
+		p2.set("PARENT/dir/file.TXT");
+		TS_ASSERT(equals(p1, p2));
+		TS_ASSERT_EQUALS(hash(p1), hash(p2));
+
+		// Slashes in Mac file names match colons, and punycode is decoded
+		Common::StringArray components;
+		components.push_back("Sound Manager 3.1 / SoundLib");
+		components.push_back("Sound");
+		Common::Path mac = Common::Path::joinComponents(components);
+		Common::Path colon("sound manager 3.1 : soundlib/sound");
+		Common::Path punycode("xn--Sound Manager 3.1  SoundLib-lba84k/Sound");
+		TS_ASSERT(equals(mac, colon));
+		TS_ASSERT_EQUALS(hash(mac), hash(colon));
+		TS_ASSERT(equals(mac, punycode));
+		TS_ASSERT_EQUALS(hash(mac), hash(punycode));
+	}
 };
@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/profiler.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "../null_osystem.h"
+
+class ProfilerTestSuite : public CxxTest::TestSuite
+{
+#ifdef ENABLE_PROFILER
+	static Common::String writeTrace() {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		TS_ASSERT(Common::writeProfilingTrace(stream));
+		return Common::String((const char *)stream.getData(), stream.size());
+	}
+#endif
+
+	public:
+	void test_zones() {
+#if defined(ENABLE_PROFILER) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Zones are not recorded until profiling is started
+		{
+			PROFILE_ZONE("test/ignored");
+		}
+
+		Common::startProfiling();
+		TS_ASSERT(Common::isProfiling());
+		Common::setProfilingThreadName("test \"main\"");
+		{
+			PROFILE_ZONE("test/outer");
+			for (int i = 0; i < 3; ++i) {
+				PROFILE_ZONE_ARG("test/inner", "index", i);
+			}
+		}
+		{
+			// Zones in the same block
+			PROFILE_ZONE("test/first");
+			PROFILE_ZONE("test/second");
+		}
+		Common::stopProfiling();
+		TS_ASSERT(!Common::isProfiling());
+
+		{
+			PROFILE_ZONE("test/stopped");
+		}
+		TS_ASSERT_EQUALS(Common::getProfilingZoneCount(), 6U);
+
+		const Common::String trace = writeTrace();
+		TS_ASSERT(trace.hasPrefix("{\"traceEvents\":["));
+		TS_ASSERT(trace.contains("\"name\":\"test/outer\",\"ph\":\"X\""));
+		TS_ASSERT(trace.contains("\"args\":{\"index\":2}"));
+		TS_ASSERT(trace.contains("\"name\":\"test/second\""));
+		TS_ASSERT(trace.contains("\"name\":\"test \\\"main\\\"\""));
+		TS_ASSERT(!trace.contains("test/ignored"));
+		TS_ASSERT(!trace.contains("test/stopped"));
+
+		// Starting again drops the zones recorded before
+		Common::startProfiling();
+		Common::stopProfiling();
+		TS_ASSERT_EQUALS(Common::getProfilingZoneCount(), 0U);
+		TS_ASSERT(!writeTrace().contains("test/outer"));
+
+		// A zone spanning a restart is dropped
+		Common::startProfiling();
+		{
+			PROFILE_ZONE("test/spanning");
+			Common::startProfiling();
+		}
+		{
+			PROFILE_ZONE("test/restarted");
+		}
+		Common::stopProfiling();
+		TS_ASSERT_EQUALS(Common::getProfilingZoneCount(), 1U);
+		TS_ASSERT(writeTrace().contains("test/restarted"));
+#endif
+	}
+};
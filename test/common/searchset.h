@@ -0,0 +1,192 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+class SearchSetTestSuite : public CxxTest::TestSuite
+{
+	// Archive whose streams hold its id, to tell which archive opened a file
+	class TestArchive : public Common::Archive {
+		Common::Array<Common::Path> _paths;
+		byte _id;
+
+	public:
+		bool _listable;
+		bool _listableLater;
+		mutable int _lookups;
+		mutable int _listings;
+		bool _missing;
+
+		TestArchive(byte id, bool listable)
+			: _id(id), _listable(listable), _listableLater(false), _lookups(0), _listings(0), _missing(false) {}
+
+		void addFile(const char *path) { _paths.push_back(Common::Path(path)); }
+
+		bool hasFile(const Common::Path &path) const override {
+			_lookups++;
+			if (_missing)
+				return false;
+			Common::Path::IgnoreCaseAndMac_EqualsTo equals;
+			for (uint i = 0; i < _paths.size(); ++i) {
+				if (equals(_paths[i], path))
+					return true;
+			}
+			return false;
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			return 0;
+		}
+
+		MemberPathListing listMemberPaths(Common::Array<Common::Path> &paths) const override {
+			_listings++;
+			if (!_listable)
+				return _listableLater ? kMemberPathsNotListedYet : kMemberPathsNotListable;
+			paths.push_back(_paths);
+			return kMemberPathsListed;
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+			return Common::ArchiveMemberPtr();
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+			if (!hasFile(path))
+				return nullptr;
+			return new Common::MemoryReadStream(&_id, 1);
+		}
+	};
+
+	static int openedBy(const Common::SearchSet &searchSet, const char *path) {
+		Common::SeekableReadStream *stream = searchSet.createReadStreamForMember(Common::Path(path));
+		if (!stream)
+			return -1;
+		int id = stream->readByte();
+		delete stream;
+		return id;
+	}
+
+	public:
+	void test_priorities() {
+		Common::SearchSet searchSet;
+		TestArchive *low = new TestArchive(1, true);
+		low->addFile("common.dat");
+		low->addFile("low.dat");
+		TestArchive *high = new TestArchive(2, true);
+		high->addFile("COMMON.DAT");
+		high->addFile("high.dat");
+		searchSet.add("low", low, 0);
+		searchSet.add("high", high, 10);
+
+		TS_ASSERT_EQUALS(openedBy(searchSet, "common.dat"), 2);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "low.dat"), 1);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "high.dat"), 2);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "none.dat"), -1);
+
+		// Only the archive holding the file is asked
+		low->_lookups = high->_lookups = 0;
+		TS_ASSERT(searchSet.hasFile("low.dat"));
+		TS_ASSERT(!searchSet.hasFile("none.dat"));
+		TS_ASSERT_EQUALS(low->_lookups, 1);
+		TS_ASSERT_EQUALS(high->_lookups, 0);
+
+		// Archives of the same priority are searched in insertion order
+		TestArchive *later = new TestArchive(3, true);
+		later->addFile("low.dat");
+		searchSet.add("later", later, 0);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "low.dat"), 1);
+
+		// Removing an archive reveals the next one holding its files
+		searchSet.remove("high");
+		TS_ASSERT_EQUALS(openedBy(searchSet, "common.dat"), 1);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "high.dat"), -1);
+		searchSet.remove("low");
+		TS_ASSERT_EQUALS(openedBy(searchSet, "low.dat"), 3);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "common.dat"), -1);
+	}
+
+	void test_set_priority() {
+		Common::SearchSet searchSet;
+		TestArchive *first = new TestArchive(1, true);
+		first->addFile("file.dat");
+		TestArchive *second = new TestArchive(2, true);
+		second->addFile("file.dat");
+		searchSet.add("first", first, 5);
+		searchSet.add("second", second, 0);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 1);
+
+		searchSet.setPriority("second", 10);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 2);
+		searchSet.setPriority("second", 5);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 1);
+	}
+
+	void test_unlistable_archives() {
+		Common::SearchSet searchSet;
+		TestArchive *listable = new TestArchive(1, true);
+		listable->addFile("file.dat");
+		TestArchive *unlistable = new TestArchive(2, false);
+		unlistable->addFile("file.dat");
+		unlistable->addFile("other.dat");
+		TestArchive *fallback = new TestArchive(3, true);
+		fallback->addFile("file.dat");
+		searchSet.add("listable", listable, 0);
+		searchSet.add("unlistable", unlistable, 10);
+		searchSet.add("fallback", fallback, -10);
+
+		// Archives which cannot list their files are still searched in order
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 2);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "other.dat"), 2);
+		searchSet.setPriority("unlistable", -5);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 1);
+
+		// Files missing from the archive listing them are searched further
+		listable->_missing = true;
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 2);
+		TS_ASSERT(searchSet.hasFile("file.dat"));
+		searchSet.remove("unlistable");
+		TS_ASSERT_EQUALS(openedBy(searchSet, "file.dat"), 3);
+	}
+
+	void test_archives_listable_later() {
+		Common::SearchSet searchSet;
+		TestArchive *first = new TestArchive(1, true);
+		first->addFile("first.dat");
+		TestArchive *later = new TestArchive(2, false);
+		later->_listableLater = true;
+		later->addFile("later.dat");
+		searchSet.add("first", first, 0);
+		searchSet.add("later", later, 10);
+
+		TS_ASSERT(searchSet.hasFile("first.dat"));
+		TS_ASSERT_EQUALS(later->_lookups, 1);
+		TS_ASSERT(searchSet.hasFile("first.dat"));
+		TS_ASSERT_EQUALS(later->_listings, 2);
+
+		// Once the archive can list its files, it is indexed
+		later->_listable = true;
+		later->_lookups = 0;
+		TS_ASSERT(searchSet.hasFile("first.dat"));
+		TS_ASSERT_EQUALS(later->_lookups, 0);
+		TS_ASSERT_EQUALS(openedBy(searchSet, "later.dat"), 2);
+		TS_ASSERT_EQUALS(later->_listings, 3);
+		TS_ASSERT_EQUALS(first->_listings, 1);
+	}
+
+	void test_archives_never_listable() {
+		Common::SearchSet searchSet;
+		TestArchive *first = new TestArchive(1, true);
+		first->addFile("first.dat");
+		TestArchive *never = new TestArchive(2, false);
+		never->addFile("never.dat");
+		searchSet.add("first", first, 0);
+		searchSet.add("never", never, 10);
+
+		// The archive is asked about every file, but for its paths only once
+		TS_ASSERT(searchSet.hasFile("first.dat"));
+		TS_ASSERT(searchSet.hasFile("first.dat"));
+		TS_ASSERT_EQUALS(openedBy(searchSet, "never.dat"), 2);
+		TS_ASSERT_EQUALS(never->_lookups, 3);
+		TS_ASSERT_EQUALS(never->_listings, 1);
+	}
+};
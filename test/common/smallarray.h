@@ -0,0 +1,164 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/smallarray.h"
+#include "common/str.h"
+
+class SmallArrayTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_inline_storage() {
+		Common::SmallArray<int, 4> array;
+		TS_ASSERT(array.empty());
+		TS_ASSERT(array.isInline());
+		TS_ASSERT_EQUALS(array.capacity(), 4U);
+
+		for (int i = 0; i < 4; ++i)
+			array.push_back(i * 10);
+		TS_ASSERT(array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 4U);
+
+		// The fifth element moves everything to the heap
+		array.push_back(40);
+		TS_ASSERT(!array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 5U);
+		for (int i = 0; i < 5; ++i)
+			TS_ASSERT_EQUALS(array[i], i * 10);
+
+		array.clear();
+		TS_ASSERT(array.empty());
+		TS_ASSERT(array.isInline());
+
+		Common::SmallArray<int, 4> reserved;
+		reserved.reserve(3);
+		TS_ASSERT(reserved.isInline());
+		reserved.reserve(100);
+		TS_ASSERT(!reserved.isInline());
+		TS_ASSERT(reserved.capacity() >= 100U);
+	}
+
+	void test_insert_erase() {
+		Common::SmallArray<int, 4> array;
+		array.push_back(17);
+		array.push_back(33);
+		array.insert_at(0, -11);
+		array.insert(array.begin() + 2, 25);
+		TS_ASSERT_EQUALS(array.size(), 4U);
+		TS_ASSERT_EQUALS(array[0], -11);
+		TS_ASSERT_EQUALS(array[1], 17);
+		TS_ASSERT_EQUALS(array[2], 25);
+		TS_ASSERT_EQUALS(array[3], 33);
+
+		// Insertions which need to grow the storage
+		array.insert_at(1, 42);
+		array.insert_at(5, 96);
+		TS_ASSERT(!array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 6U);
+		TS_ASSERT_EQUALS(array[1], 42);
+		TS_ASSERT_EQUALS(array[5], 96);
+
+		TS_ASSERT_EQUALS(array.remove_at(1), 42);
+		TS_ASSERT_EQUALS(*array.erase(array.begin()), 17);
+		array.erase(array.begin() + 1, array.begin() + 3);
+		TS_ASSERT_EQUALS(array.size(), 2U);
+		TS_ASSERT_EQUALS(array.front(), 17);
+		TS_ASSERT_EQUALS(array.back(), 96);
+		array.pop_back();
+		TS_ASSERT_EQUALS(array.size(), 1U);
+
+		// Appending an element of the array itself while it grows
+		Common::SmallArray<Common::String, 2> stringArray;
+		stringArray.push_back("foo");
+		stringArray.push_back("bar");
+		stringArray.push_back(stringArray[0]);
+		TS_ASSERT_EQUALS(stringArray.size(), 3U);
+		TS_ASSERT_EQUALS(stringArray[0], "foo");
+		TS_ASSERT_EQUALS(stringArray[2], "foo");
+	}
+
+	void test_resize() {
+		Common::SmallArray<Common::String, 3> array(2, "abc");
+		TS_ASSERT_EQUALS(array.size(), 2U);
+		TS_ASSERT_EQUALS(array[1], "abc");
+
+		array.resize(5, "def");
+		TS_ASSERT(!array.isInline());
+		TS_ASSERT_EQUALS(array[1], "abc");
+		TS_ASSERT_EQUALS(array[4], "def");
+
+		array.resize(1);
+		TS_ASSERT_EQUALS(array.size(), 1U);
+		TS_ASSERT_EQUALS(array[0], "abc");
+
+		Common::SmallArray<int, 8> zeroes(6);
+		for (uint i = 0; i < zeroes.size(); ++i)
+			TS_ASSERT_EQUALS(zeroes[i], 0);
+	}
+
+	void test_copy_move() {
+		Common::SmallArray<Common::String, 2> inlineArray;
+		inlineArray.push_back("one");
+		inlineArray.push_back("two");
+
+		Common::SmallArray<Common::String, 2> heapArray(inlineArray);
+		heapArray.push_back("three");
+		TS_ASSERT(!heapArray.isInline());
+
+		Common::SmallArray<Common::String, 2> copy;
+		copy = heapArray;
+		TS_ASSERT(copy == heapArray);
+		copy = inlineArray;
+		TS_ASSERT(copy == inlineArray);
+		TS_ASSERT(copy != heapArray);
+
+		Common::SmallArray<Common::String, 2> moved(Common::move(inlineArray));
+		TS_ASSERT(moved.isInline());
+		TS_ASSERT_EQUALS(moved.size(), 2U);
+		TS_ASSERT_EQUALS(moved[1], "two");
+		TS_ASSERT(inlineArray.empty());
+
+		const Common::String *heapData = heapArray.data();
+		moved = Common::move(heapArray);
+		TS_ASSERT_EQUALS(moved.data(), heapData);
+		TS_ASSERT_EQUALS(moved.size(), 3U);
+		TS_ASSERT_EQUALS(moved[2], "three");
+		TS_ASSERT(heapArray.empty());
+		TS_ASSERT(heapArray.isInline());
+	}
+
+	void test_array_interop() {
+		Common::Array<int> array;
+		array.push_back(3);
+		array.push_back(1);
+		array.push_back(2);
+
+		Common::SmallArray<int, 4> small(array);
+		TS_ASSERT(small == array);
+		small.push_back(array);
+		TS_ASSERT_EQUALS(small.size(), 6U);
+		TS_ASSERT(small != array);
+		small.insert_at(0, array);
+		TS_ASSERT_EQUALS(small.size(), 9U);
+
+		small = array;
+		TS_ASSERT(small == array);
+
+		// Iterators are plain pointers, so the common algorithms apply
+		Common::sort(small.begin(), small.end());
+		TS_ASSERT_EQUALS(small[0], 1);
+		TS_ASSERT_EQUALS(small[2], 3);
+		TS_ASSERT_EQUALS(Common::find(small.begin(), small.end(), 2), small.begin() + 1);
+
+		Common::Array<int> back = small.toArray();
+		TS_ASSERT_EQUALS(back.size(), 3U);
+		TS_ASSERT_EQUALS(back[0], 1);
+
+		static const int values[] = { 5, 6, 7 };
+		Common::SmallArray<int, 2> fromPointer(values, 3);
+		TS_ASSERT_EQUALS(fromPointer.size(), 3U);
+		TS_ASSERT_EQUALS(fromPointer[2], 7);
+
+		Common::SmallArray<int, 4> fromList = { 1, 7, 42 };
+		TS_ASSERT_EQUALS(fromList.size(), 3U);
+		TS_ASSERT_EQUALS(fromList[2], 42);
+	}
+};
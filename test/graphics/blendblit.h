@@ -0,0 +1,463 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/alpha_runs.h"
+#include "graphics/blit.h"
+#include "graphics/managed_surface.h"
+#include "graphics/transparent_surface.h"
+
+/**
+ * Compares the single pass blending against a straightforward per pixel
+ * version of what TransparentSurface used to do: scale the sprite with
+ * scaleBlit() first, then flip and blend it.
+ */
+class BlendBlitTestSuite : public CxxTest::TestSuite {
+	static void fillRandom(Graphics::Surface &surface, uint32 seed, bool binaryAlpha = false) {
+		for (int y = 0; y < surface.h; ++y) {
+			for (int x = 0; x < surface.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				byte a = seed >> 24;
+				// Plenty of fully transparent and opaque pixels
+				if ((seed & 0x300) == 0)
+					a = 0;
+				else if ((seed & 0x300) == 0x100 || binaryAlpha)
+					a = 255;
+				surface.setPixel(x, y, surface.format.ARGBToColor(a, seed >> 16, seed >> 8, seed >> 4));
+			}
+		}
+	}
+
+	static uint32 blendPixel(const Graphics::PixelFormat &format, uint32 src, uint32 dst, uint32 color,
+			Graphics::TSpriteBlendMode mode, Graphics::AlphaType alphaType) {
+		byte ia, ir, ig, ib, oa, or_, og, ob;
+		format.colorToARGB(src, ia, ir, ig, ib);
+		format.colorToARGB(dst, oa, or_, og, ob);
+
+		if (color == 0xFFFFFFFF && mode == Graphics::BLEND_NORMAL && alphaType == Graphics::ALPHA_OPAQUE)
+			return format.ARGBToColor(255, ir, ig, ib);
+		if (color == 0xFFFFFFFF && mode == Graphics::BLEND_NORMAL && alphaType == Graphics::ALPHA_BINARY)
+			return ia ? format.ARGBToColor(255, ir, ig, ib) : dst;
+
+		const int ca = color & 0xFF, cr = color >> 24, cg = (color >> 16) & 0xFF, cb = (color >> 8) & 0xFF;
+		const int in[3] = { ir, ig, ib }, mod[3] = { cr, cg, cb };
+		int out[3] = { or_, og, ob };
+		const int ina = ia * ca >> 8;
+
+		for (int i = 0; i < 3; ++i) {
+			switch (mode) {
+			case Graphics::BLEND_ADDITIVE:
+				if (ina)
+					out[i] = MIN(out[i] + (mod[i] != 255 ? (in[i] * mod[i] * ina) >> 16 : in[i] * ina >> 8), 255);
+				break;
+			case Graphics::BLEND_SUBTRACTIVE:
+				oa = 255;
+				out[i] = MAX(out[i] - (mod[i] != 255 ? (in[i] * mod[i] * out[i] * ia) >> 24 : in[i] * out[i] * ia >> 16), 0);
+				break;
+			case Graphics::BLEND_MULTIPLY:
+				if (ina)
+					out[i] = MIN(out[i] * (mod[i] != 255 ? (in[i] * mod[i] * ina) >> 16 : in[i] * ina >> 8) >> 8, 255);
+				break;
+			default:
+				if (ina) {
+					oa = 255;
+					out[i] = (out[i] * (255 - ina) >> 8) + (in[i] * ina * mod[i] >> 16);
+				}
+				break;
+			}
+		}
+
+		return format.ARGBToColor(oa, out[0], out[1], out[2]);
+	}
+
+	/** The reference for TransparentSurface::blit() without a part rect. */
+	static void referenceBlit(const Graphics::Surface &src, Graphics::Surface &dst, int posX, int posY,
+			int flipping, uint32 color, int width, int height, Graphics::TSpriteBlendMode mode,
+			Graphics::AlphaType alphaType) {
+		if ((color & 0xFF) == 0)
+			return;
+
+		Graphics::Surface *scaled = src.scale(width, height);
+		for (int y = MAX(posY, 0); y < MIN(posY + height, (int)dst.h); ++y) {
+			for (int x = MAX(posX, 0); x < MIN(posX + width, (int)dst.w); ++x) {
+				int sx = x - posX, sy = y - posY;
+				if (flipping & Graphics::FLIP_H)
+					sx = width - 1 - sx;
+				if (flipping & Graphics::FLIP_V)
+					sy = height - 1 - sy;
+				dst.setPixel(x, y, blendPixel(dst.format, scaled->getPixel(sx, sy), dst.getPixel(x, y), color, mode, alphaType));
+			}
+		}
+		scaled->free();
+		delete scaled;
+	}
+
+	static bool compare(const Graphics::Surface &a, const Graphics::Surface &b) {
+		for (int y = 0; y < a.h; ++y) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * a.format.bytesPerPixel))
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_transparent_surface() {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFFFFFF80, 0x80C0FFFF, 0x4080C0A0 };
+		static const int sizes[][2] = { { -1, -1 }, { 45, 21 }, { 11, 7 }, { 67, 3 } };
+		static const int positions[][2] = { { 5, 3 }, { -6, -4 }, { 30, 20 } };
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(23, 13, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite, 1);
+
+		Graphics::Surface background, expected, actual;
+		background.create(48, 32, sprite.format);
+		fillRandom(background, 2);
+
+		for (int alphaType = Graphics::ALPHA_OPAQUE; alphaType <= Graphics::ALPHA_FULL; ++alphaType) {
+			sprite.setAlphaMode((Graphics::AlphaType)alphaType);
+			for (int mode = Graphics::BLEND_NORMAL; mode < Graphics::NUM_BLEND_MODES; ++mode) {
+				for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+					for (uint s = 0; s < ARRAYSIZE(sizes); ++s) {
+						for (uint p = 0; p < ARRAYSIZE(positions); ++p) {
+							for (int flip = 0; flip <= Graphics::FLIP_HV; ++flip) {
+								const int width = sizes[s][0] == -1 ? sprite.w : sizes[s][0];
+								const int height = sizes[s][1] == -1 ? sprite.h : sizes[s][1];
+
+								expected.copyFrom(background);
+								referenceBlit(sprite, expected, positions[p][0], positions[p][1], flip, colors[c],
+								              width, height, (Graphics::TSpriteBlendMode)mode, (Graphics::AlphaType)alphaType);
+
+								actual.copyFrom(background);
+								sprite.blit(actual, positions[p][0], positions[p][1], flip, nullptr, colors[c],
+								            sizes[s][0], sizes[s][1], (Graphics::TSpriteBlendMode)mode);
+
+								TSM_ASSERT(Common::String::format("alpha %d, mode %d, color %08x, size %dx%d, pos %d,%d, flip %d",
+								           alphaType, mode, colors[c], width, height, positions[p][0], positions[p][1], flip).c_str(),
+								           compare(expected, actual));
+							}
+						}
+					}
+				}
+			}
+		}
+
+		actual.free();
+		expected.free();
+		background.free();
+		sprite.free();
+	}
+
+	void test_part_rect() {
+		Graphics::TransparentSurface sprite;
+		sprite.create(16, 16, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite, 3);
+
+		Graphics::Surface dst;
+		dst.create(8, 8, sprite.format);
+		dst.fillRect(Common::Rect(8, 8), 0);
+
+		// The part rect refers to the unflipped image
+		Common::Rect part(2, 3, 10, 11);
+		sprite.setAlphaMode(Graphics::ALPHA_OPAQUE);
+		Common::Rect size = sprite.blit(dst, 0, 0, Graphics::FLIP_H, &part);
+		TS_ASSERT_EQUALS(size.width(), 8);
+		TS_ASSERT_EQUALS(size.height(), 8);
+
+		for (int y = 0; y < 8; ++y) {
+			for (int x = 0; x < 8; ++x) {
+				byte a, r, g, b, ea, er, eg, eb;
+				sprite.format.colorToARGB(sprite.getPixel(16 - 10 + 7 - x, 3 + y), ea, er, eg, eb);
+				dst.format.colorToARGB(dst.getPixel(x, y), a, r, g, b);
+				TS_ASSERT(a == 255 && r == er && g == eg && b == eb);
+			}
+		}
+
+		dst.free();
+		sprite.free();
+	}
+
+	void test_managed_surface() {
+		// A layout which TransparentSurface doesn't use
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		Graphics::Surface sprite;
+		sprite.create(37, 9, format);
+		fillRandom(sprite, 4);
+
+		Graphics::ManagedSurface screen(40, 20, format);
+		fillRandom(*screen.surfacePtr(), 5);
+
+		Graphics::Surface expected;
+		expected.copyFrom(*screen.surfacePtr());
+		referenceBlit(sprite, expected, -3, 2, Graphics::FLIP_V, 0xC0C0C0C0, 74, 18,
+		              Graphics::BLEND_NORMAL, Graphics::ALPHA_FULL);
+
+		TS_ASSERT(screen.blendBlitFrom(sprite, Common::Rect(sprite.w, sprite.h), Common::Rect(-3, 2, 71, 20),
+		                               Graphics::FLIP_V, 0xC0C0C0C0));
+		TS_ASSERT(compare(expected, *screen.surfacePtr()));
+
+		// Only 32 bit formats with 8 bit channels are supported
+		Graphics::ManagedSurface screen16(8, 8, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		Graphics::Surface sprite16;
+		sprite16.create(4, 4, screen16.format);
+		TS_ASSERT(!screen16.blendBlitFrom(sprite16, Common::Rect(4, 4), Common::Rect(4, 4)));
+
+		sprite16.free();
+		expected.free();
+		sprite.free();
+	}
+
+	void test_bilinear() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+		// A uniform image stays uniform at any size
+		Graphics::Surface sprite, dst;
+		sprite.create(5, 3, format);
+		sprite.fillRect(Common::Rect(5, 3), format.ARGBToColor(255, 200, 100, 50));
+		dst.create(17, 11, format);
+
+		TS_ASSERT(Graphics::blendBlit((byte *)dst.getPixels(), (const byte *)sprite.getPixels(), dst.pitch, sprite.pitch,
+		                              sprite.w, sprite.h, dst.w, dst.h, 0, 0, dst.w, dst.h, format,
+		                              0xFFFFFFFF, Graphics::FLIP_NONE, Graphics::BLEND_NORMAL, Graphics::ALPHA_OPAQUE, true));
+		for (int y = 0; y < dst.h; ++y)
+			for (int x = 0; x < dst.w; ++x)
+				TS_ASSERT_EQUALS(dst.getPixel(x, y), format.ARGBToColor(255, 200, 100, 50));
+
+		// A horizontal ramp is interpolated between its ends
+		sprite.setPixel(0, 1, format.ARGBToColor(255, 0, 0, 0));
+		sprite.setPixel(1, 1, format.ARGBToColor(255, 0, 0, 0));
+		sprite.setPixel(2, 1, format.ARGBToColor(255, 100, 100, 100));
+		sprite.setPixel(3, 1, format.ARGBToColor(255, 200, 200, 200));
+		sprite.setPixel(4, 1, format.ARGBToColor(255, 200, 200, 200));
+		dst.free();
+		dst.create(20, 1, format);
+		TS_ASSERT(Graphics::blendBlit((byte *)dst.getPixels(), (const byte *)sprite.getBasePtr(0, 1), dst.pitch, sprite.pitch,
+		                              sprite.w, 1, dst.w, 1, 0, 0, dst.w, 1, format,
+		                              0xFFFFFFFF, Graphics::FLIP_NONE, Graphics::BLEND_NORMAL, Graphics::ALPHA_OPAQUE, true));
+		byte previous = 0;
+		for (int x = 0; x < dst.w; ++x) {
+			byte a, r, g, b;
+			format.colorToARGB(dst.getPixel(x, 0), a, r, g, b);
+			TS_ASSERT_LESS_THAN_EQUALS(previous, r);
+			previous = r;
+		}
+
+		dst.free();
+		sprite.free();
+	}
+
+	void test_alpha_runs() {
+		Graphics::TransparentSurface sprite;
+		sprite.create(6, 2, Graphics::TransparentSurface::getSupportedPixelFormat());
+		const byte alphas[] = { 0, 0, 255, 255, 128, 0, 255, 255, 255, 255, 255, 255 };
+		for (int i = 0; i < 12; ++i)
+			sprite.setPixel(i % 6, i / 6, sprite.format.ARGBToColor(alphas[i], i, i, i));
+
+		sprite.buildAlphaRuns();
+		TS_ASSERT(sprite.hasAlphaRuns());
+
+		Graphics::AlphaRuns runs;
+		TS_ASSERT(runs.build(sprite));
+		TS_ASSERT_EQUALS(runs.getRunCount(0), 4u);
+		TS_ASSERT_EQUALS(Graphics::AlphaRuns::getType(runs.getRuns(0)[2]), Graphics::AlphaRuns::kRunBlended);
+		TS_ASSERT_EQUALS(Graphics::AlphaRuns::getLength(runs.getRuns(0)[1]), 2u);
+		TS_ASSERT_EQUALS(runs.getRunCount(1), 1u);
+		TS_ASSERT_EQUALS(runs.countPixels(Graphics::AlphaRuns::kRunOpaque), 8u);
+		TS_ASSERT_EQUALS(runs.countPixels(Graphics::AlphaRuns::kRunTransparent), 3u);
+
+		sprite.setAlpha(255);
+		TS_ASSERT(!sprite.hasAlphaRuns());
+
+		// Runs of freed pixels are not used, even if the new pixels happen
+		// to be at the same address
+		sprite.buildAlphaRuns();
+		sprite.free();
+		TS_ASSERT(!sprite.hasAlphaRuns());
+		sprite.create(6, 2, Graphics::TransparentSurface::getSupportedPixelFormat());
+		TS_ASSERT(!sprite.hasAlphaRuns());
+
+		// Also when the pixels are replaced through a plain Surface
+		sprite.buildAlphaRuns();
+		Graphics::Surface &plain = sprite;
+		plain.free();
+		plain.create(6, 2, Graphics::TransparentSurface::getSupportedPixelFormat());
+		TS_ASSERT(!sprite.hasAlphaRuns());
+		sprite.buildAlphaRuns();
+		void *pixels = plain.getPixels();
+		plain.setPixels(pixels);
+		TS_ASSERT(!sprite.hasAlphaRuns());
+		sprite.free();
+	}
+
+	void test_compressed_blit() {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0x80C0FFFF };
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(41, 19, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite, 10);
+		sprite.fillRect(Common::Rect(3, 2, 30, 9), sprite.format.ARGBToColor(255, 10, 20, 30));
+		sprite.fillRect(Common::Rect(0, 10, 41, 19), 0);
+		// Compression doesn't keep the colors of transparent pixels
+		for (int y = 0; y < sprite.h; ++y) {
+			for (int x = 0; x < sprite.w; ++x) {
+				byte a, r, g, b;
+				sprite.format.colorToARGB(sprite.getPixel(x, y), a, r, g, b);
+				if (!a)
+					sprite.setPixel(x, y, 0);
+			}
+		}
+		sprite.buildAlphaRuns();
+
+		Graphics::TransparentSurface compressed;
+		compressed.copyFrom(sprite);
+		TS_ASSERT(compressed.compress());
+		TS_ASSERT(compressed.isCompressed());
+		TS_ASSERT(!compressed.getPixels());
+		TS_ASSERT_EQUALS(compressed.w, sprite.w);
+		TS_ASSERT_EQUALS(compressed.h, sprite.h);
+
+		Graphics::Surface background, expected, actual;
+		background.create(48, 32, sprite.format);
+		fillRandom(background, 11);
+
+		Common::Rect part(5, 1, 37, 18);
+		for (int mode = Graphics::BLEND_NORMAL; mode < Graphics::NUM_BLEND_MODES; ++mode) {
+			for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+				for (int alphaMode = Graphics::ALPHA_OPAQUE; alphaMode <= Graphics::ALPHA_FULL; ++alphaMode) {
+					for (int flip = 0; flip <= Graphics::FLIP_HV; ++flip) {
+						for (int usePart = 0; usePart < 2; ++usePart) {
+							sprite.setAlphaMode((Graphics::AlphaType)alphaMode);
+							compressed.setAlphaMode((Graphics::AlphaType)alphaMode);
+
+							expected.copyFrom(background);
+							sprite.blit(expected, -4, 20, flip, usePart ? &part : nullptr, colors[c], -1, -1, (Graphics::TSpriteBlendMode)mode);
+
+							actual.copyFrom(background);
+							compressed.blit(actual, -4, 20, flip, usePart ? &part : nullptr, colors[c], -1, -1, (Graphics::TSpriteBlendMode)mode);
+
+							TSM_ASSERT(Common::String::format("mode %d, color %08x, alpha %d, flip %d, part %d", mode, colors[c], alphaMode, flip, usePart).c_str(),
+							           compare(expected, actual));
+						}
+					}
+				}
+			}
+		}
+		TS_ASSERT(compressed.isCompressed());
+
+		// Scaled blits need the pixel buffer again
+		expected.copyFrom(background);
+		sprite.blit(expected, 0, 0, Graphics::FLIP_NONE, nullptr, 0xFFFFFFFF, 30, 30);
+		actual.copyFrom(background);
+		compressed.blit(actual, 0, 0, Graphics::FLIP_NONE, nullptr, 0xFFFFFFFF, 30, 30);
+		TS_ASSERT(compare(expected, actual));
+		TS_ASSERT(!compressed.isCompressed());
+		TS_ASSERT(compare(sprite, compressed));
+
+		actual.free();
+		expected.free();
+		background.free();
+		compressed.free();
+		sprite.free();
+	}
+
+	void test_alpha_runs_blit() {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFFFFFF80, 0x80C0FFFF };
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(41, 19, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fillRandom(sprite, 6);
+		// Long runs as well as single pixels
+		sprite.fillRect(Common::Rect(3, 2, 30, 9), sprite.format.ARGBToColor(255, 10, 20, 30));
+		sprite.fillRect(Common::Rect(8, 10, 40, 15), 0);
+
+		Graphics::TransparentSurface withRuns(sprite, false);
+		withRuns.buildAlphaRuns();
+
+		Graphics::TransparentSurface opaqueOnly;
+		opaqueOnly.copyFrom(sprite);
+		for (int y = 0; y < opaqueOnly.h; ++y) {
+			for (int x = 0; x < opaqueOnly.w; ++x) {
+				byte a, r, g, b;
+				opaqueOnly.format.colorToARGB(opaqueOnly.getPixel(x, y), a, r, g, b);
+				if (a != 255)
+					opaqueOnly.setPixel(x, y, 0);
+			}
+		}
+		opaqueOnly.setAlphaMode(Graphics::ALPHA_BINARY);
+
+		Graphics::Surface background, expected, actual;
+		background.create(48, 32, sprite.format);
+		fillRandom(background, 7);
+
+		Common::Rect part(5, 1, 37, 18);
+		for (int mode = Graphics::BLEND_NORMAL; mode < Graphics::NUM_BLEND_MODES; ++mode) {
+			for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+				for (int flip = 0; flip <= Graphics::FLIP_HV; ++flip) {
+					for (int usePart = 0; usePart < 2; ++usePart) {
+						expected.copyFrom(background);
+						sprite.blit(expected, -4, 20, flip, usePart ? &part : nullptr, colors[c], -1, -1, (Graphics::TSpriteBlendMode)mode);
+
+						actual.copyFrom(background);
+						withRuns.blit(actual, -4, 20, flip, usePart ? &part : nullptr, colors[c], -1, -1, (Graphics::TSpriteBlendMode)mode);
+
+						if (colors[c] == 0xFFFFFFFF && mode == Graphics::BLEND_NORMAL) {
+							// Opaque pixels are copied exactly instead of being blended
+							// with a coverage of 254.
+							opaqueOnly.blit(expected, -4, 20, flip, usePart ? &part : nullptr);
+						}
+
+						TSM_ASSERT(Common::String::format("mode %d, color %08x, flip %d, part %d", mode, colors[c], flip, usePart).c_str(),
+						           compare(expected, actual));
+					}
+				}
+			}
+		}
+
+		actual.free();
+		expected.free();
+		background.free();
+		opaqueOnly.free();
+		sprite.free();
+	}
+
+	void test_premultiplied() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+		Graphics::TransparentSurface sprite, premultiplied;
+		sprite.create(9, 5, format);
+		fillRandom(sprite, 8);
+		premultiplied.copyFrom(sprite);
+		premultiplied.premultiplyAlpha();
+		TS_ASSERT(premultiplied.isPremultiplied());
+
+		Graphics::Surface background, expected, actual;
+		background.create(9, 5, format);
+		fillRandom(background, 9);
+
+		for (int mode = Graphics::BLEND_NORMAL; mode < Graphics::NUM_BLEND_MODES; ++mode) {
+			expected.copyFrom(background);
+			sprite.blit(expected, 0, 0, Graphics::FLIP_NONE, nullptr, 0x80FFC0C0, -1, -1, (Graphics::TSpriteBlendMode)mode);
+
+			actual.copyFrom(background);
+			premultiplied.blit(actual, 0, 0, Graphics::FLIP_NONE, nullptr, 0x80FFC0C0, -1, -1, (Graphics::TSpriteBlendMode)mode);
+
+			// Both only differ by rounding
+			for (int y = 0; y < expected.h; ++y) {
+				for (int x = 0; x < expected.w; ++x) {
+					byte ea, er, eg, eb, a, r, g, b;
+					format.colorToARGB(expected.getPixel(x, y), ea, er, eg, eb);
+					format.colorToARGB(actual.getPixel(x, y), a, r, g, b);
+					TS_ASSERT_EQUALS(a, ea);
+					TS_ASSERT_LESS_THAN_EQUALS(ABS(r - er), 3);
+					TS_ASSERT_LESS_THAN_EQUALS(ABS(g - eg), 3);
+					TS_ASSERT_LESS_THAN_EQUALS(ABS(b - eb), 3);
+				}
+			}
+		}
+
+		actual.free();
+		expected.free();
+		background.free();
+		premultiplied.free();
+		sprite.free();
+	}
+};
@@ -0,0 +1,257 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/math.h"
+
+#include "graphics/blit.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+#include "graphics/transform_struct.h"
+#include "graphics/transform_tools.h"
+
+class BlitTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 13,
+		kHeight = 5
+	};
+
+	static void createMap(uint32 *map) {
+		for (uint i = 0; i < 256; ++i)
+			map[i] = (i * 0x01020304u) ^ 0xA5A5A5A5u;
+	}
+
+	template<typename Color>
+	static void checkMapped(const byte *indices, uint indexPitch, const byte *dst, uint dstPitch, const uint32 *map) {
+		for (uint y = 0; y < kHeight; ++y) {
+			const Color *row = (const Color *)(dst + y * dstPitch);
+			for (uint x = 0; x < kWidth; ++x)
+				TS_ASSERT_EQUALS(row[x], (Color)map[indices[y * indexPitch + x]]);
+		}
+	}
+
+	static void fillRandom(Graphics::Surface &surface, uint32 seed) {
+		for (int y = 0; y < surface.h; ++y) {
+			for (int x = 0; x < surface.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				surface.setPixel(x, y, surface.format.ARGBToColor(seed >> 24, seed >> 16, seed >> 8, seed >> 4));
+			}
+		}
+	}
+
+	static byte interpolate(byte c01, byte c00, byte c11, byte c10, int ex, int ey) {
+		int t1 = ((((c01 - c00) * ex) >> 16) + c00) & 0xff;
+		int t2 = ((((c11 - c10) * ex) >> 16) + c10) & 0xff;
+		return (((t2 - t1) * ey) >> 16) + t1;
+	}
+
+	template<typename ColorMask>
+	static uint32 interpolate(const Graphics::PixelFormat &fmt, uint32 c01, uint32 c00, uint32 c11, uint32 c10, int ex, int ey) {
+		byte c[4][4];
+		fmt.colorToARGBT<ColorMask>(c01, c[0][0], c[0][1], c[0][2], c[0][3]);
+		fmt.colorToARGBT<ColorMask>(c00, c[1][0], c[1][1], c[1][2], c[1][3]);
+		fmt.colorToARGBT<ColorMask>(c11, c[2][0], c[2][1], c[2][2], c[2][3]);
+		fmt.colorToARGBT<ColorMask>(c10, c[3][0], c[3][1], c[3][2], c[3][3]);
+
+		byte result[4];
+		for (int i = 0; i < 4; ++i)
+			result[i] = interpolate(c[0][i], c[1][i], c[2][i], c[3][i], ex, ey);
+		return fmt.ARGBToColorT<ColorMask>(result[0], result[1], result[2], result[3]);
+	}
+
+	/**
+	 * The rotoscaling as it was done before the sampled spans were computed
+	 * up front: every destination pixel is checked against the source bounds.
+	 */
+	template<typename ColorMask>
+	static void referenceRotoscale(Graphics::Surface &dst, const Graphics::Surface &src,
+	                               const Graphics::TransformStruct &transform,
+	                               const Common::Point &newHotspot, bool filtering) {
+		const bool flipx = transform._flip & Graphics::FLIP_H;
+		const bool flipy = transform._flip & Graphics::FLIP_V;
+
+		uint32 invAngle = 360 - (transform._angle % 360);
+		float invAngleRad = Common::deg2rad<uint32,float>(invAngle);
+		float invCos = cos(invAngleRad);
+		float invSin = sin(invAngleRad);
+
+		int icosx = (int)(invCos * (65536.0f * Graphics::kDefaultZoomX / transform._zoom.x));
+		int isinx = (int)(invSin * (65536.0f * Graphics::kDefaultZoomX / transform._zoom.x));
+		int icosy = (int)(invCos * (65536.0f * Graphics::kDefaultZoomY / transform._zoom.y));
+		int isiny = (int)(invSin * (65536.0f * Graphics::kDefaultZoomY / transform._zoom.y));
+
+		int xd = transform._hotspot.x << 16;
+		int yd = transform._hotspot.y << 16;
+		int ax = -icosx * newHotspot.x;
+		int ay = -isiny * newHotspot.x;
+		int sw = src.w - 1;
+		int sh = src.h - 1;
+
+		for (int y = 0; y < dst.h; y++) {
+			int t = newHotspot.y - y;
+			int sdx = ax + (isinx * t) + xd;
+			int sdy = ay - (icosy * t) + yd;
+			for (int x = 0; x < dst.w; x++) {
+				int dx = (sdx >> 16);
+				int dy = (sdy >> 16);
+				if (flipx)
+					dx = sw - dx;
+				if (flipy)
+					dy = sh - dy;
+
+				if (filtering) {
+					if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
+						uint32 c00 = src.getPixel(dx, dy), c01 = src.getPixel(dx + 1, dy);
+						uint32 c10 = src.getPixel(dx, dy + 1), c11 = src.getPixel(dx + 1, dy + 1);
+						if (flipx) {
+							SWAP(c00, c01);
+							SWAP(c10, c11);
+						}
+						if (flipy) {
+							SWAP(c00, c10);
+							SWAP(c01, c11);
+						}
+						dst.setPixel(x, y, interpolate<ColorMask>(src.format, c01, c00, c11, c10, sdx & 0xffff, sdy & 0xffff));
+					}
+				} else {
+					if ((dx >= 0) && (dy >= 0) && (dx < src.w) && (dy < src.h))
+						dst.setPixel(x, y, src.getPixel(dx, dy));
+				}
+				sdx += icosx;
+				sdy += isiny;
+			}
+		}
+	}
+
+	static bool equals(const Graphics::Surface &a, const Graphics::Surface &b) {
+		if (a.w != b.w || a.h != b.h)
+			return false;
+		for (int y = 0; y < a.h; ++y) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * a.format.bytesPerPixel))
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_rotoscale() {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)
+		};
+		static const int angles[] = { 1, 30, 45, 90, 135, 180, 233, 270, 359 };
+		static const int zooms[][2] = { { 100, 100 }, { 250, 70 }, { 33, 180 } };
+
+		for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+			Graphics::Surface src;
+			src.create(29, 17, formats[f]);
+			fillRandom(src, 11 + f);
+
+			for (uint a = 0; a < ARRAYSIZE(angles); ++a) {
+				for (uint z = 0; z < ARRAYSIZE(zooms); ++z) {
+					for (int flip = 0; flip < 4; ++flip) {
+						for (int filtering = 0; filtering < 2; ++filtering) {
+							const Graphics::TransformStruct transform(zooms[z][0], zooms[z][1], angles[a], 7, 5,
+							                                          Graphics::BLEND_NORMAL, Graphics::kDefaultRgbaMod,
+							                                          flip & 1, flip & 2);
+							Common::Point newHotspot;
+							const Common::Rect rect = Graphics::TransformTools::newRect(Common::Rect(src.w, src.h), transform, &newHotspot);
+
+							Graphics::Surface expected;
+							expected.create(rect.width(), rect.height(), src.format);
+							if (src.format.bytesPerPixel == 2)
+								referenceRotoscale<Graphics::ColorMasks<565> >(expected, src, transform, newHotspot, filtering);
+							else
+								referenceRotoscale<Graphics::ColorMasks<0> >(expected, src, transform, newHotspot, filtering);
+
+							Graphics::Surface *actual = src.rotoscale(transform, filtering);
+							TSM_ASSERT(Common::String::format("format %d, angle %d, zoom %d, flip %d, filtering %d",
+							           f, angles[a], z, flip, filtering).c_str(), equals(expected, *actual));
+
+							actual->free();
+							delete actual;
+							expected.free();
+						}
+					}
+				}
+			}
+
+			src.free();
+		}
+	}
+
+	void test_scaleBlitBilinear() {
+		// The byte wise interpolation of 32 bit formats has to match the
+		// one working on the separate channels, used for other formats.
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+
+		Graphics::Surface src;
+		src.create(13, 9, format);
+		fillRandom(src, 21);
+
+		for (int flip = 0; flip < 4; ++flip) {
+			Graphics::Surface dst;
+			dst.create(31, 5, format);
+			TS_ASSERT(Graphics::scaleBlitBilinear((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch,
+			                                      dst.w, dst.h, src.w, src.h, format, flip));
+
+			// The sampling positions of scaleBlitBilinear()
+			const int sx = (int)(65536.0f * (float)(src.w - 1) / (float)(dst.w - 1));
+			const int sy = (int)(65536.0f * (float)(src.h - 1) / (float)(dst.h - 1));
+			for (int y = 0; y < dst.h; ++y) {
+				for (int x = 0; x < dst.w; ++x) {
+					const int px = MIN(x * sx, (src.w << 16) - 1), py = MIN(y * sy, (src.h << 16) - 1);
+					int x0 = px >> 16, y0 = py >> 16;
+					int x1 = MIN(x0 + 1, src.w - 1), y1 = MIN(y0 + 1, src.h - 1);
+					if (flip & Graphics::FLIP_H) {
+						x0 = src.w - 1 - x0;
+						x1 = src.w - 1 - x1;
+					}
+					if (flip & Graphics::FLIP_V) {
+						y0 = src.h - 1 - y0;
+						y1 = src.h - 1 - y1;
+					}
+					const uint32 expected = interpolate<Graphics::ColorMasks<0> >(format, src.getPixel(x1, y0), src.getPixel(x0, y0),
+					                                    src.getPixel(x1, y1), src.getPixel(x0, y1), px & 0xffff, py & 0xffff);
+					TS_ASSERT_EQUALS(dst.getPixel(x, y), expected);
+				}
+			}
+
+			dst.free();
+		}
+
+		src.free();
+	}
+
+	void test_crossBlitMap_separate() {
+		uint32 map[256];
+		createMap(map);
+
+		byte src[kHeight * (kWidth + 3)];
+		for (uint i = 0; i < sizeof(src); ++i)
+			src[i] = (byte)(i * 37 + 11);
+
+		// Odd widths and pitches exercise the tail handling.
+		uint32 dst32[kHeight * (kWidth + 1)];
+		TS_ASSERT(Graphics::crossBlitMap((byte *)dst32, src, (kWidth + 1) * 4, kWidth + 3, kWidth, kHeight, 4, map));
+		checkMapped<uint32>(src, kWidth + 3, (const byte *)dst32, (kWidth + 1) * 4, map);
+
+		uint16 dst16[kHeight * (kWidth + 1)];
+		TS_ASSERT(Graphics::crossBlitMap((byte *)dst16, src, (kWidth + 1) * 2, kWidth + 3, kWidth, kHeight, 2, map));
+		checkMapped<uint16>(src, kWidth + 3, (const byte *)dst16, (kWidth + 1) * 2, map);
+	}
+
+	void test_crossBlitMap_inplace() {
+		uint32 map[256];
+		createMap(map);
+
+		byte indices[kHeight * kWidth];
+		for (uint i = 0; i < sizeof(indices); ++i)
+			indices[i] = (byte)(i * 53 + 7);
+
+		// The indices are at the start of the buffer which receives the
+		// converted pixels.
+		uint32 buffer[kHeight * kWidth];
+		memcpy(buffer, indices, sizeof(indices));
+		TS_ASSERT(Graphics::crossBlitMap((byte *)buffer, (const byte *)buffer, kWidth * 4, kWidth, kWidth, kHeight, 4, map));
+		checkMapped<uint32>(indices, kWidth, (const byte *)buffer, kWidth * 4, map);
+	}
+};
@@ -0,0 +1,171 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "graphics/frametimings.h"
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+class FrameTimingsTestSuite : public CxxTest::TestSuite {
+public:
+	void test_disabled() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Graphics::FrameTimings timings;
+		timings.startPhase(Graphics::FrameTimings::kPhaseScale);
+		timings.endPhase(Graphics::FrameTimings::kPhaseScale);
+		timings.endFrame();
+		TS_ASSERT_EQUALS(timings.size(), 0u);
+#endif
+	}
+
+	void test_history() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Graphics::FrameTimings timings;
+		timings.setEnabled(true);
+
+		for (uint i = 0; i < Graphics::FrameTimings::kHistorySize + 10; ++i) {
+			timings.startPhase(Graphics::FrameTimings::kPhaseCopyRect);
+			timings.endPhase(Graphics::FrameTimings::kPhaseCopyRect);
+			timings.startPhase(Graphics::FrameTimings::kPhasePresent);
+			timings.endPhase(Graphics::FrameTimings::kPhasePresent);
+			timings.endFrame();
+		}
+
+		TS_ASSERT_EQUALS(timings.size(), (uint)Graphics::FrameTimings::kHistorySize);
+
+		for (uint i = 0; i < timings.size(); ++i) {
+			const Graphics::FrameTimings::Frame &frame = timings.getFrame(i);
+
+			// The engine gets whatever the phases did not cover
+			uint32 sum = 0;
+			for (int j = 0; j < Graphics::FrameTimings::kPhaseCount; ++j)
+				sum += frame.phases[j];
+			TS_ASSERT_LESS_THAN_EQUALS(frame.duration, sum);
+			TS_ASSERT_EQUALS(frame.phases[Graphics::FrameTimings::kPhaseScale], 0u);
+
+			// Oldest first, each frame starting when the previous one ended
+			if (i > 0) {
+				const Graphics::FrameTimings::Frame &previous = timings.getFrame(i - 1);
+				TS_ASSERT_EQUALS(frame.start, previous.start + previous.duration);
+			}
+		}
+
+		timings.clear();
+		TS_ASSERT_EQUALS(timings.size(), 0u);
+#endif
+	}
+
+	void test_csv() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Graphics::FrameTimings timings;
+		timings.setEnabled(true);
+		for (int i = 0; i < 3; ++i)
+			timings.endFrame();
+
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		TS_ASSERT(timings.writeCSV(stream));
+
+		Common::String csv((const char *)stream.getData(), stream.size());
+		TS_ASSERT(csv.hasPrefix("frame,start,duration,engine,copyrect,wait,scale,cursor,graph,upload,present,late\n"));
+
+		uint lines = 0;
+		for (uint i = 0; i < csv.size(); ++i) {
+			if (csv[i] == '\n')
+				++lines;
+		}
+		TS_ASSERT_EQUALS(lines, 4u);
+#endif
+	}
+
+	void test_nested() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Graphics::FrameTimings timings;
+		timings.setEnabled(true);
+
+		timings.startPhase(Graphics::FrameTimings::kPhaseScale);
+		timings.startPhase(Graphics::FrameTimings::kPhaseGraph);
+		g_system->delayMillis(5);
+		timings.endPhase(Graphics::FrameTimings::kPhaseGraph);
+		timings.endPhase(Graphics::FrameTimings::kPhaseScale);
+		timings.endFrame();
+
+		// The inner phase is not counted towards the outer one as well
+		const Graphics::FrameTimings::Frame &frame = timings.getFrame(0);
+		TS_ASSERT_LESS_THAN_EQUALS(5000u, frame.phases[Graphics::FrameTimings::kPhaseGraph]);
+		TS_ASSERT_LESS_THAN_EQUALS(frame.phases[Graphics::FrameTimings::kPhaseScale] + frame.phases[Graphics::FrameTimings::kPhaseGraph], frame.duration);
+
+		// Ending a phase which was never started is ignored
+		timings.endPhase(Graphics::FrameTimings::kPhaseUpload);
+		timings.endFrame();
+		TS_ASSERT_EQUALS(timings.getFrame(1).phases[Graphics::FrameTimings::kPhaseUpload], 0u);
+#endif
+	}
+
+	void test_frame_limiter() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Graphics::FrameTimings timings;
+		timings.setEnabled(true);
+
+		// Reports as made by Graphics::FrameLimiter::delayBeforeSwap()
+		Graphics::FrameTimings::reportFrameLimiter(7, 0);
+		timings.endFrame();
+		Graphics::FrameTimings::reportFrameLimiter(0, 1);
+		timings.endFrame();
+		Graphics::FrameTimings::reportFrameLimiter(3, 1);
+		timings.endFrame();
+
+		TS_ASSERT_EQUALS(timings.getFrame(0).phases[Graphics::FrameTimings::kPhaseWait], 7000u);
+		TS_ASSERT(!timings.getFrame(0).late);
+		TS_ASSERT_EQUALS(timings.getFrame(1).phases[Graphics::FrameTimings::kPhaseWait], 0u);
+		TS_ASSERT(timings.getFrame(1).late);
+		TS_ASSERT_EQUALS(timings.getFrame(2).phases[Graphics::FrameTimings::kPhaseWait], 3000u);
+		TS_ASSERT(!timings.getFrame(2).late);
+
+		// Only enabled timings get the reports
+		timings.setEnabled(false);
+		Graphics::FrameTimings::reportFrameLimiter(5, 2);
+		timings.setEnabled(true);
+		timings.endFrame();
+		TS_ASSERT_EQUALS(timings.getFrame(3).phases[Graphics::FrameTimings::kPhaseWait], 0u);
+		TS_ASSERT(!timings.getFrame(3).late);
+#endif
+	}
+
+	void test_graph() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		Graphics::FrameTimings timings;
+		timings.setEnabled(true);
+		timings.endFrame();
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::Surface surface;
+		surface.create(32, 20, format);
+		timings.drawGraph(surface);
+
+		// Columns without frames only show the background
+		TS_ASSERT_EQUALS(surface.getPixel(0, 19), format.ARGBToColor(160, 0, 0, 0));
+
+		surface.free();
+#endif
+	}
+};
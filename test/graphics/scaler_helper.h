@@ -0,0 +1,245 @@
+#ifndef TEST_GRAPHICS_SCALER_HELPER_H
+#define TEST_GRAPHICS_SCALER_HELPER_H
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "base/plugins.h"
+
+#include "common/array.h"
+#include "common/crc.h"
+
+#include "graphics/scalerplugin.h"
+#include "graphics/surface.h"
+
+/**
+ * Instantiate all scaler plugins which are compiled in. The caller is
+ * responsible for deleting them.
+ *
+ * This lives outside of the ScalerTest namespace, since the plugin
+ * accessors are declared in the global one.
+ */
+static inline void createScalerPlugins(Common::Array<ScalerPluginObject *> &plugins) {
+#define LINK_SCALER(ID) \
+	extern PluginObject *g_##ID##_getObject(); \
+	plugins.push_back(static_cast<ScalerPluginObject *>(g_##ID##_getObject()));
+
+	LINK_SCALER(NORMAL)
+#ifdef USE_SCALERS
+#ifdef USE_HQ_SCALERS
+	LINK_SCALER(HQ)
+#endif
+#ifdef USE_EDGE_SCALERS
+	LINK_SCALER(EDGE)
+#endif
+	LINK_SCALER(ADVMAME)
+	LINK_SCALER(SAI)
+	LINK_SCALER(SUPERSAI)
+	LINK_SCALER(SUPEREAGLE)
+	LINK_SCALER(PM)
+	LINK_SCALER(DOTMATRIX)
+	LINK_SCALER(TV)
+#endif
+
+#undef LINK_SCALER
+}
+
+static inline void destroyScalerPlugins(Common::Array<ScalerPluginObject *> &plugins) {
+	for (uint i = 0; i < plugins.size(); ++i)
+		delete plugins[i];
+	plugins.clear();
+}
+
+namespace ScalerTest {
+
+enum {
+	kScreenWidth = 160,
+	kScreenHeight = 100,
+	kPadding = 4
+};
+
+enum Format {
+	kFormatRGB565,
+	kFormatRGB555,
+	kFormatRGBA8888,
+	kFormatCount
+};
+
+static inline Graphics::PixelFormat getFormat(Format format) {
+	switch (format) {
+	case kFormatRGB565:
+		return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	case kFormatRGB555:
+		return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);
+	default:
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	}
+}
+
+static inline const char *getFormatName(Format format) {
+	switch (format) {
+	case kFormatRGB565:
+		return "RGB565";
+	case kFormatRGB555:
+		return "RGB555";
+	default:
+		return "RGBA8888";
+	}
+}
+
+/**
+ * Create a palette similar to the ones of VGA games: the 16 EGA colors
+ * followed by ramps of a few hues.
+ */
+static inline void createPalette(byte *palette) {
+	static const byte ega[16][3] = {
+		{ 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0xAA }, { 0x00, 0xAA, 0x00 }, { 0x00, 0xAA, 0xAA },
+		{ 0xAA, 0x00, 0x00 }, { 0xAA, 0x00, 0xAA }, { 0xAA, 0x55, 0x00 }, { 0xAA, 0xAA, 0xAA },
+		{ 0x55, 0x55, 0x55 }, { 0x55, 0x55, 0xFF }, { 0x55, 0xFF, 0x55 }, { 0x55, 0xFF, 0xFF },
+		{ 0xFF, 0x55, 0x55 }, { 0xFF, 0x55, 0xFF }, { 0xFF, 0xFF, 0x55 }, { 0xFF, 0xFF, 0xFF }
+	};
+	static const byte hues[5][3] = {
+		{ 96, 160, 255 }, { 200, 120, 64 }, { 64, 200, 96 }, { 220, 200, 160 }, { 160, 64, 160 }
+	};
+
+	memcpy(palette, ega, sizeof(ega));
+	for (int i = 16; i < 256; ++i) {
+		const byte *hue = hues[((i - 16) / 48) % 5];
+		const int level = (i - 16) % 48;
+		palette[i * 3 + 0] = hue[0] * level / 47;
+		palette[i * 3 + 1] = hue[1] * level / 47;
+		palette[i * 3 + 2] = hue[2] * level / 47;
+	}
+}
+
+/**
+ * Draw an 8-bit image resembling a game screen: a dithered sky gradient,
+ * a brick wall, a round sprite with an outline and a dialog box with text.
+ */
+static inline void createScreenshot(Graphics::Surface &screen) {
+	static const byte bayer[4][4] = {
+		{  0,  8,  2, 10 },
+		{ 12,  4, 14,  6 },
+		{  3, 11,  1,  9 },
+		{ 15,  7, 13,  5 }
+	};
+
+	screen.create(kScreenWidth + kPadding * 2, kScreenHeight + kPadding * 2, Graphics::PixelFormat::createFormatCLUT8());
+
+	const int skyHeight = screen.h * 2 / 5;
+	const int wallHeight = screen.h * 3 / 10;
+	for (int y = 0; y < screen.h; ++y) {
+		byte *row = (byte *)screen.getBasePtr(0, y);
+		for (int x = 0; x < screen.w; ++x) {
+			if (y < skyHeight) {
+				// Sky: blue ramp, ordered dithering between two levels
+				const int level = 16 * 47 * y / skyHeight;
+				row[x] = 16 + 47 - level / 16 - ((level & 15) > bayer[y & 3][x & 3] ? 1 : 0);
+			} else if (y < skyHeight + wallHeight) {
+				// Brick wall with mortar lines
+				const int wy = y - skyHeight;
+				const int wx = x + ((wy / 6) & 1) * 6;
+				if (wy % 6 == 5 || wx % 12 == 11)
+					row[x] = 7;
+				else
+					row[x] = 64 + 30 + ((wx / 12 + wy / 6) % 3) * 4;
+			} else {
+				// Dialog box with a border
+				const int by = y - skyHeight - wallHeight;
+				if (by < 2 || x < 2 || x >= screen.w - 2 || y >= screen.h - 2)
+					row[x] = 15;
+				else
+					row[x] = 1;
+			}
+		}
+	}
+
+	// A round sprite with a dark outline, crossing the horizon
+	const int cx = screen.w * 2 / 3, cy = skyHeight, radius = 14;
+	for (int y = cy - radius - 1; y <= cy + radius + 1; ++y) {
+		for (int x = cx - radius - 1; x <= cx + radius + 1; ++x) {
+			const int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+			if (d <= radius * radius)
+				screen.setPixel(x, y, 112 + 20 + (x - cx + y - cy + 2 * radius) / 4);
+			else if (d <= (radius + 1) * (radius + 1))
+				screen.setPixel(x, y, 0);
+		}
+	}
+
+	// Pseudo random 5x7 glyphs as text in the dialog box
+	uint32 seed = 12345;
+	for (int line = 0; line < 2; ++line) {
+		const int ty = skyHeight + wallHeight + 5 + line * 9;
+		for (int tx = 5; tx + 5 < screen.w - 4; tx += 6) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 glyph = seed >> 1;
+			if ((glyph & 7) == 0)
+				continue;
+			for (int gy = 0; gy < 7; ++gy)
+				for (int gx = 0; gx < 5; ++gx)
+					if ((glyph >> ((gy * 5 + gx) % 31)) & 1)
+						screen.setPixel(tx + gx, ty + gy, 14);
+		}
+	}
+}
+
+/**
+ * Create the test screen converted to the given pixel format, including
+ * kPadding pixels on each side for scalers which look outside the area.
+ */
+static inline void createSource(Graphics::Surface &src, const Graphics::PixelFormat &format) {
+	Graphics::Surface screen;
+	createScreenshot(screen);
+
+	byte palette[256 * 3];
+	createPalette(palette);
+
+	src.create(screen.w, screen.h, format);
+	for (int y = 0; y < screen.h; ++y) {
+		const byte *in = (const byte *)screen.getBasePtr(0, y);
+		for (int x = 0; x < screen.w; ++x) {
+			const byte *color = palette + in[x] * 3;
+			src.setPixel(x, y, format.RGBToColor(color[0], color[1], color[2]));
+		}
+	}
+
+	screen.free();
+}
+
+/**
+ * Scale the area of src inside the padding into dst, which is created
+ * with the matching size.
+ */
+static inline void scaleSource(Scaler &scaler, const Graphics::Surface &src, Graphics::Surface &dst) {
+	const uint factor = scaler.getFactor();
+	const int width = src.w - kPadding * 2;
+	const int height = src.h - kPadding * 2;
+
+	if (dst.w != width * (int)factor || dst.h != height * (int)factor || dst.format != src.format) {
+		dst.free();
+		dst.create(width * factor, height * factor, src.format);
+	}
+
+	scaler.scale((const uint8 *)src.getBasePtr(kPadding, kPadding), src.pitch,
+	             (uint8 *)dst.getPixels(), dst.pitch, width, height, 0, 0);
+}
+
+/**
+ * The CRC-32 of the pixel data of a surface, excluding any pitch padding.
+ */
+static inline uint32 computeChecksum(const Graphics::Surface &surface) {
+	Common::CRC32 crc;
+	const int rowSize = surface.w * surface.format.bytesPerPixel;
+	if (surface.pitch == rowSize)
+		return crc.crcFast((const byte *)surface.getPixels(), rowSize * surface.h);
+
+	Common::Array<byte> buffer(rowSize * surface.h);
+	for (int y = 0; y < surface.h; ++y)
+		memcpy(&buffer[y * rowSize], surface.getBasePtr(0, y), rowSize);
+	return crc.crcFast(buffer.data(), buffer.size());
+}
+
+} // End of namespace ScalerTest
+
+#endif
@@ -0,0 +1,311 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/surface.h"
+#include "graphics/scaler/normal.h"
+#include "graphics/scaler/hq.h"
+#include "graphics/scaler/scalebit.h"
+
+#include "scaler_helper.h"
+
+/**
+ * Golden image tests for the scalers.
+ *
+ * A fixed test image is scaled and the output compared against checksums
+ * of the output of the plain C implementations. This assures optimized
+ * code paths give exactly the same result.
+ */
+class ScalerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 48,
+		kHeight = 24,
+		kPadding = 4
+	};
+
+	struct GoldenImage {
+		int bytesPerPixel;
+		uint factor;
+		int width;
+		uint32 checksum;
+	};
+
+	static Graphics::PixelFormat getFormat(int bytesPerPixel) {
+		if (bytesPerPixel == 2)
+			return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	}
+
+	/**
+	 * Create a test image with runs of a few colors. Some of them are very
+	 * similar, so the HQ scalers take all kinds of paths.
+	 */
+	static void createSource(Graphics::Surface &src, const Graphics::PixelFormat &format) {
+		static const byte colors[][3] = {
+			{   0,   0,   0 }, { 255, 255, 255 }, { 200,  40,  40 },
+			{ 204,  44,  40 }, {  40, 200,  80 }, {  40,  80, 200 },
+			{ 128, 128, 128 }, { 136, 128, 120 }
+		};
+
+		src.create(kWidth + kPadding * 2, kHeight + kPadding * 2, format);
+
+		uint32 seed = 12345;
+		uint color = 0;
+		for (int y = 0; y < src.h; ++y) {
+			for (int x = 0; x < src.w; ++x) {
+				seed = seed * 1103515245 + 12345;
+				if (((seed >> 16) & 3) == 0)
+					color = (seed >> 20) % ARRAYSIZE(colors);
+				// Repeat the row above now and then, to get vertical edges.
+				if (y > 0 && ((seed >> 24) & 7) == 0)
+					src.setPixel(x, y, src.getPixel(x, y - 1));
+				else
+					src.setPixel(x, y, format.RGBToColor(colors[color][0], colors[color][1], colors[color][2]));
+			}
+		}
+	}
+
+	static uint32 scaleChecksum(Scaler &scaler, const Graphics::Surface &src, uint factor, int width) {
+		scaler.setFactor(factor);
+
+		Graphics::Surface dst;
+		dst.create(width * factor, kHeight * factor, src.format);
+		scaler.scale((const uint8 *)src.getBasePtr(kPadding, kPadding), src.pitch,
+		             (uint8 *)dst.getPixels(), dst.pitch, width, kHeight, 0, 0);
+
+		const uint32 checksum = ScalerTest::computeChecksum(dst);
+		dst.free();
+		return checksum;
+	}
+
+	template<class ScalerType>
+	void checkGolden(const GoldenImage *golden, uint count) {
+		for (uint i = 0; i < count; ++i) {
+			const Graphics::PixelFormat format = getFormat(golden[i].bytesPerPixel);
+
+			Graphics::Surface src;
+			createSource(src, format);
+
+			ScalerType scaler(format);
+			const uint32 checksum = scaleChecksum(scaler, src, golden[i].factor, golden[i].width);
+			TS_ASSERT_EQUALS(checksum, golden[i].checksum);
+
+			src.free();
+		}
+	}
+
+public:
+	void test_normal() {
+		static const GoldenImage golden[] = {
+			{ 2, 2, kWidth, 0xE965B5E8 },
+			{ 2, 3, kWidth, 0x2655B90F },
+			{ 4, 2, kWidth, 0xFACAA59F },
+			{ 4, 3, kWidth, 0x2E7D7FF7 }
+		};
+		checkGolden<NormalScaler>(golden, ARRAYSIZE(golden));
+	}
+
+	void test_advmame() {
+#ifdef USE_SCALERS
+		static const GoldenImage golden[] = {
+			{ 2, 2, kWidth, 0xFBA6979C },
+			{ 2, 3, kWidth, 0xD92A56E3 },
+			{ 2, 4, kWidth, 0x4591428D },
+			{ 4, 2, kWidth, 0x90B815DD },
+			{ 4, 3, kWidth, 0x3F5861D3 },
+			{ 4, 4, kWidth, 0x39D8922F },
+			{ 2, 3, kWidth - 3, 0xEEB24619 },
+			{ 4, 3, kWidth - 3, 0xADBE50D9 }
+		};
+		checkGolden<AdvMameScaler>(golden, ARRAYSIZE(golden));
+#endif
+	}
+
+	/**
+	 * Scale the test screen with every scaler plugin, at every factor and
+	 * in every pixel format.
+	 */
+	void test_plugins() {
+		struct PluginGolden {
+			const char *name;
+			uint factor;
+			ScalerTest::Format format;
+			uint32 checksum;
+		};
+
+		static const PluginGolden golden[] = {
+			{ "normal", 1, ScalerTest::kFormatRGB565, 0x5B703B83 },
+			{ "normal", 2, ScalerTest::kFormatRGB565, 0x6B1C248E },
+			{ "normal", 3, ScalerTest::kFormatRGB565, 0x1913DF48 },
+			{ "normal", 4, ScalerTest::kFormatRGB565, 0x43C59965 },
+			{ "normal", 5, ScalerTest::kFormatRGB565, 0x67DB6D53 },
+			{ "normal", 1, ScalerTest::kFormatRGB555, 0x4904EF2C },
+			{ "normal", 2, ScalerTest::kFormatRGB555, 0x228C62F4 },
+			{ "normal", 3, ScalerTest::kFormatRGB555, 0x032A43DE },
+			{ "normal", 4, ScalerTest::kFormatRGB555, 0x97C051CD },
+			{ "normal", 5, ScalerTest::kFormatRGB555, 0x84F0BF7B },
+			{ "normal", 1, ScalerTest::kFormatRGBA8888, 0xCEDB1671 },
+			{ "normal", 2, ScalerTest::kFormatRGBA8888, 0xF380BC18 },
+			{ "normal", 3, ScalerTest::kFormatRGBA8888, 0xD2DC4732 },
+			{ "normal", 4, ScalerTest::kFormatRGBA8888, 0x8B8BCD5A },
+			{ "normal", 5, ScalerTest::kFormatRGBA8888, 0x309EB212 },
+			{ "hq", 2, ScalerTest::kFormatRGB565, 0xB9BBF4E0 },
+			{ "hq", 3, ScalerTest::kFormatRGB565, 0x94B6E2F4 },
+			{ "hq", 2, ScalerTest::kFormatRGB555, 0x060B9F50 },
+			{ "hq", 3, ScalerTest::kFormatRGB555, 0x38F384A6 },
+			{ "hq", 2, ScalerTest::kFormatRGBA8888, 0x7C726A06 },
+			{ "hq", 3, ScalerTest::kFormatRGBA8888, 0x4D874CF5 },
+			{ "edge", 2, ScalerTest::kFormatRGB565, 0x5E5F100C },
+			{ "edge", 3, ScalerTest::kFormatRGB565, 0x2155547E },
+			{ "edge", 2, ScalerTest::kFormatRGB555, 0xD6B11B50 },
+			{ "edge", 3, ScalerTest::kFormatRGB555, 0x725511CD },
+			{ "edge", 2, ScalerTest::kFormatRGBA8888, 0xE8F95026 },
+			{ "edge", 3, ScalerTest::kFormatRGBA8888, 0xB870D65D },
+			{ "advmame", 2, ScalerTest::kFormatRGB565, 0x3FBAD4B3 },
+			{ "advmame", 3, ScalerTest::kFormatRGB565, 0x1AC9F945 },
+			{ "advmame", 4, ScalerTest::kFormatRGB565, 0xAE4BA2B1 },
+			{ "advmame", 2, ScalerTest::kFormatRGB555, 0x4D0C0BB5 },
+			{ "advmame", 3, ScalerTest::kFormatRGB555, 0xBD59A194 },
+			{ "advmame", 4, ScalerTest::kFormatRGB555, 0x2E59DFB7 },
+			{ "advmame", 2, ScalerTest::kFormatRGBA8888, 0x2AC8F169 },
+			{ "advmame", 3, ScalerTest::kFormatRGBA8888, 0x62AA83B7 },
+			{ "advmame", 4, ScalerTest::kFormatRGBA8888, 0xE8BB98DF },
+			{ "sai", 2, ScalerTest::kFormatRGB565, 0xA575C67F },
+			{ "sai", 2, ScalerTest::kFormatRGB555, 0xF73BE01C },
+			{ "sai", 2, ScalerTest::kFormatRGBA8888, 0xF94BF327 },
+			{ "supersai", 2, ScalerTest::kFormatRGB565, 0x7D428B40 },
+			{ "supersai", 2, ScalerTest::kFormatRGB555, 0x4E9C3FD1 },
+			{ "supersai", 2, ScalerTest::kFormatRGBA8888, 0xF4424583 },
+			{ "supereagle", 2, ScalerTest::kFormatRGB565, 0x83A3A35B },
+			{ "supereagle", 2, ScalerTest::kFormatRGB555, 0x01981CC5 },
+			{ "supereagle", 2, ScalerTest::kFormatRGBA8888, 0x287C1BB7 },
+			{ "pm", 2, ScalerTest::kFormatRGB565, 0x033C1DE1 },
+			{ "pm", 2, ScalerTest::kFormatRGB555, 0xA12C87BF },
+			{ "pm", 2, ScalerTest::kFormatRGBA8888, 0xEE43968F },
+			{ "dotmatrix", 2, ScalerTest::kFormatRGB565, 0x3F61C77C },
+			{ "dotmatrix", 2, ScalerTest::kFormatRGB555, 0x6AA56C6B },
+			{ "dotmatrix", 2, ScalerTest::kFormatRGBA8888, 0x94A4E738 },
+			{ "tv", 2, ScalerTest::kFormatRGB565, 0xA76BDC93 },
+			{ "tv", 2, ScalerTest::kFormatRGB555, 0xA6D0D9BB },
+			{ "tv", 2, ScalerTest::kFormatRGBA8888, 0x3F753422 }
+		};
+
+		Common::Array<ScalerPluginObject *> plugins;
+		createScalerPlugins(plugins);
+
+		for (uint i = 0; i < plugins.size(); ++i) {
+			const ScalerPluginObject *plugin = plugins[i];
+			const Common::Array<uint> &factors = plugin->getFactors();
+			TS_ASSERT(plugin->extraPixels() <= ScalerTest::kPadding);
+
+			for (int f = 0; f < ScalerTest::kFormatCount; ++f) {
+				const ScalerTest::Format format = (ScalerTest::Format)f;
+				const Graphics::PixelFormat pixelFormat = ScalerTest::getFormat(format);
+
+				Graphics::Surface src, dst;
+				ScalerTest::createSource(src, pixelFormat);
+				Scaler *scaler = plugin->createInstance(pixelFormat);
+
+				for (uint j = 0; j < factors.size(); ++j) {
+					scaler->setFactor(factors[j]);
+					ScalerTest::scaleSource(*scaler, src, dst);
+					const uint32 checksum = ScalerTest::computeChecksum(dst);
+
+					const PluginGolden *entry = nullptr;
+					for (uint k = 0; k < ARRAYSIZE(golden); ++k) {
+						if (!strcmp(golden[k].name, plugin->getName()) && golden[k].factor == factors[j] && golden[k].format == format) {
+							entry = &golden[k];
+							break;
+						}
+					}
+
+					TSM_ASSERT(Common::String::format("%s %ux %s has no golden checksum", plugin->getName(), factors[j], ScalerTest::getFormatName(format)).c_str(), entry);
+					if (entry)
+						TSM_ASSERT_EQUALS(Common::String::format("%s %ux %s", plugin->getName(), factors[j], ScalerTest::getFormatName(format)).c_str(), checksum, entry->checksum);
+				}
+
+				delete scaler;
+				dst.free();
+				src.free();
+			}
+		}
+
+		destroyScalerPlugins(plugins);
+	}
+
+	/**
+	 * The SDL backend scales horizontal bands of a rect on several threads,
+	 * each with its own scaler instance. Scale the bands one after another,
+	 * last one first, and check the result matches scaling the whole rect.
+	 */
+	void test_plugin_bands() {
+		Common::Array<ScalerPluginObject *> plugins;
+		createScalerPlugins(plugins);
+
+		for (uint i = 0; i < plugins.size(); ++i) {
+			const ScalerPluginObject *plugin = plugins[i];
+			if (plugin->useOldSource())
+				continue;
+
+			const Common::Array<uint> &factors = plugin->getFactors();
+			for (int f = 0; f < ScalerTest::kFormatCount; ++f) {
+				const ScalerTest::Format format = (ScalerTest::Format)f;
+				const Graphics::PixelFormat pixelFormat = ScalerTest::getFormat(format);
+
+				Graphics::Surface src, whole;
+				ScalerTest::createSource(src, pixelFormat);
+				Scaler *scaler = plugin->createInstance(pixelFormat);
+
+				for (uint j = 0; j < factors.size(); ++j) {
+					const uint factor = factors[j];
+					scaler->setFactor(factor);
+					ScalerTest::scaleSource(*scaler, src, whole);
+					const uint32 expected = ScalerTest::computeChecksum(whole);
+
+					for (int numBands = 2; numBands <= 6; ++numBands) {
+						const int width = ScalerTest::kScreenWidth;
+						const int height = ScalerTest::kScreenHeight;
+						const int bandHeight = height / numBands;
+
+						Graphics::Surface dst;
+						dst.create(width * factor, height * factor, pixelFormat);
+						for (int band = numBands - 1; band >= 0; --band) {
+							const int top = band * bandHeight;
+							const int rows = (band == numBands - 1) ? height - top : bandHeight;
+
+							Scaler *bandScaler = plugin->createInstance(pixelFormat);
+							bandScaler->setFactor(factor);
+							bandScaler->scale((const uint8 *)src.getBasePtr(ScalerTest::kPadding, ScalerTest::kPadding + top), src.pitch,
+							                  (uint8 *)dst.getBasePtr(0, top * factor), dst.pitch, width, rows, 0, top);
+							delete bandScaler;
+						}
+
+						TSM_ASSERT_EQUALS(Common::String::format("%s %ux %s in %d bands", plugin->getName(), factor, ScalerTest::getFormatName(format), numBands).c_str(),
+						                  ScalerTest::computeChecksum(dst), expected);
+						dst.free();
+					}
+				}
+
+				delete scaler;
+				whole.free();
+				src.free();
+			}
+		}
+
+		destroyScalerPlugins(plugins);
+	}
+
+	void test_hq() {
+#ifdef USE_HQ_SCALERS
+		static const GoldenImage golden[] = {
+			{ 2, 2, kWidth - 3, 0x825A5F05 },
+			{ 2, 3, kWidth - 3, 0x818C2090 },
+			{ 4, 2, kWidth - 3, 0xE1E01396 },
+			{ 4, 3, kWidth - 3, 0x526FD6FE }
+		};
+		checkGolden<HQScaler>(golden, ARRAYSIZE(golden));
+#endif
+	}
+};
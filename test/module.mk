@@ -1,11 +1,14 @@
 ######################################################################
 # Unit/regression tests, based on CxxTest.
-# Use the 'test' target to run them.
-# Edit TESTS and TESTLIBS to add more tests.
+# Use the 'test' target to run them, and the 'benchmark' target to run
+# the (slow) benchmarks.
+# Edit TESTS and TESTLIBS to add more tests, BENCHMARKS to add more
+# benchmarks.
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h
+BENCHMARKS   := $(srcdir)/test/benchmark/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -74,9 +77,17 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+benchmark: test/benchmark-runner
+	./test/benchmark-runner
+test/benchmark-runner: test/benchmark-runner.cpp $(TEST_LIBS)
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/benchmark-runner.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
+test/benchmark-runner.cpp: $(BENCHMARKS) $(srcdir)/test/module.mk
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/benchmark-runner.cpp test/benchmark-runner test/engine-data/encoding.dat test/null_osystem.o
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
@@ -85,4 +96,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test benchmark clean-test copy-dat
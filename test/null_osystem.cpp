@@ -1,5 +1,12 @@
 #define USE_NULL_DRIVER 1
 #define NULL_DRIVER_USE_FOR_TEST 1
+#ifdef POSIX
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+#define FORBIDDEN_SYMBOL_EXCEPTION_getenv
 #include "null_osystem.h"
 #include "../backends/platform/null/null.cpp"
 
@@ -7,6 +14,44 @@ void Common::install_null_g_system() {
 	g_system = OSystem_NULL_create();
 }
 
+bool Common::evict_file_from_os_cache(const char *path) {
+#if defined(POSIX) && defined(USE_POSIX_FADVISE)
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return false;
+	// Only clean pages can be dropped
+	bool result = fsync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(fd);
+	return result;
+#else
+	return false;
+#endif
+}
+
+Common::String Common::create_temp_directory() {
+#ifdef POSIX
+	const char *tmpDir = getenv("TMPDIR");
+	Common::String path = Common::String::format("%s/scummvm-test-XXXXXX", tmpDir && *tmpDir ? tmpDir : "/tmp");
+	// The Xs are replaced in place
+	if (mkdtemp(path.begin()))
+		return path;
+#endif
+	return Common::String();
+}
+
+#ifdef POSIX
+static int removeTempFile(const char *path, const struct stat *, int, struct FTW *) {
+	return remove(path);
+}
+#endif
+
+void Common::remove_temp_directory(const char *path) {
+#ifdef POSIX
+	// Remove the contents of each directory before the directory itself
+	nftw(path, removeTempFile, 16, FTW_DEPTH | FTW_PHYS);
+#endif
+}
+
 bool BaseBackend::setScaler(const char *name, int factor) {
 	return false;
 }
@@ -1,8 +1,21 @@
 #ifndef TEST_NULL_OSYSTEM
 #define TEST_NULL_OSYSTEM 1
 namespace Common {
+class String;
 #if defined(POSIX) || defined(WIN32)
 void install_null_g_system();
+/**
+ * Drop the given file from the cache of the operating system, so that the
+ * next reads come from the disk. Returns false where this is not supported.
+ */
+bool evict_file_from_os_cache(const char *path);
+/**
+ * Create a new empty directory in the temporary directory of the system and
+ * return its path. Returns an empty string where this is not supported.
+ */
+String create_temp_directory();
+/** Remove the given directory with all its contents. */
+void remove_temp_directory(const char *path);
 #define NULL_OSYSTEM_IS_AVAILABLE 1
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
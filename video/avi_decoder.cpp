@@ -27,6 +27,7 @@
 #include "audio/mixer.h"
 
 #include "video/avi_decoder.h"
+#include "engines/engine.h"
 
 // Audio Codecs
 #include "audio/decoders/wave_types.h"
@@ -82,6 +83,12 @@ enum {
 	kStreamTypeAudio         = MKTAG16('w', 'b')
 };
 
+// How many movie indices are kept for when the movies are loaded again
+enum {
+	kMaxCachedIndices = 16
+};
+
+IndexCache<AVIDecoder::IndexData> *AVIDecoder::_indexCache = nullptr;
 
 AVIDecoder::AVIDecoder() :
 		_frameRateOverride(0) {
@@ -422,6 +429,19 @@ void AVIDecoder::readPalette8(uint32 size) {
 	}
 }
 
+bool AVIDecoder::loadFile(const Common::Path &filename) {
+	// Let readOldIndex() know which file the index belongs to
+	_loadingPath = filename;
+	bool result = VideoDecoder::loadFile(filename);
+	_loadingPath = Common::Path();
+	return result;
+}
+
+void AVIDecoder::clearIndexCache() {
+	delete _indexCache;
+	_indexCache = nullptr;
+}
+
 bool AVIDecoder::loadStream(Common::SeekableReadStream *stream) {
 	close();
 
@@ -661,7 +681,7 @@ uint AVIDecoder::getVideoTrackOffset(uint trackIndex, uint frameNumber) {
 	if (trackIndex == _videoTracks.front().index && frameNumber == 0)
 		return _movieListStart;
 
-	OldIndex *entry = _indexEntries.find(trackIndex, frameNumber);
+	const OldIndex *entry = _indexEntries.find(trackIndex, frameNumber);
 	assert(entry);
 	return entry->offset;
 }
@@ -824,7 +844,7 @@ void AVIDecoder::seekTransparencyFrame(int frame) {
 
 	// Find the index entry for the frame
 	int indexFrame = frame;
-	OldIndex *entry = nullptr;
+	const OldIndex *entry = nullptr;
 	do {
 		entry = _indexEntries.find(status.index, indexFrame);
 	} while (!entry && indexFrame-- > 0);
@@ -871,12 +891,36 @@ void AVIDecoder::readOldIndex(uint32 size) {
 	if (entryCount == 0)
 		return;
 
+	// Share the index of the same file loaded before
+	if (_indexCache && !_loadingPath.empty()) {
+		IndexPtr cached = _indexCache->get(_loadingPath, _fileStream->size());
+		if (cached) {
+			debug(6, "Reusing the index of %s", _loadingPath.toString().c_str());
+			_indexEntries.set(cached);
+			_fileStream->skip(entryCount * 16);
+			return;
+		}
+	}
+
+	// Read the whole index in one go, rather than four values at a time
+	byte *indexData = new byte[entryCount * 16];
+	entryCount = _fileStream->read(indexData, entryCount * 16) / 16;
+
+	if (entryCount == 0) {
+		delete[] indexData;
+		return;
+	}
+
+	IndexData *index = new IndexData();
+	index->entries.reserve(entryCount);
+
 	// Read the first index separately
+	const byte *entryData = indexData;
 	OldIndex firstEntry;
-	firstEntry.id = _fileStream->readUint32BE();
-	firstEntry.flags = _fileStream->readUint32LE();
-	firstEntry.offset = _fileStream->readUint32LE();
-	firstEntry.size = _fileStream->readUint32LE();
+	firstEntry.id = READ_BE_UINT32(entryData);
+	firstEntry.flags = READ_LE_UINT32(entryData + 4);
+	firstEntry.offset = READ_LE_UINT32(entryData + 8);
+	firstEntry.size = READ_LE_UINT32(entryData + 12);
 
 	// Check if the offset is already absolute
 	// If it's absolute, the offset will equal the start of the movie list
@@ -888,22 +932,40 @@ void AVIDecoder::readOldIndex(uint32 size) {
 		firstEntry.offset += _movieListStart - 4;
 
 	debug(7, "Index 0: Tag '%s', Offset = %d, Size = %d (Flags = %d)", tag2str(firstEntry.id), firstEntry.offset, firstEntry.size, firstEntry.flags);
-	_indexEntries.push_back(firstEntry);
+	index->entries.push_back(firstEntry);
 
 	for (uint32 i = 1; i < entryCount; i++) {
+		entryData += 16;
+
 		OldIndex indexEntry;
-		indexEntry.id = _fileStream->readUint32BE();
-		indexEntry.flags = _fileStream->readUint32LE();
-		indexEntry.offset = _fileStream->readUint32LE();
-		indexEntry.size = _fileStream->readUint32LE();
+		indexEntry.id = READ_BE_UINT32(entryData);
+		indexEntry.flags = READ_LE_UINT32(entryData + 4);
+		indexEntry.offset = READ_LE_UINT32(entryData + 8);
+		indexEntry.size = READ_LE_UINT32(entryData + 12);
 
 		// Adjust to absolute, if necessary
 		if (!isAbsolute)
 			indexEntry.offset += _movieListStart - 4;
 
-		_indexEntries.push_back(indexEntry);
+		index->entries.push_back(indexEntry);
 		debug(7, "Index %d: Tag '%s', Offset = %d, Size = %d (Flags = %d)", i, tag2str(indexEntry.id), indexEntry.offset, indexEntry.size, indexEntry.flags);
 	}
+
+	delete[] indexData;
+
+	index->buildFrameLookup();
+
+	IndexPtr indexPtr(index);
+	_indexEntries.set(indexPtr);
+
+	if (!_loadingPath.empty()) {
+		if (!_indexCache) {
+			_indexCache = new IndexCache<IndexData>(kMaxCachedIndices);
+			// The movies of the next game may have the same names
+			Engine::addCleanupHook(clearIndexCache);
+		}
+		_indexCache->put(_loadingPath, _fileStream->size(), indexPtr);
+	}
 }
 
 void AVIDecoder::checkTruemotion1() {
@@ -1197,16 +1259,27 @@ void AVIDecoder::AVIAudioTrack::createAudioStream() {
 AVIDecoder::TrackStatus::TrackStatus() : track(0), chunkSearchOffset(0) {
 }
 
-AVIDecoder::OldIndex *AVIDecoder::IndexEntries::find(uint index, uint frameNumber) {
-	for (uint idx = 0, frameCtr = 0; idx < size(); ++idx) {
-		if ((*this)[idx].id != ID_REC &&
-				AVIDecoder::getStreamIndex((*this)[idx].id) == index) {
-			if (frameCtr++ == frameNumber)
-				return &(*this)[idx];
-		}
-	}
+const AVIDecoder::OldIndex *AVIDecoder::IndexEntries::find(uint index, uint frameNumber) const {
+	if (!_data || index >= _data->streamFrames.size() || frameNumber >= _data->streamFrames[index].size())
+		return nullptr;
 
-	return nullptr;
+	return &_data->entries[_data->streamFrames[index][frameNumber]];
+}
+
+void AVIDecoder::IndexData::buildFrameLookup() {
+	streamFrames.clear();
+
+	for (uint idx = 0; idx < entries.size(); ++idx) {
+		if (entries[idx].id == ID_REC)
+			continue;
+
+		uint index = AVIDecoder::getStreamIndex(entries[idx].id);
+
+		if (index >= streamFrames.size())
+			streamFrames.resize(index + 1);
+
+		streamFrames[index].push_back(idx);
+	}
 }
 
 } // End of namespace Video
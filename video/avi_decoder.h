@@ -27,6 +27,7 @@
 #include "common/rect.h"
 #include "common/str.h"
 
+#include "video/index_cache.h"
 #include "video/video_decoder.h"
 #include "audio/mixer.h"
 
@@ -67,8 +68,16 @@ public:
 	AVIDecoder(const Common::Rational &frameRateOverride);
 	virtual ~AVIDecoder();
 
+	bool loadFile(const Common::Path &filename);
 	bool loadStream(Common::SeekableReadStream *stream);
 	void close();
+
+	/**
+	 * Forget the indices of the movies loaded so far. This is done when the
+	 * running engine is destroyed, as the movies of the next game may have
+	 * the same names.
+	 */
+	static void clearIndexCache();
 	uint16 getWidth() const { return _header.width; }
 	uint16 getHeight() const { return _header.height; }
 
@@ -313,11 +322,43 @@ protected:
 		uint32 chunkSearchOffset;
 	};
 
-	class IndexEntries : public Common::Array<OldIndex> {
+	/**
+	 * The index of a movie. It is not modified once read, so that all the
+	 * decoders which load the same file can share it.
+	 */
+	struct IndexData {
+		Common::Array<OldIndex> entries;
+
+		// For each stream, the position of its frames in the entries
+		Common::Array<Common::Array<uint> > streamFrames;
+
+		/**
+		 * Build the per-stream frame lookup used by find(). Needs to be
+		 * called after all the entries have been added.
+		 */
+		void buildFrameLookup();
+	};
+
+	typedef IndexCache<IndexData>::IndexPtr IndexPtr;
+
+	class IndexEntries {
 	public:
-		OldIndex *find(uint index, uint frameNumber);
+		uint size() const { return _data ? _data->entries.size() : 0; }
+		bool empty() const { return size() == 0; }
+		const OldIndex &operator[](uint idx) const { return _data->entries[idx]; }
+
+		const OldIndex *find(uint index, uint frameNumber) const;
+		void set(const IndexPtr &data) { _data = data; }
+		void clear() { _data.reset(); }
+
+	private:
+		IndexPtr _data;
 	};
 
+	// Indices of the last movies loaded with loadFile()
+	static IndexCache<IndexData> *_indexCache;
+	Common::Path _loadingPath;
+
 	AVIHeader _header;
 
 	void readOldIndex(uint32 size);
@@ -29,6 +29,7 @@
 #include "common/util.h"
 #include "common/textconsole.h"
 #include "common/math.h"
+#include "common/memtrack.h"
 #include "common/stream.h"
 #include "common/substream.h"
 #include "common/file.h"
@@ -70,6 +71,8 @@ BinkDecoder::~BinkDecoder() {
 }
 
 bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
+	MEMORY_TAG_SCOPE("video/bink");
+
 	close();
 
 	uint32 id = stream->readUint32BE();
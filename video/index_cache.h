@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VIDEO_INDEX_CACHE_H
+#define VIDEO_INDEX_CACHE_H
+
+#include "common/list.h"
+#include "common/path.h"
+#include "common/ptr.h"
+
+namespace Video {
+
+/**
+ * Keeps the indices parsed from the most recently loaded movie files, so
+ * that reopening one of them shares its index instead of reading and
+ * parsing it again.
+ *
+ * Indices are looked up by path and file size, and the least recently used
+ * one is evicted once more than the given number are kept.
+ */
+template<class T>
+class IndexCache {
+public:
+	typedef Common::SharedPtr<const T> IndexPtr;
+
+	explicit IndexCache(uint maxEntries) : _maxEntries(maxEntries) {}
+
+	/**
+	 * Get the index of the given file, or a null pointer if it isn't cached.
+	 */
+	IndexPtr get(const Common::Path &path, int64 fileSize) {
+		for (typename EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+			if (it->fileSize != fileSize || it->path != path)
+				continue;
+
+			// Move to the front of the list
+			Entry entry = *it;
+			_entries.erase(it);
+			_entries.push_front(entry);
+			return entry.index;
+		}
+
+		return IndexPtr();
+	}
+
+	/**
+	 * Add the index of the given file, evicting the least recently used
+	 * index if needed.
+	 */
+	void put(const Common::Path &path, int64 fileSize, const IndexPtr &index) {
+		Entry entry;
+		entry.path = path;
+		entry.fileSize = fileSize;
+		entry.index = index;
+		_entries.push_front(entry);
+
+		if (_entries.size() > _maxEntries)
+			_entries.pop_back();
+	}
+
+	uint size() const { return _entries.size(); }
+
+private:
+	struct Entry {
+		Common::Path path;
+		int64 fileSize;
+		IndexPtr index;
+	};
+
+	typedef Common::List<Entry> EntryList;
+
+	// Most recently used entries are at the front
+	EntryList _entries;
+	uint _maxEntries;
+};
+
+} // End of namespace Video
+
+#endif
@@ -297,6 +297,9 @@ QuickTimeDecoder::VideoTrackHandler::VideoTrackHandler(QuickTimeDecoder *decoder
 		checkEditListBounds();
 	}
 
+	// Needs to be in place before the first edit buffers any frames
+	buildChunkIndex();
+
 	_curEdit = 0;
 	_curFrame = -1;
 	_delayedFrameToBufferTo = -1;
@@ -356,7 +359,7 @@ QuickTimeDecoder::VideoTrackHandler::~VideoTrackHandler() {
 	}
 
 	delete[] _forcedDitherPalette;
-	delete[] _ditherTable;
+	Image::Codec::releaseQuickTimeDitherTable(_ditherTable);
 
 	if (_ditherFrame) {
 		_ditherFrame->free();
@@ -653,30 +656,48 @@ Common::Rational QuickTimeDecoder::VideoTrackHandler::getScaledHeight() const {
 	return Common::Rational(_parent->height) / _parent->scaleFactorY;
 }
 
-Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
-	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
+void QuickTimeDecoder::VideoTrackHandler::buildChunkIndex() {
+	_chunkIndex.resize(_parent->chunkCount);
+
+	uint32 totalSampleCount = 0;
 	uint32 sampleToChunkIndex = 0;
 
 	for (uint32 i = 0; i < _parent->chunkCount; i++) {
 		if (sampleToChunkIndex < _parent->sampleToChunkCount && i >= _parent->sampleToChunk[sampleToChunkIndex].first)
 			sampleToChunkIndex++;
 
-		totalSampleCount += _parent->sampleToChunk[sampleToChunkIndex - 1].count;
+		// Chunks before the first sampleToChunk entry don't hold any samples
+		if (sampleToChunkIndex > 0)
+			totalSampleCount += _parent->sampleToChunk[sampleToChunkIndex - 1].count;
 
-		if (totalSampleCount > _curFrame) {
-			actualChunk = i;
-			descId = _parent->sampleToChunk[sampleToChunkIndex - 1].id;
-			sampleInChunk = _parent->sampleToChunk[sampleToChunkIndex - 1].count - totalSampleCount + _curFrame;
-			break;
-		}
+		_chunkIndex[i].sampleEnd = totalSampleCount;
+		_chunkIndex[i].sampleToChunkIndex = sampleToChunkIndex;
 	}
+}
+
+Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
+	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
+	// That is the first chunk whose samples extend past the current frame.
+	uint32 low = 0;
+	uint32 high = _chunkIndex.size();
+
+	while (low < high) {
+		uint32 mid = low + (high - low) / 2;
 
-	if (actualChunk < 0)
+		if (_chunkIndex[mid].sampleEnd > (uint32)_curFrame)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	if (_curFrame < 0 || low == _chunkIndex.size())
 		error("Could not find data for frame %d", _curFrame);
 
+	uint32 actualChunk = low;
+	const Common::QuickTimeParser::SampleToChunkEntry &sampleToChunk = _parent->sampleToChunk[_chunkIndex[actualChunk].sampleToChunkIndex - 1];
+	descId = sampleToChunk.id;
+	int32 sampleInChunk = sampleToChunk.count - _chunkIndex[actualChunk].sampleEnd + _curFrame;
+
 	// Next seek to that frame
 	Common::SeekableReadStream *stream = _decoder->_fd;
 	stream->seek(_parent->chunkOffsets[actualChunk]);
@@ -714,9 +735,22 @@ uint32 QuickTimeDecoder::VideoTrackHandler::getCurFrameDuration() {
 }
 
 uint32 QuickTimeDecoder::VideoTrackHandler::findKeyFrame(uint32 frame) const {
-	for (int i = _parent->keyframeCount - 1; i >= 0; i--)
-		if (_parent->keyframes[i] <= frame)
-			return _parent->keyframes[i];
+	// The sync sample table is sorted, so look for the last key frame
+	// at or before the requested frame
+	uint32 low = 0;
+	uint32 high = _parent->keyframeCount;
+
+	while (low < high) {
+		uint32 mid = low + (high - low) / 2;
+
+		if (_parent->keyframes[mid] <= frame)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low > 0)
+		return _parent->keyframes[low - 1];
 
 	// If none found, we'll assume the requested frame is a key frame
 	return frame;
@@ -910,9 +944,11 @@ void QuickTimeDecoder::VideoTrackHandler::setDither(const byte *palette) {
 			desc->_videoCodec->setDither(Image::Codec::kDitherTypeQT, palette);
 		} else {
 			// Forced dither
+			delete[] _forcedDitherPalette;
 			_forcedDitherPalette = new byte[256 * 3];
 			memcpy(_forcedDitherPalette, palette, 256 * 3);
-			_ditherTable = Image::Codec::createQuickTimeDitherTable(_forcedDitherPalette, 256);
+			Image::Codec::releaseQuickTimeDitherTable(_ditherTable);
+			_ditherTable = Image::Codec::acquireQuickTimeDitherTable(_forcedDitherPalette, 256);
 			_dirtyPalette = true;
 		}
 	}
@@ -946,13 +982,31 @@ void ditherFrame(const Graphics::Surface &src, Graphics::Surface &dst, const byt
 	for (int y = 0; y < dst.h; y++) {
 		const PixelInt *srcPtr = (const PixelInt *)src.getBasePtr(0, y);
 		byte *dstPtr = (byte *)dst.getBasePtr(0, y);
-		uint16 colorTableOffset = colorTableOffsets[y & 3];
 
-		for (int x = 0; x < dst.w; x++) {
-			uint16 color = readDitherColor(*srcPtr++, src.format, palette);
-			*dstPtr++ = ditherTable[colorTableOffset + color];
-			colorTableOffset += 0x4000;
+		// The table offset cycles every four pixels, so resolve the four
+		// sub-tables for this row once and dither in blocks of four.
+		const byte *table0 = ditherTable + colorTableOffsets[y & 3];
+		const byte *table1 = ditherTable + (uint16)(colorTableOffsets[y & 3] + 0x4000);
+		const byte *table2 = ditherTable + (uint16)(colorTableOffsets[y & 3] + 0x8000);
+		const byte *table3 = ditherTable + (uint16)(colorTableOffsets[y & 3] + 0xC000);
+
+		int x = 0;
+
+		for (; x + 4 <= dst.w; x += 4) {
+			dstPtr[0] = table0[readDitherColor(srcPtr[0], src.format, palette)];
+			dstPtr[1] = table1[readDitherColor(srcPtr[1], src.format, palette)];
+			dstPtr[2] = table2[readDitherColor(srcPtr[2], src.format, palette)];
+			dstPtr[3] = table3[readDitherColor(srcPtr[3], src.format, palette)];
+			srcPtr += 4;
+			dstPtr += 4;
 		}
+
+		if (x < dst.w)
+			*dstPtr++ = table0[readDitherColor(*srcPtr++, src.format, palette)];
+		if (++x < dst.w)
+			*dstPtr++ = table1[readDitherColor(*srcPtr++, src.format, palette)];
+		if (++x < dst.w)
+			*dstPtr++ = table2[readDitherColor(*srcPtr++, src.format, palette)];
 	}
 }
 
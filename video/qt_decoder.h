@@ -165,10 +165,20 @@ private:
 
 		// Forced dithering of frames
 		byte *_forcedDitherPalette;
-		byte *_ditherTable;
+		const byte *_ditherTable;
 		Graphics::Surface *_ditherFrame;
 		const Graphics::Surface *forceDither(const Graphics::Surface &frame);
 
+		// Sample to chunk mapping, flattened once so that frames can be
+		// located with a binary search instead of walking every chunk
+		struct ChunkIndexEntry {
+			uint32 sampleEnd;          // Total samples up to and including this chunk
+			uint32 sampleToChunkIndex; // One past the sampleToChunk entry for this chunk
+		};
+
+		Common::Array<ChunkIndexEntry> _chunkIndex;
+		void buildChunkIndex();
+
 		Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
 		uint32 getCurFrameDuration();            // media time
 		uint32 findKeyFrame(uint32 frame) const;
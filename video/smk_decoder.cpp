@@ -159,14 +159,22 @@ private:
 		SMK_NODE = 0x80000000
 	};
 
+	// The frame trees are decoded for every block, so resolve more bits
+	// per lookup than the small trees do. Only codes longer than this
+	// need to walk the tree bit by bit.
+	enum {
+		kLookupBits = 12,
+		kLookupSize = 1 << kLookupBits
+	};
+
 	uint32 decodeTree(uint32 prefix, int length);
 
 	uint32  _treeSize;
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 _prefixtree[kLookupSize];
+	byte _prefixlength[kLookupSize];
 
 	/* Used during construction */
 	SmackerBitStream &_bs;
@@ -185,7 +193,7 @@ BigHuffmanTree::BigHuffmanTree(SmackerBitStream &bs, int allocSize)
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
+	for (uint32 i = 0; i < kLookupSize; ++i)
 		_prefixtree[i] = _prefixlength[i] = 0;
 
 	_loBytes = new SmallHuffmanTree(_bs);
@@ -232,8 +240,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= kLookupBits) {
+			for (int i = 0; i < kLookupSize; i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -252,9 +260,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == kLookupBits) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = kLookupBits;
 	}
 
 	uint32 r1 = decodeTree(prefix, length + 1);
@@ -269,7 +277,7 @@ uint32 BigHuffmanTree::getCode(SmackerBitStream &bs) {
 	// Peeking data out of bounds is well-defined and returns 0 bits.
 	// This is for convenience when using speed-up techniques reading
 	// more bits than actually available.
-	byte peek = bs.peekBits<8>();
+	uint32 peek = bs.peekBits<kLookupBits>();
 	uint32 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -757,17 +765,14 @@ void SmackerDecoder::SmackerVideoTrack::decodeFrame(SmackerBitStream &bs) {
 			}
 			break;
 		case SMK_BLOCK_SKIP:
-			while (run-- && block < blocks)
-				block++;
+			block = MIN(block + run, blocks);
 			break;
 		case SMK_BLOCK_FILL:
-			uint32 col;
 			mode = type >> 8;
 			while (run-- && block < blocks) {
 				out = (byte *)_surface->getPixels() + (block / bw) * (stride * 4 * doubleY) + (block % bw) * 4;
-				col = mode * 0x01010101;
 				for (i = 0; i < 4 * doubleY; ++i) {
-					out[0] = out[1] = out[2] = out[3] = col;
+					memset(out, mode, 4);
 					out += stride;
 				}
 				_dirtyBlocks.set(block);
@@ -26,6 +26,8 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/memtrack.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #include "graphics/palette.h"
@@ -82,6 +84,8 @@ void VideoDecoder::close() {
 }
 
 bool VideoDecoder::loadFile(const Common::Path &filename) {
+	MEMORY_TAG_SCOPE("video");
+
 	Common::File *file = new Common::File();
 
 	if (!file->open(filename)) {
@@ -206,6 +210,9 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 }
 
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
+	MEMORY_TAG_SCOPE("video");
+	PROFILE_ZONE_ARG("VideoDecoder::decodeNextFrame", "frame", getCurFrame() + 1);
+
 	_needsUpdate = false;
 	_canSetDither = false;
 